@@ -28,7 +28,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	id        = id / sk_view_count;
 	
 	// Extract scale from the matrix
-	float4x4 world_mat = sk_inst[id].world;
+	float4x4 world_mat = sk_inst(id).world;
 	float2   scale     = float2(
 		length(float3(world_mat._11,world_mat._12,world_mat._13)),
 		length(float3(world_mat._21,world_mat._22,world_mat._23))
@@ -46,7 +46,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.pos    = mul(o.world, sk_viewproj[o.view_id]);
 	o.normal = normalize(mul(input.norm, (float3x3)world_mat));
 
-	o.inst_col       = sk_inst[id].color;
+	o.inst_col       = sk_inst(id).color;
 	o.light_edge.rgb = sk_lighting(o.normal);
 	o.light_edge.a   = input.color.a;
 	o.alpha          = input.color.b > 0.5 ? 1 : (o.inst_col.a-1) * 0.5;
@@ -28,13 +28,13 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float3 world  = mul(float4(input.pos.xyz, 1), sk_inst[id].world).xyz;
-	float3 normal = mul(input.norm, (float3x3)sk_inst[id].world);
+	float3 world  = mul(float4(input.pos.xyz, 1), sk_inst(id).world).xyz;
+	float3 normal = mul(input.norm, (float3x3)sk_inst(id).world);
 	world += normal * inflate;
 	o.pos = mul(float4(world, 1), sk_viewproj[o.view_id]);
 
 	o.uv    = input.uv;
-	o.color = input.col * color * sk_inst[id].color; 
+	o.color = input.col * color * sk_inst(id).color; 
 	return o;
 }
 float4 ps(psIn input) : SV_TARGET {
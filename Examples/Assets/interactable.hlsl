@@ -30,7 +30,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float4x4 world_mat = sk_inst[id].world;
+	float4x4 world_mat = sk_inst(id).world;
 	float3   scale     = float3(
 		length(float3(world_mat._11,world_mat._12,world_mat._13)),
 		length(float3(world_mat._21,world_mat._22,world_mat._23)),
@@ -39,7 +39,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.model_pos = input.pos.xyz * scale;
 	o.world_pos = mul(float4(input.pos.xyz, 1), world_mat).xyz;
 	o.pos       = mul(float4(o.world_pos,   1), sk_viewproj[o.view_id]);
-	o.color     = input.col * color * sk_inst[id].color;
+	o.color     = input.col * color * sk_inst(id).color;
 	o.normal    = input.norm;
 	return o;
 }
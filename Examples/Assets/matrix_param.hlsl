@@ -36,7 +36,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.pos        = mul(float4(world,         1), sk_viewproj[o.view_id]);
 
 	o.uv    = input.uv;
-	o.color = input.col * color * sk_inst[id].color;
+	o.color = input.col * color * sk_inst(id).color;
 	return o;
 }
 float4 ps(psIn input) : SV_TARGET {
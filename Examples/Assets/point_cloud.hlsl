@@ -25,7 +25,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float4 world = mul(input.pos, sk_inst[id].world);
+	float4 world = mul(input.pos, sk_inst(id).world);
 	float4 view  = mul(world, sk_view[o.view_id]);
 	if (screen_size <= 0.1)
 		view.xy = point_size * input.off + view.xy;
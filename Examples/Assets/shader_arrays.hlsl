@@ -28,11 +28,11 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float4 world = mul(input.pos, sk_inst[id].world);
+	float4 world = mul(input.pos, sk_inst(id).world);
 	o.pos        = mul(world,     sk_viewproj[o.view_id]);
 
 	o.uv    = input.uv + offsets[((uint)(sk_time*4))%10].xy;
-	o.color = input.col * color * sk_inst[id].color;
+	o.color = input.col * color * sk_inst(id).color;
 	return o;
 }
 
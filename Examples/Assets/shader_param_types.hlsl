@@ -39,11 +39,11 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float4 world = mul(input.pos, sk_inst[id].world);
+	float4 world = mul(input.pos, sk_inst(id).world);
 	o.pos        = mul(world,     sk_viewproj[o.view_id]);
 
 	o.uv    = input.uv;
-	o.color = input.col * color * sk_inst[id].color;
+	o.color = input.col * color * sk_inst(id).color;
 
 	// Just some code to prevent vars from being optimized out.
 	float4 id_set3 = id_set + id_set2;
@@ -0,0 +1,482 @@
+#include "bench_scenarios.h"
+
+#include <stereokit.h>
+#include <stereokit_ui.h>
+using namespace sk;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+///////////////////////////////////////////
+// Shared helpers                        //
+///////////////////////////////////////////
+
+// Every scenario reseeds this in init, so the generated content is identical
+// from run to run, and from commit to commit.
+static uint32_t bench_rand_state = 1;
+
+static void bench_seed(uint32_t seed) { bench_rand_state = seed; }
+static float bench_randf() {
+	bench_rand_state = bench_rand_state * 1664525u + 1013904223u;
+	return (bench_rand_state >> 8) * (1.0f / 16777216.0f);
+}
+static float bench_rand_range(float min, float max) { return min + (max - min) * bench_randf(); }
+
+static const char *bench_lorem[] = {
+	"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.",
+	"Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur.",
+	"Excepteur sint occaecat cupidatat non proident, sunt in culpa qui officia deserunt mollit anim id est laborum.",
+	"Sed ut perspiciatis unde omnis iste natus error sit voluptatem accusantium doloremque laudantium, totam rem aperiam, eaque ipsa quae ab illo inventore veritatis et quasi architecto beatae vitae dicta sunt explicabo.",
+};
+
+///////////////////////////////////////////
+// Render queue                          //
+///////////////////////////////////////////
+
+// Lots of model draws spread over a handful of meshes and materials, so the
+// render list sort has real work to do.
+
+static const int32_t draw_count      = 10000;
+static const int32_t draw_mesh_count = 4;
+static const int32_t draw_mat_count  = 8;
+
+static model_t draw_models[draw_mesh_count * draw_mat_count];
+static matrix *draw_transforms;
+static int32_t*draw_model_ids;
+
+void bench_draw_init() {
+	bench_seed(1);
+	bench_param("draws",     draw_count);
+	bench_param("models",    draw_mesh_count * draw_mat_count);
+
+	mesh_t meshes[draw_mesh_count] = {
+		mesh_gen_cube        (vec3_one),
+		mesh_gen_sphere      (1, 2),
+		mesh_gen_cylinder    (1, 1, vec3_up),
+		mesh_gen_rounded_cube(vec3_one, 0.2f, 2),
+	};
+	material_t default_mat = material_find(default_id_material);
+	for (int32_t m = 0; m < draw_mat_count; m++) {
+		material_t mat = material_copy(default_mat);
+		material_set_color(mat, "color", color_hsv((float)m / draw_mat_count, 0.5f, 0.8f, 1));
+		for (int32_t s = 0; s < draw_mesh_count; s++) {
+			draw_models[m * draw_mesh_count + s] = model_create_mesh(meshes[s], mat);
+		}
+		material_release(mat);
+	}
+	material_release(default_mat);
+	for (int32_t s = 0; s < draw_mesh_count; s++) mesh_release(meshes[s]);
+
+	draw_transforms = (matrix *)malloc(sizeof(matrix) * draw_count);
+	draw_model_ids  = (int32_t*)malloc(sizeof(int32_t) * draw_count);
+	for (int32_t i = 0; i < draw_count; i++) {
+		vec3 pos   = { bench_rand_range(-10, 10), bench_rand_range(-5, 5), bench_rand_range(-30, -2) };
+		quat rot   = quat_from_angles(bench_rand_range(0, 360), bench_rand_range(0, 360), 0);
+		vec3 scale = vec3_one * bench_rand_range(0.05f, 0.3f);
+		draw_transforms[i] = matrix_trs(pos, rot, scale);
+		draw_model_ids [i] = (int32_t)(bench_randf() * (draw_mesh_count * draw_mat_count)) % (draw_mesh_count * draw_mat_count);
+	}
+}
+
+void bench_draw_update(int32_t) {
+	for (int32_t i = 0; i < draw_count; i++) {
+		render_add_model(draw_models[draw_model_ids[i]], draw_transforms[i]);
+	}
+}
+
+void bench_draw_shutdown() {
+	for (int32_t i = 0; i < draw_mesh_count * draw_mat_count; i++) model_release(draw_models[i]);
+	free(draw_transforms); draw_transforms = nullptr;
+	free(draw_model_ids ); draw_model_ids  = nullptr;
+}
+
+///////////////////////////////////////////
+// Text                                  //
+///////////////////////////////////////////
+
+// Wrapped paragraphs, most of which are the same every frame, with a few
+// that change each frame and can't be served from a cached layout.
+
+static const int32_t text_static_count  = 200;
+static const int32_t text_dynamic_count = 50;
+
+static matrix text_transforms[text_static_count + text_dynamic_count];
+
+void bench_text_init() {
+	bench_seed(2);
+	bench_param("static_blocks",  text_static_count);
+	bench_param("dynamic_blocks", text_dynamic_count);
+
+	for (int32_t i = 0; i < text_static_count + text_dynamic_count; i++) {
+		vec3 pos = { bench_rand_range(-2, 2), bench_rand_range(-1.5f, 1.5f), bench_rand_range(-4, -1) };
+		text_transforms[i] = matrix_trs(pos, quat_lookat(vec3_zero, vec3_forward));
+	}
+}
+
+void bench_text_update(int32_t frame) {
+	const int32_t lorem_count = sizeof(bench_lorem) / sizeof(bench_lorem[0]);
+	for (int32_t i = 0; i < text_static_count; i++) {
+		text_add_in(bench_lorem[i % lorem_count], text_transforms[i], vec2{ 0.3f, 0.2f }, text_fit_wrap);
+	}
+
+	char buffer[512];
+	for (int32_t i = 0; i < text_dynamic_count; i++) {
+		snprintf(buffer, sizeof(buffer), "Frame %d, block %d. %s", frame, i, bench_lorem[i % lorem_count]);
+		text_add_in(buffer, text_transforms[text_static_count + i], vec2{ 0.3f, 0.2f }, text_fit_wrap);
+	}
+}
+
+void bench_text_shutdown() {
+}
+
+///////////////////////////////////////////
+// UI                                    //
+///////////////////////////////////////////
+
+// Several tall windows packed with the common elements. No hands are
+// present in offscreen mode, so this measures layout and drawing, not
+// interaction.
+
+static const int32_t ui_window_count = 8;
+static const int32_t ui_row_count    = 40;
+
+static pose_t   ui_poses  [ui_window_count];
+static float    ui_sliders[ui_window_count * ui_row_count];
+static bool32_t ui_toggles[ui_window_count * ui_row_count];
+
+void bench_ui_init() {
+	bench_seed(3);
+	bench_param("windows",        ui_window_count);
+	bench_param("rows_per_window", ui_row_count);
+
+	for (int32_t i = 0; i < ui_window_count; i++) {
+		vec3 pos = { (i - ui_window_count / 2) * 0.45f, 0, -1.5f };
+		ui_poses[i] = pose_t{ pos, quat_lookat(vec3_zero, vec3_forward) };
+	}
+	for (int32_t i = 0; i < ui_window_count * ui_row_count; i++) {
+		ui_sliders[i] = bench_randf();
+		ui_toggles[i] = bench_randf() > 0.5f;
+	}
+}
+
+void bench_ui_update(int32_t) {
+	char name[64];
+	for (int32_t w = 0; w < ui_window_count; w++) {
+		snprintf(name, sizeof(name), "Bench Window %d", w);
+		ui_window_begin(name, ui_poses[w], vec2{ 0.4f, 0 });
+		for (int32_t r = 0; r < ui_row_count; r++) {
+			int32_t id = w * ui_row_count + r;
+			ui_push_idi(id);
+			ui_label("Row"); ui_sameline();
+			ui_button("Button"); ui_sameline();
+			ui_toggle("Toggle", ui_toggles[id]); ui_sameline();
+			ui_hslider("Slider", ui_sliders[id], 0, 1);
+			ui_pop_id();
+		}
+		ui_window_end();
+	}
+}
+
+void bench_ui_shutdown() {
+}
+
+///////////////////////////////////////////
+// BVH                                   //
+///////////////////////////////////////////
+
+// A ~1M triangle height field. Each frame re-sets the mesh data so the BVH
+// is rebuilt from scratch, then fires a fixed set of rays at it one by one
+// and as a batch.
+
+static const int32_t bvh_grid      = 708; // 708*708*2 ~= 1M triangles
+static const int32_t bvh_ray_count = 4096;
+
+static mesh_t   bvh_mesh;
+static vert_t  *bvh_verts;
+static vind_t  *bvh_inds;
+static int32_t  bvh_vert_count;
+static int32_t  bvh_ind_count;
+static ray_t   *bvh_rays;
+static ray_t   *bvh_hits;
+
+void bench_bvh_init() {
+	bench_seed(4);
+	bench_param("triangles", bvh_grid * bvh_grid * 2);
+	bench_param("rays",      bvh_ray_count);
+
+	bvh_vert_count = (bvh_grid + 1) * (bvh_grid + 1);
+	bvh_ind_count  = bvh_grid * bvh_grid * 6;
+	bvh_verts      = (vert_t*)malloc(sizeof(vert_t) * bvh_vert_count);
+	bvh_inds       = (vind_t*)malloc(sizeof(vind_t) * bvh_ind_count);
+
+	for (int32_t y = 0; y <= bvh_grid; y++) {
+		for (int32_t x = 0; x <= bvh_grid; x++) {
+			float u = (float)x / bvh_grid;
+			float v = (float)y / bvh_grid;
+			float h = 0.05f * sinf(u * 40) * cosf(v * 37) + 0.01f * bench_randf();
+			bvh_verts[x + y * (bvh_grid + 1)] = vert_t{ {u * 2 - 1, h, v * 2 - 1}, vec3_up, {u, v}, {255,255,255,255} };
+		}
+	}
+	int32_t ind = 0;
+	for (int32_t y = 0; y < bvh_grid; y++) {
+		for (int32_t x = 0; x < bvh_grid; x++) {
+			vind_t a = x     + y     * (bvh_grid + 1);
+			vind_t b = x + 1 + y     * (bvh_grid + 1);
+			vind_t c = x     + (y+1) * (bvh_grid + 1);
+			vind_t d = x + 1 + (y+1) * (bvh_grid + 1);
+			bvh_inds[ind++] = a; bvh_inds[ind++] = c; bvh_inds[ind++] = b;
+			bvh_inds[ind++] = b; bvh_inds[ind++] = c; bvh_inds[ind++] = d;
+		}
+	}
+
+	bvh_rays = (ray_t*)malloc(sizeof(ray_t) * bvh_ray_count);
+	bvh_hits = (ray_t*)malloc(sizeof(ray_t) * bvh_ray_count);
+	for (int32_t i = 0; i < bvh_ray_count; i++) {
+		vec3 pos = { bench_rand_range(-1, 1), 1, bench_rand_range(-1, 1) };
+		vec3 dir = vec3_normalize(vec3{ bench_rand_range(-0.3f, 0.3f), -1, bench_rand_range(-0.3f, 0.3f) });
+		bvh_rays[i] = ray_t{ pos, dir };
+	}
+
+	bvh_mesh = mesh_create();
+}
+
+void bench_bvh_update(int32_t) {
+	mesh_set_data(bvh_mesh, bvh_verts, bvh_vert_count, bvh_inds, bvh_ind_count);
+
+	// The first intersection after new data is what builds the BVH.
+	ray_t  hit;
+	double start = bench_time_ms();
+	mesh_ray_intersect_bvh(bvh_mesh, bvh_rays[0], &hit);
+	bench_record("bvh_build", bench_time_ms() - start);
+
+	start = bench_time_ms();
+	for (int32_t i = 0; i < bvh_ray_count; i++) {
+		mesh_ray_intersect_bvh(bvh_mesh, bvh_rays[i], &bvh_hits[i]);
+	}
+	bench_record("bvh_query", bench_time_ms() - start);
+
+	start = bench_time_ms();
+	mesh_ray_intersect_bvh_batch(bvh_mesh, bvh_rays, bvh_ray_count, bvh_hits);
+	bench_record("bvh_query_batch", bench_time_ms() - start);
+}
+
+void bench_bvh_shutdown() {
+	mesh_release(bvh_mesh); bvh_mesh = nullptr;
+	free(bvh_verts); bvh_verts = nullptr;
+	free(bvh_inds ); bvh_inds  = nullptr;
+	free(bvh_rays ); bvh_rays  = nullptr;
+	free(bvh_hits ); bvh_hits  = nullptr;
+}
+
+///////////////////////////////////////////
+// Skinning                              //
+///////////////////////////////////////////
+
+// A crowd of skinned tubes, each bending with its own phase. The crowd is
+// built from real animated models, so skinning goes through the same
+// animation path (and the same job split) that glTF characters use. There's
+// no API for authoring animations directly, so the tube is written out as a
+// small .glb in memory and loaded like any other model.
+
+static const int32_t skin_crowd_count = 200;
+static const int32_t skin_bone_count  = 8;
+static const int32_t skin_rings       = 32;
+static const int32_t skin_segments    = 32;
+static const int32_t skin_keyframes   = 33;
+static const float   skin_duration    = 2.0f;
+static const float   skin_height      = 1.6f;
+
+static model_t skin_models    [skin_crowd_count];
+static matrix  skin_transforms[skin_crowd_count];
+static float   skin_phases    [skin_crowd_count];
+
+// Appends an accessor and a buffer view just for it to the glTF json lists,
+// and returns the accessor's index.
+static const size_t bench_glb_list_size = 4096;
+static int32_t bench_glb_accessor(char *views, char *accessors, int32_t *count, size_t offset, size_t length, int32_t component, int32_t elements, const char *type) {
+	size_t len = strlen(views);
+	snprintf(views + len, bench_glb_list_size - len,
+		"%s{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu}",
+		*count == 0 ? "" : ",", offset, length);
+	len = strlen(accessors);
+	snprintf(accessors + len, bench_glb_list_size - len,
+		"%s{\"bufferView\":%d,\"componentType\":%d,\"count\":%d,\"type\":\"%s\"}",
+		*count == 0 ? "" : ",", *count, component, elements, type);
+	*count = *count + 1;
+	return *count - 1;
+}
+
+static model_t bench_skin_build_model() {
+	const int32_t vert_count = skin_rings * skin_segments;
+	const int32_t ind_count  = (skin_rings - 1) * skin_segments * 6;
+	const float   bone_length = skin_height / skin_bone_count;
+
+	// Binary chunk layout, everything here is 4 byte aligned
+	size_t pos_offset    = 0;
+	size_t norm_offset   = pos_offset    + sizeof(float)    * 3 * vert_count;
+	size_t joint_offset  = norm_offset   + sizeof(float)    * 3 * vert_count;
+	size_t weight_offset = joint_offset  + sizeof(uint16_t) * 4 * vert_count;
+	size_t ind_offset    = weight_offset + sizeof(float)    * 4 * vert_count;
+	size_t bind_offset   = ind_offset    + sizeof(uint32_t) * ind_count;
+	size_t time_offset   = bind_offset   + sizeof(float)    * 16 * skin_bone_count;
+	size_t rot_offset    = time_offset   + sizeof(float)    * skin_keyframes;
+	size_t bin_size      = rot_offset    + sizeof(float)    * 4 * skin_keyframes;
+	uint8_t *bin = (uint8_t*)calloc(1, bin_size);
+
+	float    *positions = (float   *)(bin + pos_offset);
+	float    *normals   = (float   *)(bin + norm_offset);
+	uint16_t *joints    = (uint16_t*)(bin + joint_offset);
+	float    *weights   = (float   *)(bin + weight_offset);
+	uint32_t *inds      = (uint32_t*)(bin + ind_offset);
+	float    *binds     = (float   *)(bin + bind_offset);
+	float    *times     = (float   *)(bin + time_offset);
+	float    *rots      = (float   *)(bin + rot_offset);
+
+	for (int32_t r = 0; r < skin_rings; r++) {
+		float    y    = skin_height * r / (skin_rings - 1);
+		float    bone = fminf(y / bone_length, skin_bone_count - 1.0f);
+		uint16_t b0   = (uint16_t)bone;
+		uint16_t b1   = (uint16_t)fminf(b0 + 1.0f, skin_bone_count - 1.0f);
+		float    t    = bone - b0;
+		for (int32_t s = 0; s < skin_segments; s++) {
+			float   ang = 6.2831853f * s / skin_segments;
+			int32_t i   = r * skin_segments + s;
+			positions[i*3+0] = cosf(ang) * 0.15f; positions[i*3+1] = y; positions[i*3+2] = sinf(ang) * 0.15f;
+			normals  [i*3+0] = cosf(ang);         normals  [i*3+1] = 0; normals  [i*3+2] = sinf(ang);
+			joints [i*4+0] = b0;    joints [i*4+1] = b1; joints [i*4+2] = 0; joints [i*4+3] = 0;
+			weights[i*4+0] = 1 - t; weights[i*4+1] = t;  weights[i*4+2] = 0; weights[i*4+3] = 0;
+		}
+	}
+	int32_t ind = 0;
+	for (int32_t r = 0; r < skin_rings - 1; r++) {
+		for (int32_t s = 0; s < skin_segments; s++) {
+			uint32_t a = r       * skin_segments + s;
+			uint32_t b = r       * skin_segments + (s + 1) % skin_segments;
+			uint32_t c = (r + 1) * skin_segments + s;
+			uint32_t d = (r + 1) * skin_segments + (s + 1) % skin_segments;
+			inds[ind++] = a; inds[ind++] = c; inds[ind++] = b;
+			inds[ind++] = b; inds[ind++] = c; inds[ind++] = d;
+		}
+	}
+	// Column major inverse bind matrices, each bone rests at its height up
+	// the tube.
+	for (int32_t b = 0; b < skin_bone_count; b++) {
+		float *m = &binds[b * 16];
+		m[0] = m[5] = m[10] = m[15] = 1;
+		m[13] = -b * bone_length;
+	}
+	// One full bend cycle, every bone shares the same rotation curve.
+	for (int32_t k = 0; k < skin_keyframes; k++) {
+		float t    = skin_duration * k / (skin_keyframes - 1);
+		float bend = sinf(6.2831853f * t / skin_duration) * 15;
+		quat  q    = quat_from_angles(bend, 0, bend * 0.5f);
+		times[k]     = t;
+		rots [k*4+0] = q.x; rots[k*4+1] = q.y; rots[k*4+2] = q.z; rots[k*4+3] = q.w;
+	}
+
+	char    views    [bench_glb_list_size] = {};
+	char    accessors[bench_glb_list_size] = {};
+	int32_t view_count = 0;
+	int32_t acc_pos     = bench_glb_accessor(views, accessors, &view_count, pos_offset,    norm_offset   - pos_offset,    5126, vert_count,      "VEC3");
+	int32_t acc_norm    = bench_glb_accessor(views, accessors, &view_count, norm_offset,   joint_offset  - norm_offset,   5126, vert_count,      "VEC3");
+	int32_t acc_joint   = bench_glb_accessor(views, accessors, &view_count, joint_offset,  weight_offset - joint_offset,  5123, vert_count,      "VEC4");
+	int32_t acc_weight  = bench_glb_accessor(views, accessors, &view_count, weight_offset, ind_offset    - weight_offset, 5126, vert_count,      "VEC4");
+	int32_t acc_ind     = bench_glb_accessor(views, accessors, &view_count, ind_offset,    bind_offset   - ind_offset,    5125, ind_count,       "SCALAR");
+	int32_t acc_bind    = bench_glb_accessor(views, accessors, &view_count, bind_offset,   time_offset   - bind_offset,   5126, skin_bone_count, "MAT4");
+	int32_t acc_time    = bench_glb_accessor(views, accessors, &view_count, time_offset,   rot_offset    - time_offset,   5126, skin_keyframes,  "SCALAR");
+	int32_t acc_rot     = bench_glb_accessor(views, accessors, &view_count, rot_offset,    bin_size      - rot_offset,    5126, skin_keyframes,  "VEC4");
+
+	const size_t json_size = 16 * 1024;
+	char  *json = (char*)calloc(1, json_size);
+	size_t len = 0;
+	len += snprintf(json + len, json_size - len,
+		"{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0,1]}],"
+		"\"buffers\":[{\"byteLength\":%zu}],\"bufferViews\":[%s],\"accessors\":[%s],"
+		"\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":%d,\"NORMAL\":%d,\"JOINTS_0\":%d,\"WEIGHTS_0\":%d},\"indices\":%d}]}],",
+		bin_size, views, accessors, acc_pos, acc_norm, acc_joint, acc_weight, acc_ind);
+
+	// Node 0 is the skinned mesh, nodes 1+ are the bone chain.
+	len += snprintf(json + len, json_size - len, "\"skins\":[{\"inverseBindMatrices\":%d,\"joints\":[", acc_bind);
+	for (int32_t b = 0; b < skin_bone_count; b++)
+		len += snprintf(json + len, json_size - len, "%s%d", b == 0 ? "" : ",", b + 1);
+	len += snprintf(json + len, json_size - len, "]}],\"nodes\":[{\"mesh\":0,\"skin\":0}");
+	for (int32_t b = 0; b < skin_bone_count; b++) {
+		len += snprintf(json + len, json_size - len, ",{\"name\":\"bone%d\",\"translation\":[0,%f,0]", b, b == 0 ? 0.0f : bone_length);
+		if (b + 1 < skin_bone_count)
+			len += snprintf(json + len, json_size - len, ",\"children\":[%d]", b + 2);
+		len += snprintf(json + len, json_size - len, "}");
+	}
+
+	// The root bone stays put, each bone after it bends relative to its
+	// parent.
+	len += snprintf(json + len, json_size - len, "],\"animations\":[{\"name\":\"bend\",\"samplers\":[{\"input\":%d,\"output\":%d}],\"channels\":[", acc_time, acc_rot);
+	for (int32_t b = 1; b < skin_bone_count; b++)
+		len += snprintf(json + len, json_size - len, "%s{\"sampler\":0,\"target\":{\"node\":%d,\"path\":\"rotation\"}}", b == 1 ? "" : ",", b + 1);
+	len += snprintf(json + len, json_size - len, "]}]}");
+
+	// Wrap it all up in the binary glTF container
+	uint32_t json_chunk = (uint32_t)((len + 3) & ~3);
+	uint32_t bin_chunk  = (uint32_t)((bin_size + 3) & ~3);
+	uint32_t glb_size   = 12 + 8 + json_chunk + 8 + bin_chunk;
+	uint8_t *glb        = (uint8_t*)calloc(1, glb_size);
+	uint32_t header[5]  = { 0x46546C67, 2, glb_size, json_chunk, 0x4E4F534A };
+	memcpy(glb, header, sizeof(header));
+	memset(glb + 20, ' ', json_chunk);
+	memcpy(glb + 20, json, len);
+	uint32_t bin_header[2] = { bin_chunk, 0x004E4942 };
+	memcpy(glb + 20 + json_chunk,     bin_header, sizeof(bin_header));
+	memcpy(glb + 20 + json_chunk + 8, bin,        bin_size);
+
+	model_t result = model_create_mem("bench_skin.glb", glb, glb_size);
+	free(glb);
+	free(json);
+	free(bin);
+	return result;
+}
+
+void bench_skin_init() {
+	bench_seed(5);
+	bench_param("crowd",          skin_crowd_count);
+	bench_param("bones",          skin_bone_count);
+	bench_param("verts_per_mesh", skin_rings * skin_segments);
+
+	model_t source = bench_skin_build_model();
+	for (int32_t i = 0; i < skin_crowd_count; i++) {
+		skin_models[i] = model_copy(source);
+		model_play_anim(skin_models[i], "bend", anim_mode_manual);
+
+		vec3 pos = { (i % 20) * 0.5f - 5, -1.5f, (i / 20) * -0.5f - 2 };
+		skin_transforms[i] = matrix_t(pos);
+		skin_phases    [i] = bench_rand_range(0, skin_duration);
+	}
+	model_release(source);
+}
+
+void bench_skin_update(int32_t frame) {
+	// Animation time is driven only by the frame index, so every run skins
+	// the same poses.
+	for (int32_t i = 0; i < skin_crowd_count; i++) {
+		model_set_anim_time(skin_models[i], fmodf(frame * (1 / 60.0f) + skin_phases[i], skin_duration));
+		model_draw         (skin_models[i], skin_transforms[i]);
+	}
+}
+
+void bench_skin_shutdown() {
+	for (int32_t i = 0; i < skin_crowd_count; i++) {
+		model_release(skin_models[i]);
+		skin_models[i] = nullptr;
+	}
+}
+
+///////////////////////////////////////////
+
+bench_scenario_t bench_scenarios[] = {
+	{ "render_queue", bench_draw_init, bench_draw_update, bench_draw_shutdown, 0  },
+	{ "text",         bench_text_init, bench_text_update, bench_text_shutdown, 0  },
+	{ "ui",           bench_ui_init,   bench_ui_update,   bench_ui_shutdown,   0  },
+	{ "bvh",          bench_bvh_init,  bench_bvh_update,  bench_bvh_shutdown,  10 },
+	{ "skinning",     bench_skin_init, bench_skin_update, bench_skin_shutdown, 0  },
+};
+int32_t bench_scenario_count = sizeof(bench_scenarios) / sizeof(bench_scenarios[0]);
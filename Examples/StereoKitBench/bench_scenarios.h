@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+// A scripted benchmark scenario. init and shutdown run outside of the timed
+// frames, update is called once per frame from inside sk_step, and should
+// only ever depend on the frame index so that runs are repeatable.
+typedef struct bench_scenario_t {
+	const char *name;
+	void      (*init)    ();
+	void      (*update)  (int32_t frame);
+	void      (*shutdown)();
+	// Fixed frame count for scenarios that are too heavy to run for the
+	// default number of frames, 0 uses the command line value.
+	int32_t     frames;
+} bench_scenario_t;
+
+extern bench_scenario_t bench_scenarios[];
+extern int32_t          bench_scenario_count;
+
+// Implemented by the harness in main.cpp.
+double bench_time_ms();
+void   bench_record (const char *metric, double ms);
+void   bench_param  (const char *name,   double value);
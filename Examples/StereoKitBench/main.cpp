@@ -0,0 +1,231 @@
+#include <stereokit.h>
+using namespace sk;
+
+#include "bench_scenarios.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// StereoKitBench runs a fixed set of scripted scenarios headless, and writes
+// the timings out as JSON so runs can be compared across commits.
+//
+// Usage: StereoKitBench [--frames N] [--warmup N] [--only name] [--out file.json]
+//
+// For the most stable CPU-side numbers, build StereoKit with SK_GPU_NULL so
+// no GPU work is involved at all. With the null backend, each scenario also
+// reports the per-frame GPU work it would have submitted.
+
+struct bench_metric_t {
+	std::string         name;
+	std::vector<double> samples;
+};
+
+struct bench_result_t {
+	std::string                                      name;
+	std::vector<std::pair<std::string, double>>      params;
+	std::vector<bench_metric_t>                      metrics;
+	std::vector<std::pair<std::string, double>>      gpu_work; // Per frame, null backend only
+};
+
+static std::vector<bench_result_t> bench_results;
+static bench_scenario_t           *bench_active    = nullptr;
+static int32_t                     bench_frame     = 0;
+static bool                        bench_recording = false;
+
+///////////////////////////////////////////
+
+double bench_time_ms() {
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+///////////////////////////////////////////
+
+void bench_record(const char *metric, double ms) {
+	if (!bench_recording || bench_results.empty()) return;
+
+	std::vector<bench_metric_t> &metrics = bench_results.back().metrics;
+	for (size_t i = 0; i < metrics.size(); i++) {
+		if (metrics[i].name == metric) {
+			metrics[i].samples.push_back(ms);
+			return;
+		}
+	}
+	bench_metric_t item;
+	item.name = metric;
+	item.samples.push_back(ms);
+	metrics.push_back(item);
+}
+
+///////////////////////////////////////////
+
+void bench_param(const char *name, double value) {
+	if (bench_results.empty()) return;
+	bench_results.back().params.push_back(std::make_pair(std::string(name), value));
+}
+
+///////////////////////////////////////////
+
+void bench_step() {
+	double start = bench_time_ms();
+	bench_active->update(bench_frame);
+	bench_record("update", bench_time_ms() - start);
+}
+
+///////////////////////////////////////////
+
+void bench_write_stats(FILE *fp, const bench_metric_t &metric) {
+	std::vector<double> sorted = metric.samples;
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0;
+	for (size_t i = 0; i < sorted.size(); i++) total += sorted[i];
+	size_t count  = sorted.size();
+	double mean   = count > 0 ? total / count : 0;
+	double median = count > 0 ? sorted[count / 2] : 0;
+	double p95    = count > 0 ? sorted[std::min(count - 1, (size_t)(count * 0.95))] : 0;
+	double min    = count > 0 ? sorted.front() : 0;
+	double max    = count > 0 ? sorted.back () : 0;
+
+	fprintf(fp, "\"%s\": {\"samples\": %d, \"mean_ms\": %.4f, \"median_ms\": %.4f, \"p95_ms\": %.4f, \"min_ms\": %.4f, \"max_ms\": %.4f}",
+		metric.name.c_str(), (int32_t)count, mean, median, p95, min, max);
+}
+
+///////////////////////////////////////////
+
+// Averages what the null backend counted over the recorded frames.
+void bench_collect_gpu_work(bench_result_t *result) {
+	backend_null_stats_t stats = backend_null_get_stats();
+	if (stats.frames <= 0) return;
+
+	double frames = (double)stats.frames;
+	result->gpu_work.push_back(std::make_pair(std::string("draw_calls"),       stats.draw_calls       / frames));
+	result->gpu_work.push_back(std::make_pair(std::string("instances"),        stats.instances        / frames));
+	result->gpu_work.push_back(std::make_pair(std::string("indices"),          stats.indices          / frames));
+	result->gpu_work.push_back(std::make_pair(std::string("buffer_bytes"),     stats.buffer_bytes     / frames));
+	result->gpu_work.push_back(std::make_pair(std::string("texture_bytes"),    stats.texture_bytes    / frames));
+	result->gpu_work.push_back(std::make_pair(std::string("buffers_created"),  stats.buffers_created  / frames));
+	result->gpu_work.push_back(std::make_pair(std::string("textures_created"), stats.textures_created / frames));
+}
+
+///////////////////////////////////////////
+
+void bench_write_json(FILE *fp, int32_t frames, int32_t warmup) {
+	const char *backend = "unknown";
+	switch (backend_graphics_get()) {
+	case backend_graphics_none:         backend = "none";         break;
+	case backend_graphics_d3d11:        backend = "d3d11";        break;
+	case backend_graphics_opengl_glx:   backend = "opengl_glx";   break;
+	case backend_graphics_opengl_wgl:   backend = "opengl_wgl";   break;
+	case backend_graphics_opengles_egl: backend = "opengles_egl"; break;
+	case backend_graphics_webgl:        backend = "webgl";        break;
+	case backend_graphics_null:         backend = "null";         break;
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"version\": \"%s\",\n", sk_version_name());
+	fprintf(fp, "  \"backend\": \"%s\",\n", backend);
+	fprintf(fp, "  \"frames\": %d,\n",      frames);
+	fprintf(fp, "  \"warmup\": %d,\n",      warmup);
+	fprintf(fp, "  \"scenarios\": [\n");
+	for (size_t s = 0; s < bench_results.size(); s++) {
+		const bench_result_t &result = bench_results[s];
+		fprintf(fp, "    {\n      \"name\": \"%s\",\n      \"params\": {", result.name.c_str());
+		for (size_t p = 0; p < result.params.size(); p++) {
+			fprintf(fp, "%s\"%s\": %g", p == 0 ? "" : ", ", result.params[p].first.c_str(), result.params[p].second);
+		}
+		fprintf(fp, "},\n      \"metrics\": {\n");
+		for (size_t m = 0; m < result.metrics.size(); m++) {
+			fprintf(fp, "        ");
+			bench_write_stats(fp, result.metrics[m]);
+			fprintf(fp, m + 1 < result.metrics.size() ? ",\n" : "\n");
+		}
+		fprintf(fp, "      }");
+		if (!result.gpu_work.empty()) {
+			fprintf(fp, ",\n      \"gpu_work_per_frame\": {");
+			for (size_t g = 0; g < result.gpu_work.size(); g++) {
+				fprintf(fp, "%s\"%s\": %.2f", g == 0 ? "" : ", ", result.gpu_work[g].first.c_str(), result.gpu_work[g].second);
+			}
+			fprintf(fp, "}");
+		}
+		fprintf(fp, "\n    }%s\n", s + 1 < bench_results.size() ? "," : "");
+	}
+	fprintf(fp, "  ]\n}\n");
+}
+
+///////////////////////////////////////////
+
+int main(int argc, char **argv) {
+	int32_t     frames   = 120;
+	int32_t     warmup   = 10;
+	const char *only     = nullptr;
+	const char *out_file = nullptr;
+	for (int32_t i = 1; i < argc; i++) {
+		if      (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames   = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) warmup   = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--only"  ) == 0 && i + 1 < argc) only     = argv[++i];
+		else if (strcmp(argv[i], "--out"   ) == 0 && i + 1 < argc) out_file = argv[++i];
+		else {
+			fprintf(stderr, "Usage: %s [--frames N] [--warmup N] [--only name] [--out file.json]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	sk_settings_t settings = {};
+	settings.app_name                = "StereoKitBench";
+	settings.assets_folder           = "Assets";
+	settings.mode                    = app_mode_offscreen;
+	settings.log_filter              = log_warning;
+	settings.disable_unfocused_sleep = true;
+	settings.standby_mode            = standby_mode_none;
+	if (!sk_init(settings))
+		return 1;
+
+	for (int32_t s = 0; s < bench_scenario_count; s++) {
+		bench_scenario_t *scenario = &bench_scenarios[s];
+		if (only != nullptr && strcmp(only, scenario->name) != 0) continue;
+
+		bench_result_t result;
+		result.name = scenario->name;
+		bench_results.push_back(result);
+
+		bench_active = scenario;
+		scenario->init();
+
+		bool    null_gpu = backend_graphics_get() == backend_graphics_null;
+		int32_t count    = scenario->frames > 0 ? scenario->frames : frames;
+		for (int32_t f = 0; f < warmup + count; f++) {
+			bench_frame     = f;
+			bench_recording = f >= warmup;
+			if (null_gpu && f == warmup) backend_null_reset_stats();
+
+			double start = bench_time_ms();
+			if (!sk_step(bench_step)) break;
+			bench_record("frame", bench_time_ms() - start);
+		}
+		bench_recording = false;
+		if (null_gpu) bench_collect_gpu_work(&bench_results.back());
+
+		scenario->shutdown();
+		bench_active = nullptr;
+		// Let released assets get cleaned up before the next scenario.
+		sk_step(nullptr);
+	}
+
+	FILE *fp = out_file != nullptr ? fopen(out_file, "w") : stdout;
+	if (fp == nullptr) {
+		fprintf(stderr, "Couldn't open %s for writing!\n", out_file);
+		sk_shutdown();
+		return 1;
+	}
+	bench_write_json(fp, frames, warmup);
+	if (fp != stdout) fclose(fp);
+
+	sk_shutdown();
+	return 0;
+}
@@ -57,13 +57,13 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	output.view_id = id % sk_view_count;
 	id             = id / sk_view_count;
 
-	float4 world = mul(input.pos, sk_inst[id].world);
+	float4 world = mul(input.pos, sk_inst(id).world);
 	output.pos   = mul(world,     sk_viewproj[output.view_id]);
 
-	float3 normal = normalize(mul(input.norm, (float3x3)sk_inst[id].world));
+	float3 normal = normalize(mul(input.norm, (float3x3)sk_inst(id).world));
 
 	output.uv      = input.uv * tex_scale;
-	output.color   = color * input.col * sk_inst[id].color;
+	output.color   = color * input.col * sk_inst(id).color;
 	output.color.rgb = sample_lights(world.xyz, normal) + Lighting(normal);
 	return output;
 }
@@ -43,10 +43,10 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	output.view_id = id % sk_view_count;
 	id             = id / sk_view_count;
 
-	float4 world  = mul(input.pos, sk_inst[id].world);
+	float4 world  = mul(input.pos, sk_inst(id).world);
 	output.pos    = mul(world,     sk_viewproj[output.view_id]);
 	output.world  = world.xyz;
-	output.normal = normalize(mul(input.norm, (float3x3)sk_inst[id].world));
+	output.normal = normalize(mul(input.norm, (float3x3)sk_inst(id).world));
 	return output;
 }
 float4 ps(psIn input) : SV_TARGET{
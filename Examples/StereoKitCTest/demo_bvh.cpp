@@ -1,6 +1,8 @@
 #include "demo_bvh.h"
 
 #include <cstdio>   // For sprintf()
+#include <cstdlib>  // For malloc()
+#include <cmath>    // For sqrtf()
 #include <stereokit.h>
 #include <stereokit_ui.h>
 using namespace sk;
@@ -25,6 +27,12 @@ mesh_t  isec_sphere;
 
 float intersect_time = 0;
 bool32_t use_bvh = true;
+
+// Throughput benchmark, single queries vs. the batched API
+const int32_t bench_ray_count = 4096;
+float bench_single_rays_per_ms = 0;
+float bench_batch_rays_per_ms  = 0;
+int32_t bench_hits = 0;
 bool have_intersection;
 cull_ cull_mode;
 
@@ -60,6 +68,45 @@ void demo_bvh_load_model(const char* filename) {
 
 ///////////////////////////////////////////
 
+void demo_bvh_benchmark() {
+    // A grid of parallel rays shot through the model's bounds, plus some
+    // jitter so neighbouring rays don't all walk the exact same BVH path.
+    bounds_t b    = model_get_bounds(model_to_intersect);
+    ray_t   *rays = (ray_t*)malloc(sizeof(ray_t) * bench_ray_count);
+    ray_t   *hits = (ray_t*)malloc(sizeof(ray_t) * bench_ray_count);
+    int32_t  side = (int32_t)sqrtf((float)bench_ray_count);
+    for (int32_t i = 0; i < bench_ray_count; i++) {
+        float u = ((i % side) + 0.5f) / side - 0.5f;
+        float v = ((i / side) + 0.5f) / side - 0.5f;
+        vec3  start = b.center + vec3{ u * b.dimensions.x, v * b.dimensions.y, b.dimensions.z };
+        vec3  dir   = vec3{ (i % 7) * 0.01f, (i % 5) * 0.01f, -1 };
+        rays[i] = { start, dir };
+    }
+
+    // Warm up, so the BVHs are built before any timing
+    model_ray_intersect_bvh_batch(model_to_intersect, rays, 1, hits);
+
+    double t0 = time_total_raw();
+    int32_t single_hits = 0;
+    for (int32_t i = 0; i < bench_ray_count; i++) {
+        if (model_ray_intersect_bvh(model_to_intersect, rays[i], &hits[i], cull_mode))
+            single_hits += 1;
+    }
+    double t1 = time_total_raw();
+    bench_hits = model_ray_intersect_bvh_batch(model_to_intersect, rays, bench_ray_count, hits, nullptr, cull_mode);
+    double t2 = time_total_raw();
+
+    bench_single_rays_per_ms = (float)(bench_ray_count / ((t1 - t0) * 1000));
+    bench_batch_rays_per_ms  = (float)(bench_ray_count / ((t2 - t1) * 1000));
+    log_infof("Ray benchmark: %d rays, %d/%d hits, single %.0f rays/ms, batch %.0f rays/ms",
+        bench_ray_count, single_hits, bench_hits, bench_single_rays_per_ms, bench_batch_rays_per_ms);
+
+    free(rays);
+    free(hits);
+}
+
+///////////////////////////////////////////
+
 void demo_bvh_init() {
 
     mesh_from = mesh_gen_sphere(0.04f, 16);
@@ -117,6 +164,14 @@ void demo_bvh_update() {
     if (ui_button("Reset pose"))
         model_pose = pose_t{vec3{}, quat_identity};
 
+    if (ui_button("Benchmark"))
+        demo_bvh_benchmark();
+    if (bench_batch_rays_per_ms > 0) {
+        char s[96];
+        snprintf(s, sizeof(s), "%d rays, %d hits\nsingle %.0f rays/ms\nbatch %.0f rays/ms", bench_ray_count, bench_hits, bench_single_rays_per_ms, bench_batch_rays_per_ms);
+        ui_text(s);
+    }
+
     ui_window_end();
 
     // XXX add toggle model scale?
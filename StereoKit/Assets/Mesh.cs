@@ -51,6 +51,27 @@ namespace StereoKit
 			set => NativeAPI.mesh_set_keep_data(_inst, value);
 		}
 
+		/// <summary>Collision data for ray intersection reuses the Mesh's own
+		/// vertex and index data, and by default computes each triangle's
+		/// plane during the query. Setting this to true stores a quantized
+		/// plane per triangle instead (8 bytes each), trading a little
+		/// memory for faster intersection on large meshes. Defaults to
+		/// false.</summary>
+		public bool CollisionPlanes {
+			get => NativeAPI.mesh_get_collision_planes(_inst);
+			set => NativeAPI.mesh_set_collision_planes(_inst, value);
+		}
+
+		/// <summary>Should the BVH used for ray intersection be built on an
+		/// asset thread instead of blocking the first query that needs it?
+		/// While the build is in flight, queries fall back to testing every
+		/// triangle. Setting this to true on a Mesh that already has data
+		/// starts the build right away. Defaults to false.</summary>
+		public bool BvhAsync {
+			get => NativeAPI.mesh_get_bvh_async(_inst);
+			set => NativeAPI.mesh_set_bvh_async(_inst, value);
+		}
+
 		/// <summary>The number of vertices stored in this Mesh! This is
 		/// available to you regardless of whether or not KeepData is set.
 		/// </summary>
@@ -255,6 +276,33 @@ namespace StereoKit
 			modelSpaceAt = intersection.position;
 			return result;
 		}
+
+		/// <summary>Intersects a whole batch of rays with this Mesh at once,
+		/// using the Mesh's BVH and spreading the rays across StereoKit's
+		/// worker threads. This is much faster than calling Intersect in a
+		/// loop when you have hundreds of rays, like for gaze heatmaps or
+		/// fanned out hand rays. Rays and results are in model space.
+		/// </summary>
+		/// <param name="modelSpaceRays">The rays to test, in model space.
+		/// </param>
+		/// <param name="modelSpaceHits">Receives the intersection point and
+		/// surface direction for each ray, this must be at least as long as
+		/// modelSpaceRays. Rays that don't hit anything get a zeroed out Ray.
+		/// </param>
+		/// <param name="hitResults">Optional, receives true for each ray that
+		/// hit the Mesh. If provided, this must be at least as long as
+		/// modelSpaceRays.</param>
+		/// <param name="cullFaces">How should intersection work with respect
+		/// to the direction the triangles are facing?</param>
+		/// <returns>The number of rays that hit the Mesh.</returns>
+		/// <exception cref="ArgumentException">modelSpaceHits or hitResults
+		/// are shorter than modelSpaceRays.</exception>
+		public int Intersect(Ray[] modelSpaceRays, Ray[] modelSpaceHits, bool[] hitResults = null, Cull cullFaces = Cull.Back)
+		{
+			if (modelSpaceHits.Length < modelSpaceRays.Length)                  throw new ArgumentException("modelSpaceHits.Length < modelSpaceRays.Length");
+			if (hitResults != null && hitResults.Length < modelSpaceRays.Length) throw new ArgumentException("hitResults.Length < modelSpaceRays.Length");
+			return NativeAPI.mesh_ray_intersect_bvh_batch(_inst, modelSpaceRays, modelSpaceRays.Length, modelSpaceHits, hitResults, cullFaces);
+		}
 		
 		/// <summary>Retrieves the vertices associated with a particular
 		/// triangle on the Mesh.</summary>
@@ -344,6 +344,17 @@ namespace StereoKit
 		}
 		/// <summary> The playback mode of the active animation.</summary>
 		public AnimMode AnimMode => NativeAPI.model_anim_active_mode(_inst);
+		/// <summary> Skin this Model's animated meshes on the GPU instead of
+		/// the CPU. Bone weights stay on the GPU and only the bones get
+		/// uploaded each frame, so this is much cheaper for many animated
+		/// Models. Only applies to meshes using the default PBR or Unlit
+		/// shaders, others will still be skinned on the CPU. Defaults to
+		/// false.</summary>
+		public bool GpuSkinning
+		{
+			get => NativeAPI.model_get_gpu_skinning(_inst);
+			set => NativeAPI.model_set_gpu_skinning(_inst, value);
+		}
 
 
 		/// <summary>Checks the intersection point of this ray and a Model's 
@@ -370,6 +381,32 @@ namespace StereoKit
 		public bool Intersect(Ray modelSpaceRay, out Ray modelSpaceAt, Cull cullFaces = Cull.Back)
 			=> NativeAPI.model_ray_intersect(_inst, modelSpaceRay, out modelSpaceAt, cullFaces);
 
+		/// <summary>Intersects a whole batch of model space rays with this
+		/// Model at once. This uses the BVHs of the Model's Meshes, and
+		/// spreads the rays across StereoKit's worker threads, so it's much
+		/// faster than calling Intersect in a loop for large numbers of rays.
+		/// </summary>
+		/// <param name="modelSpaceRays">The rays to test, in model space.
+		/// </param>
+		/// <param name="modelSpaceHits">Receives the intersection point and
+		/// surface direction for each ray, this must be at least as long as
+		/// modelSpaceRays. Rays that don't hit anything get a zeroed out Ray.
+		/// </param>
+		/// <param name="hitResults">Optional, receives true for each ray that
+		/// hit the Model. If provided, this must be at least as long as
+		/// modelSpaceRays.</param>
+		/// <param name="cullFaces">How should intersection work with respect
+		/// to the direction the triangles are facing?</param>
+		/// <returns>The number of rays that hit the Model.</returns>
+		/// <exception cref="ArgumentException">modelSpaceHits or hitResults
+		/// are shorter than modelSpaceRays.</exception>
+		public int Intersect(Ray[] modelSpaceRays, Ray[] modelSpaceHits, bool[] hitResults = null, Cull cullFaces = Cull.Back)
+		{
+			if (modelSpaceHits.Length < modelSpaceRays.Length)                  throw new ArgumentException("modelSpaceHits.Length < modelSpaceRays.Length");
+			if (hitResults != null && hitResults.Length < modelSpaceRays.Length) throw new ArgumentException("hitResults.Length < modelSpaceRays.Length");
+			return NativeAPI.model_ray_intersect_bvh_batch(_inst, modelSpaceRays, modelSpaceRays.Length, modelSpaceHits, hitResults, cullFaces);
+		}
+
 		/// <summary>This adds a root node to the `Model`'s node hierarchy! If
 		/// There is already an initial root node, this node will still be a
 		/// root node, but will be a `Sibling` of the `Model`'s `RootNode`. If
@@ -32,6 +32,12 @@ namespace StereoKit
 		/// cleared each frame, you can think of this as "last frame's count".
 		/// </summary>
 		public int PrevCount => NativeAPI.render_list_prev_count(_inst);
+		/// <summary>The work this RenderList did before it was most recently
+		/// cleared, summed over every time it was drawn. Like PrevCount, for
+		/// a list that's drawn and cleared each frame, this is "last frame's
+		/// stats". GPU time isn't tracked per-list, so gpuMs is always -1.
+		/// </summary>
+		public RenderStats Stats => NativeAPI.render_list_get_stats(_inst);
 
 		/// <summary>Creates a new empty RenderList.</summary>
 		public RenderList()
@@ -129,6 +135,63 @@ namespace StereoKit
 		public void DrawNow(Tex toRenderTarget, Matrix camera, Matrix projection, Color clearColor = default, RenderClear clear = RenderClear.All, Rect viewportPct = default, RenderLayer layerFilter = RenderLayer.All)
 			=> NativeAPI.render_list_draw_now(_inst, toRenderTarget._inst, camera, projection, clearColor, clear, viewportPct, layerFilter);
 
+		/// <summary>Adds a Mesh/Material to the RenderList that stays there
+		/// across frames, and isn't removed by Clear. This is much cheaper
+		/// than re-adding static content every frame, since the item is only
+		/// sorted when persistent items are added or removed. The RenderList
+		/// holds a reference to these Assets until the item is removed.
+		/// </summary>
+		/// <param name="mesh">A valid Mesh you wish to draw.</param>
+		/// <param name="material">A Material to apply to the Mesh.</param>
+		/// <param name="transform">A transformation Matrix relative to the
+		/// current Hierarchy.</param>
+		/// <param name="colorLinear">A per-instance linear space color value
+		/// to pass into the shader!</param>
+		/// <param name="layer">The render layer this item is drawn on.
+		/// </param>
+		/// <returns>An id for this item, used with the other Persist
+		/// methods.</returns>
+		public int AddPersistent(Mesh mesh, Material material, Matrix transform, Color colorLinear, RenderLayer layer = RenderLayer.Layer0)
+			=> NativeAPI.render_list_persist_mesh(_inst, mesh._inst, material._inst, transform, colorLinear, layer);
+
+		/// <summary>Moves a persistent item added with AddPersistent.
+		/// </summary>
+		/// <param name="item">Id from AddPersistent.</param>
+		/// <param name="transform">A transformation Matrix relative to the
+		/// current Hierarchy.</param>
+		public void SetPersistentTransform(int item, Matrix transform) => NativeAPI.render_list_persist_set_transform(_inst, item, transform);
+
+		/// <summary>Changes the color of a persistent item added with
+		/// AddPersistent.</summary>
+		/// <param name="item">Id from AddPersistent.</param>
+		/// <param name="colorLinear">A per-instance linear space color.
+		/// </param>
+		public void SetPersistentColor(int item, Color colorLinear) => NativeAPI.render_list_persist_set_color(_inst, item, colorLinear);
+
+		/// <summary>Removes a persistent item added with AddPersistent, and
+		/// releases its Assets. The id is no longer valid after this.
+		/// </summary>
+		/// <param name="item">Id from AddPersistent.</param>
+		public void RemovePersistent(int item) => NativeAPI.render_list_persist_remove(_inst, item);
+
+		/// <summary>Attaches another RenderList to this one as a shard. Shards
+		/// can be filled from worker threads in parallel, and their contents
+		/// are moved into this list right before it gets sorted and drawn.
+		/// Each thread should fill its own shard, and all threads must be
+		/// finished adding to their shards before this list renders. Items
+		/// added to a shard ignore the Hierarchy, since that belongs to the
+		/// main thread. Shards also never step Model animation, so animated
+		/// Models need Model.StepAnim called on the main thread before the
+		/// workers add them.</summary>
+		/// <param name="shard">A RenderList that isn't already a shard of
+		/// some other list.</param>
+		public void AddShard(RenderList shard) => NativeAPI.render_list_add_shard(_inst, shard._inst);
+
+		/// <summary>Detaches a shard that was previously attached with
+		/// AddShard.</summary>
+		/// <param name="shard">A shard of this RenderList.</param>
+		public void RemoveShard(RenderList shard) => NativeAPI.render_list_remove_shard(_inst, shard._inst);
+
 		/// <summary>The default RenderList used by the Renderer for the
 		/// primary display surface.</summary>
 		public static RenderList Primary => Default.RenderList;
@@ -47,9 +47,46 @@ namespace StereoKit
 		public int UnreadSamples { get => (int)NativeAPI.sound_unread_samples(_inst); }
 
 		/// <summary>This is the current position of the playback cursor, 
-		/// measured in samples from the start of the audio data.</summary>
+		/// measured in samples from the start of the audio data. Since a
+		/// Sound can play several times at once, this is the cursor of the
+		/// instance that was started most recently.</summary>
 		public int CursorSamples { get => (int)NativeAPI.sound_cursor_samples(_inst); }
 
+		/// <summary>How many times WriteSamples has been handed more samples
+		/// than the stream had room for. The extra samples are dropped, so a
+		/// climbing number here means the stream buffer is too small, or the
+		/// reader isn't keeping up. Only valid for Stream sounds.</summary>
+		public ulong StreamOverruns { get => NativeAPI.sound_stream_get_overruns(_inst); }
+
+		/// <summary>How many times a playing stream has run out of samples
+		/// while the mixer was still asking for more. This counts once each
+		/// time the stream runs dry, not once per silent audio block. Only
+		/// valid for Stream sounds.</summary>
+		public ulong StreamUnderruns { get => NativeAPI.sound_stream_get_underruns(_inst); }
+
+		/// <summary>When too many sounds are playing at once, StereoKit
+		/// will stop the least important ones to make room for new ones.
+		/// Voices with a lower priority are stopped first, and the
+		/// quietest voices go first among those with the same priority.
+		/// A new sound will only replace a voice with a lower priority, or
+		/// a quieter voice of the same priority. Defaults to 0.</summary>
+		public int Priority {
+			get => NativeAPI.sound_get_priority(_inst);
+			set => NativeAPI.sound_set_priority(_inst, value);
+		}
+
+		/// <summary>Short sounds loaded from file are decoded ahead of time
+		/// on a background thread, so playing them is just a copy. This is
+		/// how many bytes of decoded audio StereoKit will keep around.
+		/// Once the cache is full, the sounds that were played least
+		/// recently are dropped, and will stream from the file until they
+		/// are decoded again. Set this to 0 to always stream. Defaults to
+		/// 32MB.</summary>
+		public static ulong CacheBudget {
+			get => NativeAPI.sound_get_cache_budget();
+			set => NativeAPI.sound_set_cache_budget(value);
+		}
+
 		internal Sound(IntPtr sound)
 		{
 			_inst = sound;
@@ -68,8 +105,9 @@ namespace StereoKit
 		/// volume falls off from 3D location, and can also indicate
 		/// direction and location through spatial audio cues. So make sure
 		/// the position is where you want people to think it's from!
-		/// Currently, if this sound is playing somewhere else, it'll be
-		/// canceled, and moved to this location.</summary>
+		/// Each call starts a new instance, so a Sound can overlap with
+		/// itself. Stream sounds are the exception, they only have one
+		/// instance, and playing them again just moves it.</summary>
 		/// <param name="at">World space location for the audio to play at.
 		/// </param>
 		/// <param name="volume">Volume modifier for the effect! 1 means full
@@ -117,7 +155,9 @@ namespace StereoKit
 
 		/// <summary>This will read samples from the sound stream, starting
 		/// from the first unread sample. Check UnreadSamples for how many
-		/// samples are available to read.</summary>
+		/// samples are available to read. While the sound is playing, the
+		/// audio mixer is the stream's reader, so this will read nothing.
+		/// </summary>
 		/// <param name="samples">A pre-allocated buffer to read the samples
 		/// into! This function will stop reading when this buffer is full,
 		/// or when the sound runs out of unread samples.</param>
@@ -129,7 +169,9 @@ namespace StereoKit
 
 		/// <summary>This will read samples from the sound stream, starting
 		/// from the first unread sample. Check UnreadSamples for how many
-		/// samples are available to read.</summary>
+		/// samples are available to read. While the sound is playing, the
+		/// audio mixer is the stream's reader, so this will read nothing.
+		/// </summary>
 		/// <param name="sampleBuffer">A pointer to a pre-allocated native
 		/// buffer of floats to read the samples into! This function will stop
 		/// reading when this buffer is full, or when the sound runs out of
@@ -180,6 +222,25 @@ namespace StereoKit
 			return inst == IntPtr.Zero ? null : new Sound(inst);
 		}
 
+		/// <summary>Create a streaming sound that never takes a lock, not
+		/// even from your own code. The underlying ring buffer is safe for
+		/// exactly one writer and one reader, so only write to it from a
+		/// single thread. If the sound is playing, the audio mixer is its
+		/// reader, and you should not also call ReadSamples on it.</summary>
+		/// <param name="streamBufferDuration">How much audio time should
+		/// this stream be able to hold without writing back over itself?
+		/// </param>
+		/// <param name="lockFree">Skip locking entirely? If false, this
+		/// behaves exactly like CreateStream(float).</param>
+		/// <returns>A stream sound that can be read and written to.</returns>
+		public static Sound CreateStream(float streamBufferDuration, bool lockFree)
+		{
+			IntPtr inst = lockFree
+				? NativeAPI.sound_create_stream_lockfree(streamBufferDuration)
+				: NativeAPI.sound_create_stream         (streamBufferDuration);
+			return inst == IntPtr.Zero ? null : new Sound(inst);
+		}
+
 		/// <summary>This function will create a sound from an array of
 		/// samples. Values should range from -1 to +1, and there should be
 		/// 48,000 values per second of audio.</summary>
@@ -157,6 +157,13 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool   mesh_ray_intersect   (IntPtr mesh, Ray model_space_ray, out Ray out_pt, IntPtr out_start_inds, Cull cull_mode);
 		[return: MarshalAs(UnmanagedType.Bool)]
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool   mesh_ray_intersect   (IntPtr mesh, Ray model_space_ray, out Ray out_pt, out uint out_start_inds, Cull cull_mode);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int    mesh_ray_intersect_bvh_batch(IntPtr mesh, [In] Ray[] model_space_rays, int ray_count, [Out] Ray[] out_hits, [Out, MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.Bool)] bool[] out_hit_results, Cull cull_mode);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void   mesh_set_collision_planes(IntPtr mesh, [MarshalAs(UnmanagedType.Bool)] bool store_planes);
+		[return: MarshalAs(UnmanagedType.Bool)]
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool   mesh_get_collision_planes(IntPtr mesh);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void   mesh_set_bvh_async   (IntPtr mesh, [MarshalAs(UnmanagedType.Bool)] bool async);
+		[return: MarshalAs(UnmanagedType.Bool)]
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool   mesh_get_bvh_async   (IntPtr mesh);
 		[return: MarshalAs(UnmanagedType.Bool)]
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool   mesh_get_triangle    (IntPtr mesh, uint triangle_index, out Vertex a, out Vertex b, out Vertex c);
 
@@ -367,6 +374,7 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern Bounds model_get_bounds        (IntPtr model);
 		[return: MarshalAs(UnmanagedType.Bool)]
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool   model_ray_intersect     (IntPtr model, Ray model_space_ray, out Ray out_pt, Cull cull_mode);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int    model_ray_intersect_bvh_batch(IntPtr model, [In] Ray[] model_space_rays, int ray_count, [Out] Ray[] out_hits, [Out, MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.Bool)] bool[] out_hit_results, Cull cull_mode);
 
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void     model_step_anim             (IntPtr model);
 		[return: MarshalAs(UnmanagedType.Bool)]
@@ -382,6 +390,9 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern float    model_anim_active_completion(IntPtr model);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr   model_anim_get_name         (IntPtr model, int index);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern float    model_anim_get_duration     (IntPtr model, int index);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void     model_set_gpu_skinning      (IntPtr model, [MarshalAs(UnmanagedType.Bool)] bool gpu_skinning);
+		[return: MarshalAs(UnmanagedType.Bool)]
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool     model_get_gpu_skinning      (IntPtr model);
 
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int    model_node_add                (IntPtr model,             string name, Matrix model_transform, IntPtr mesh, IntPtr material, int solid);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int    model_node_add_child          (IntPtr model, int parent, string name, Matrix local_transform, IntPtr mesh, IntPtr material, int solid);
@@ -482,9 +493,13 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_screenshot_pose([In] byte[] file_utf8, int file_quality_100, Pose viewpoint, int width, int height, float field_of_view_degrees);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_screenshot_capture  ([MarshalAs(UnmanagedType.FunctionPtr)] RenderOnScreenshotCallback render_on_screenshot_callback, Pose viewpoint, int width, int height, float fov_degrees, TexFormat tex_format, IntPtr context);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_screenshot_viewpoint([MarshalAs(UnmanagedType.FunctionPtr)] RenderOnScreenshotCallback render_on_screenshot_callback, Matrix camera, Matrix projection, int width, int height, RenderLayer layer_filter, RenderClear clear, Rect viewport, TexFormat tex_format, IntPtr context);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_screenshot_file     ([In] byte[] file_utf8, int file_quality_100, Matrix camera, Matrix projection, int width, int height, RenderLayer layer_filter, RenderClear clear, Rect viewport, [MarshalAs(UnmanagedType.FunctionPtr)] RenderOnScreenshotSavedCallback on_saved, IntPtr context);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_to             (IntPtr to_rendertarget, in Matrix camera, in Matrix projection, RenderLayer layer_filter, RenderClear clear, Rect viewport);
 		//[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void render_get_device  (void **device, void **context);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr             render_get_primary_list();
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern RenderStats        render_get_stats      (int frames_ago);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int                render_get_stats_history();
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern RenderStats        render_get_layer_stats(RenderLayer layer);
 
 		///////////////////////////////////////////
 
@@ -497,10 +512,17 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_clear        (IntPtr list);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int                render_list_item_count   (IntPtr list);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int                render_list_prev_count   (IntPtr list);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern RenderStats        render_list_get_stats    (IntPtr list);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_add_mesh     (IntPtr list, IntPtr mesh, IntPtr material,           Matrix transform, Color color_linear, RenderLayer layer);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_add_model    (IntPtr list, IntPtr model,                           Matrix transform, Color color_linear, RenderLayer layer);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_add_model_mat(IntPtr list, IntPtr model, IntPtr material_override, Matrix transform, Color color_linear, RenderLayer layer);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_draw_now     (IntPtr list, IntPtr to_rendertarget, Matrix camera, Matrix projection, Color clear_color, RenderClear clear, Rect viewport_pct, RenderLayer layer_filter);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_add_shard    (IntPtr list, IntPtr shard);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_remove_shard (IntPtr list, IntPtr shard);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int                render_list_persist_mesh (IntPtr list, IntPtr mesh, IntPtr material, Matrix transform, Color color_linear, RenderLayer layer);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_persist_set_transform(IntPtr list, int item, Matrix transform);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_persist_set_color    (IntPtr list, int item, Color color_linear);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_persist_remove       (IntPtr list, int item);
 
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_push         (IntPtr list);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void               render_list_pop          ();
@@ -532,6 +554,7 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr    sound_get_id        (IntPtr sound);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr    sound_create        ([In] byte[] filename_utf8);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr    sound_create_stream (float buffer_duration);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr    sound_create_stream_lockfree(float buffer_duration);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr    sound_create_samples([In] float[] samples_at_48000s, ulong sample_count);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr    sound_generate      ([MarshalAs(UnmanagedType.FunctionPtr)] AudioGenerator function, float duration);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void      sound_write_samples (IntPtr sound, [In ] float[] samples,     ulong sample_count);
@@ -539,9 +562,15 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_read_samples  (IntPtr sound, [Out] float[] out_samples, ulong sample_count);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_read_samples  (IntPtr sound, IntPtr        out_samples, ulong sample_count);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_unread_samples(IntPtr sound);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_stream_get_overruns (IntPtr sound);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_stream_get_underruns(IntPtr sound);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_total_samples (IntPtr sound);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_cursor_samples(IntPtr sound);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern SoundInst sound_play          (IntPtr sound, Vec3 at, float volume);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void      sound_set_priority  (IntPtr sound, int priority);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int       sound_get_priority  (IntPtr sound);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void      sound_set_cache_budget(ulong bytes);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ulong     sound_get_cache_budget();
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern float     sound_duration      (IntPtr sound);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void      sound_release       (IntPtr sound);
 
@@ -657,6 +686,7 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool         world_try_from_perception_anchor(IntPtr perception_spatial_anchor, out Pose out_pose);
 		[return: MarshalAs(UnmanagedType.Bool)]
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool         world_raycast                   (Ray ray, out Ray out_intersection);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern int          world_raycast_batch             ([In] Ray[] rays, int ray_count, [Out] Ray[] out_intersections, [Out, MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.Bool)] bool[] out_hit_results);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void         world_set_occlusion_enabled     ([MarshalAs(UnmanagedType.Bool)] bool enabled);
 		[return: MarshalAs(UnmanagedType.Bool)]
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool         world_get_occlusion_enabled     ();
@@ -717,6 +747,8 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr          backend_opengl_glx_get_drawable();
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr          backend_opengl_egl_get_context ();
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern IntPtr          backend_opengl_egl_get_display ();
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern BackendNullStats backend_null_get_stats       ();
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void            backend_null_reset_stats       ();
 
 		///////////////////////////////////////////
 
@@ -724,6 +756,18 @@ namespace StereoKit
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void log_set_filter (LogLevel level);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void log_subscribe_data  (LogCallbackData on_log, IntPtr context);
 		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void log_unsubscribe_data(LogCallbackData on_log, IntPtr context);
+
+		///////////////////////////////////////////
+
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void profiler_set_enabled([MarshalAs(UnmanagedType.Bool)] bool enabled);
+		[return: MarshalAs(UnmanagedType.Bool)]
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool profiler_get_enabled();
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void profiler_zone_begin ([In] byte[] name_utf8);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern ProfilerZone profiler_zone_name([In] byte[] name_utf8);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void profiler_zone_begin_id(ProfilerZone zone);
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern void profiler_zone_end   ();
+		[return: MarshalAs(UnmanagedType.Bool)]
+		[DllImport(dll, CharSet = cSet, CallingConvention = call)] public static extern bool profiler_save_trace ([In] byte[] filename_utf8);
 		
 		///////////////////////////////////////////
 
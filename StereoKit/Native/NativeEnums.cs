@@ -1292,6 +1292,11 @@ namespace StereoKit
 		OpenGLES_EGL,
 		/// <summary>WebGL is used for rendering. This is used by default on Web.</summary>
 		WebGL,
+		/// <summary>No GPU is used at all! Draw calls and uploads are
+		/// accepted and counted, but nothing is rendered. This is only
+		/// available when StereoKit is built with SK_GPU_NULL, and is intended
+		/// for headless CPU-side benchmarking.</summary>
+		Null,
 	}
 
 	/// <summary>The log tool will write to the console with annotations for console
@@ -467,6 +467,73 @@ namespace StereoKit
 		}
 	}
 
+	/// <summary>A summary of the renderer's work, either over a whole frame,
+	/// or for a single RenderList. Every draw of a list adds to these, so
+	/// stereo views, screenshots, viewpoints and RenderTo calls all
+	/// contribute.</summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public struct RenderStats
+	{
+		/// <summary>Bytes of per-instance data uploaded to the GPU for
+		/// drawing.</summary>
+		public long  instanceBytes;
+		/// <summary>Bytes of texture data uploaded to the GPU.</summary>
+		public long  textureBytes;
+		/// <summary>Bytes of vertex, index and bone data uploaded to the
+		/// GPU.</summary>
+		public long  meshBytes;
+		/// <summary>GPU time spent drawing render lists, in milliseconds.
+		/// This trails the CPU by a few frames, and is -1 where the graphics
+		/// backend can't measure it.</summary>
+		public float gpuMs;
+		/// <summary>Items in the list when it was prepared for drawing,
+		/// including persistent items.</summary>
+		public int   itemsQueued;
+		/// <summary>Items skipped because no view could see them.</summary>
+		public int   itemsCulled;
+		/// <summary>Items that needed a full sort.</summary>
+		public int   itemsSorted;
+		/// <summary>Sorts skipped because last frame's order was still
+		/// valid.</summary>
+		public int   sortReused;
+		/// <summary>Sorts that needed the full radix sort.</summary>
+		public int   sortRadix;
+		/// <summary>Draw calls submitted to the GPU.</summary>
+		public int   drawCalls;
+		/// <summary>Instances drawn across all draw calls.</summary>
+		public int   drawInstances;
+		/// <summary>How many times a new mesh was bound.</summary>
+		public int   swapsMesh;
+		/// <summary>How many times a new material was bound.</summary>
+		public int   swapsMaterial;
+	}
+
+	/// <summary>Work counted by the null graphics backend since StereoKit
+	/// started, or since the stats were last reset. Nothing reaches a GPU,
+	/// but this is what would have.</summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public struct BackendNullStats
+	{
+		/// <summary>Draw calls issued.</summary>
+		public long drawCalls;
+		/// <summary>Instances across all draw calls.</summary>
+		public long instances;
+		/// <summary>Indices across all draw calls, multiplied by their
+		/// instance counts.</summary>
+		public long indices;
+		/// <summary>Bytes uploaded into buffers, at creation or from
+		/// updates.</summary>
+		public long bufferBytes;
+		/// <summary>Bytes uploaded into textures.</summary>
+		public long textureBytes;
+		/// <summary>Buffers created.</summary>
+		public long buffersCreated;
+		/// <summary>Textures created.</summary>
+		public long texturesCreated;
+		/// <summary>Frames presented.</summary>
+		public long frames;
+	}
+
 	/// <summary>A callback for when log events occur.</summary>
 	/// <param name="level">The level of severity of this log event.</param>
 	/// <param name="text">The text contents of the log event.</param>
@@ -497,6 +564,15 @@ namespace StereoKit
 	[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
 	public delegate void ScreenshotCallback(IntPtr data, int width, int height);
 
+	[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+	internal delegate void RenderOnScreenshotSavedCallback(IntPtr file_utf8, bool success, IntPtr context);
+
+	/// <summary>A callback for when a screenshot has finished saving to
+	/// file.</summary>
+	/// <param name="filename">The file the screenshot was saved to.</param>
+	/// <param name="success">False if the file couldn't be written.</param>
+	public delegate void ScreenshotSavedCallback(string filename, bool success);
+
 	/// <summary>A callback that generates a sound wave at a particular point
 	/// in time.</summary>
 	/// <param name="time">The time along the wavelength.</param>
@@ -321,6 +321,18 @@ namespace StereoKit
 			/// `eglCreateContext`.</summary>
 			public static IntPtr Context => NativeAPI.backend_opengl_egl_get_context();
 		}
+
+		/// <summary>When StereoKit is built with the SK_GPU_NULL cmake
+		/// option, graphics work is counted instead of being sent to a GPU.
+		/// This is meant for headless CPU-side benchmarking.</summary>
+		public static class Null
+		{
+			/// <summary>Everything the null backend has counted since
+			/// StereoKit started, or since ResetStats.</summary>
+			public static BackendNullStats Stats => NativeAPI.backend_null_get_stats();
+			/// <summary>Zeroes out the counts in Stats.</summary>
+			public static void ResetStats() => NativeAPI.backend_null_reset_stats();
+		}
 		
 	}
 }
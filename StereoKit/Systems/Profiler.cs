@@ -0,0 +1,71 @@
+﻿using System.Runtime.InteropServices;
+
+namespace StereoKit
+{
+	/// <summary>A low overhead CPU profiler that records nested timing zones
+	/// from StereoKit's systems, as well as any zones you add yourself. The
+	/// most recent few hundred frames are kept, and can be saved as a Chrome
+	/// trace file for viewing in Perfetto or chrome://tracing. This is great
+	/// for finding frame spikes that averages would hide!</summary>
+	public static class Profiler
+	{
+		/// <summary>Is the profiler recording? Changes take effect at the
+		/// start of the next frame. This is off by default, and zones cost
+		/// very little while it's off.</summary>
+		public static bool Enabled {
+			get => NativeAPI.profiler_get_enabled();
+			set => NativeAPI.profiler_set_enabled(value);
+		}
+
+		/// <summary>Begins a named timing zone on the current thread. Zones
+		/// can be nested, and every BeginZone must be paired with an EndZone
+		/// on the same thread. This converts and looks up the name on every
+		/// call, so for code that runs often, cache a ZoneName instead.
+		/// </summary>
+		/// <param name="name">The name this zone will show up as in the
+		/// trace.</param>
+		public static void BeginZone(string name)
+			=> NativeAPI.profiler_zone_begin(NativeHelper.ToUtf8(name));
+
+		/// <summary>Begins a timing zone using a name registered earlier
+		/// with ZoneName. This skips all string work, so it's the cheapest
+		/// way to add a zone. It must be paired with an EndZone on the same
+		/// thread.</summary>
+		/// <param name="zone">A zone name from ZoneName.</param>
+		public static void BeginZone(ProfilerZone zone)
+			=> NativeAPI.profiler_zone_begin_id(zone);
+
+		/// <summary>Registers a zone name once, so it can be passed to
+		/// BeginZone repeatedly without any string conversion or lookups.
+		/// Call this after SK.Initialize, the result is valid until
+		/// StereoKit shuts down.</summary>
+		/// <param name="name">The name zones will show up as in the trace.
+		/// </param>
+		/// <returns>A handle for BeginZone.</returns>
+		public static ProfilerZone ZoneName(string name)
+			=> NativeAPI.profiler_zone_name(NativeHelper.ToUtf8(name));
+
+		/// <summary>Ends the most recent zone started with BeginZone on
+		/// this thread.</summary>
+		public static void EndZone()
+			=> NativeAPI.profiler_zone_end();
+
+		/// <summary>Writes the recently recorded frames out as a Chrome
+		/// trace JSON file.</summary>
+		/// <param name="filename">Where to save the trace, this should
+		/// usually end with .json.</param>
+		/// <returns>True if the file was written successfully.</returns>
+		public static bool SaveTrace(string filename)
+			=> NativeAPI.profiler_save_trace(NativeHelper.ToUtf8(filename));
+	}
+
+	/// <summary>A zone name registered with Profiler.ZoneName, for starting
+	/// zones without any per-call string work.</summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public struct ProfilerZone
+	{
+#pragma warning disable 0169 // handle is not "used", but required for interop
+		ulong _id;
+#pragma warning restore 0169
+	}
+}
@@ -12,6 +12,7 @@ namespace StereoKit
 		/// <summary>A queue is used to prevent premature garbage collection
 		/// of the user-defined callbacks.</summary>
 		private static Queue<RenderOnScreenshotCallback> _renderCaptureCallbacks;
+		private static Queue<RenderOnScreenshotSavedCallback> _renderSavedCallbacks;
 
 		/// <summary>Set a cubemap skybox texture for rendering a background! This is only visible on Opaque
 		/// displays, since transparent displays have the real world behind them already! StereoKit has a
@@ -428,6 +429,60 @@ namespace StereoKit
 			NativeAPI.render_screenshot_viewpoint(renderCaptureCallback, camera, projection, width, height, layerFilter, clear, viewport, texFormat, IntPtr.Zero);
 		}
 
+		/// <summary>Schedules a screenshot for the end of the frame, and saves
+		/// it to file. The GPU is read back over the next few frames, and the
+		/// image is encoded on a worker thread, so this won't hitch the app.
+		/// onSaved is called on the main thread once the file is written,
+		/// and saves are always reported in the order they were requested.
+		/// </summary>
+		/// <param name="filename">Filename to write the screenshot to! This
+		/// will be a PNG if the extension ends with (case insensitive)
+		/// ".png", and will be a JPEG if it ends with anything else.</param>
+		/// <param name="fileQuality">For JPEG files, this is the compression
+		/// quality of the file from 0-100, 100 being highest quality, 0 being
+		/// smallest size. SK uses a default of 90 here.</param>
+		/// <param name="camera">A TRS matrix representing the location and
+		/// orientation of the camera. This matrix gets inverted later on, so
+		/// no need to do it yourself.</param>
+		/// <param name="projection">The projection matrix describes how the
+		/// geometry is flattened onto the draw surface. Normally, you'd use 
+		/// Matrix.Perspective, and occasionally Matrix.Orthographic might be
+		/// helpful as well.</param>
+		/// <param name="width">Size of the screenshot horizontally, in pixels.
+		/// </param>
+		/// <param name="height">Size of the screenshot vertically, in pixels.
+		/// </param>
+		/// <param name="layerFilter">This is a bit flag that allows you to
+		/// change which layers StereoKit renders for this particular render
+		/// viewpoint. To change what layers a visual is on, use a Draw
+		/// method that includes a RenderLayer as a parameter.</param>
+		/// <param name="clear">Describes if and how the rendertarget should
+		/// be cleared before rendering. Note that clearing the target is
+		/// unaffected by the viewport, so this will clean the entire 
+		/// surface!</param>
+		/// <param name="viewport">Allows you to specify a region of the
+		/// screenshot to draw to, in pixels. If the width of this value is
+		/// zero, then this will render to the entire image.</param>
+		/// <param name="onSaved">Optional, called once the file has been
+		/// written, or has failed to write.</param>
+		public static void Screenshot(string filename, int fileQuality, Matrix camera, Matrix projection, int width, int height, RenderLayer layerFilter = RenderLayer.All, RenderClear clear = RenderClear.All, Rect viewport = default(Rect), ScreenshotSavedCallback onSaved = null)
+		{
+			if (onSaved == null)
+			{
+				NativeAPI.render_screenshot_file(NativeHelper.ToUtf8(filename), fileQuality, camera, projection, width, height, layerFilter, clear, viewport, null, IntPtr.Zero);
+				return;
+			}
+
+			if (_renderSavedCallbacks is null) _renderSavedCallbacks = new Queue<RenderOnScreenshotSavedCallback>();
+			RenderOnScreenshotSavedCallback renderSavedCallback = (IntPtr file, bool success, IntPtr context) =>
+			{
+				onSaved.Invoke(NativeHelper.FromUtf8(file), success);
+				_ = _renderSavedCallbacks.Dequeue();
+			};
+			_renderSavedCallbacks.Enqueue(renderSavedCallback);
+			NativeAPI.render_screenshot_file(NativeHelper.ToUtf8(filename), fileQuality, camera, projection, width, height, layerFilter, clear, viewport, renderSavedCallback, IntPtr.Zero);
+		}
+
 		/// <summary>This renders the current scene to the indicated 
 		/// rendertarget texture, from the specified viewpoint. This call 
 		/// enqueues a render that occurs immediately before the screen 
@@ -456,5 +511,32 @@ namespace StereoKit
 		public static void RenderTo(Tex toRendertarget, Matrix camera, Matrix projection, RenderLayer layerFilter = RenderLayer.All, RenderClear clear = RenderClear.All, Rect viewport = default(Rect))
 			=> NativeAPI.render_to(toRendertarget._inst, camera, projection, layerFilter, clear, viewport);
 
+		/// <summary>Gets a summary of the renderer's work for a recently
+		/// completed frame. Frames are finalized at the start of the next
+		/// frame's step, so the frame currently being built isn't available
+		/// yet.</summary>
+		/// <param name="framesAgo">0 is the most recently completed frame,
+		/// 1 the one before that, and so on up to StatsHistory-1. Frames
+		/// outside of that range come back zeroed, with a gpuMs of -1.
+		/// </param>
+		/// <returns>The stats for that frame.</returns>
+		public static RenderStats GetStats(int framesAgo = 0)
+			=> NativeAPI.render_get_stats(framesAgo);
+
+		/// <summary>How many completed frames of stats are available from
+		/// GetStats right now. This tops out at a fixed history size.
+		/// </summary>
+		public static int StatsHistory => NativeAPI.render_get_stats_history();
+
+		/// <summary>Gets the culled and drawn counts for specific layers
+		/// during the most recently completed frame. Only itemsCulled and
+		/// drawInstances are tracked per-layer, everything else is zero.
+		/// </summary>
+		/// <param name="layer">The layers to sum stats over. Items that are
+		/// on several of these layers will be counted once for each.</param>
+		/// <returns>Stats for the requested layers.</returns>
+		public static RenderStats GetLayerStats(RenderLayer layer)
+			=> NativeAPI.render_get_layer_stats(layer);
+
 	}
 }
@@ -193,6 +193,28 @@ namespace StereoKit
 		public static bool Raycast(Ray ray, out Ray intersection)
 			=> NativeAPI.world_raycast(ray, out intersection);
 
+		/// <summary>The same as Raycast, but for a whole batch of world space
+		/// rays at once! The rays are spread across StereoKit's worker
+		/// threads, so this is a good choice for things like audio occlusion
+		/// where many rays are needed each frame.</summary>
+		/// <param name="rays">World space rays that you'd like to try
+		/// intersecting with the world mesh.</param>
+		/// <param name="intersections">Receives the intersection for each
+		/// ray, this must be at least as long as rays. Rays that don't hit
+		/// anything get a zeroed out Ray.</param>
+		/// <param name="hitResults">Optional, receives true for each ray that
+		/// hit the world. If provided, this must be at least as long as rays.
+		/// </param>
+		/// <returns>The number of rays that hit the world.</returns>
+		/// <exception cref="ArgumentException">intersections or hitResults
+		/// are shorter than rays.</exception>
+		public static int Raycast(Ray[] rays, Ray[] intersections, bool[] hitResults = null)
+		{
+			if (intersections.Length < rays.Length)                    throw new ArgumentException("intersections.Length < rays.Length");
+			if (hitResults != null && hitResults.Length < rays.Length) throw new ArgumentException("hitResults.Length < rays.Length");
+			return NativeAPI.world_raycast_batch(rays, rays.Length, intersections, hitResults);
+		}
+
 		/// <summary>Off by default. This tells StereoKit to load up and
 		/// display an occlusion surface that allows the real world to
 		/// occlude the application's digital content! Most systems may allow
@@ -1,11 +1,31 @@
 #include "animation.h"
 #include "model.h"
 #include "mesh.h"
+#include "material.h"
 #include "../sk_math.h"
+#include "../systems/defaults.h"
 #include "../libraries/stref.h"
+#include "../systems/jobs.h"
+#include "../systems/profiler.h"
 
 namespace sk {
 
+const int32_t anim_skin_job_size = mesh_skin_job_size;
+
+struct anim_skin_job_t {
+	mesh_t  mesh;
+	int32_t start;
+	int32_t end;
+	vec3    min;
+	vec3    max;
+};
+
+struct anim_state_t {
+	array_t<anim_skin_job_t> skin_jobs;
+	int32_t                  skin_verts;
+};
+static anim_state_t local = {};
+
 array_t<model_t> animation_list = {};
 
 ///////////////////////////////////////////
@@ -152,8 +172,10 @@ void anim_update_model(model_t model) {
 		: time_totalf();
 	if (model->anim_inst.last_update == curr_time) return;
 	model->anim_inst.last_update = curr_time;
+	profiler_zone("Anim Update Model");
 	model->transforms_changed    = true;
 	model->bounds_dirty          = true;
+	model->ray_accel.refit       = true;
 
 	anim_t *anim = &model->anim_data.anims[model->anim_inst.anim_id];
 	float   time = model_anim_active_time(model);
@@ -180,6 +202,14 @@ void anim_update_skin(model_t model) {
 
 ///////////////////////////////////////////
 
+shader_t _anim_skin_shader(shader_t shader) {
+	if (shader == sk_default_shader_pbr  ) return sk_default_shader_pbr_skin;
+	if (shader == sk_default_shader_unlit) return sk_default_shader_unlit_skin;
+	return nullptr;
+}
+
+///////////////////////////////////////////
+
 void _anim_inst_check_ready(model_t model) {
 	anim_inst_t *inst = &model->anim_inst;
 	anim_data_t *data = &model->anim_data;
@@ -197,10 +227,29 @@ void _anim_inst_check_ready(model_t model) {
 		inst->skinned_mesh_count = data->skeletons.count;
 		inst->skinned_meshes     = sk_malloc_t(anim_inst_subset_t, inst->skinned_mesh_count);
 		for (int32_t i = 0; i < inst->skinned_mesh_count; i++) {
-			inst->skinned_meshes[i].original_mesh   = model_node_get_mesh(model, data->skeletons[i].skin_node);
-			inst->skinned_meshes[i].modified_mesh   = mesh_copy(inst->skinned_meshes[i].original_mesh);
-			inst->skinned_meshes[i].bone_transforms = sk_malloc_t(matrix, data->skeletons[i].bone_count);
-			model_node_set_mesh(model, data->skeletons[i].skin_node, inst->skinned_meshes[i].modified_mesh);
+			anim_inst_subset_t *subset    = &inst->skinned_meshes[i];
+			model_node_id       skin_node = data->skeletons[i].skin_node;
+			*subset = {};
+			subset->original_mesh     = model_node_get_mesh    (model, skin_node);
+			subset->original_material = model_node_get_material(model, skin_node);
+			subset->bone_transforms   = sk_malloc_t(matrix, data->skeletons[i].bone_count);
+
+			// GPU skinning only works with shaders that have a skinning
+			// variant, anything else gets skinned on the CPU.
+			shader_t skin_shader = model->gpu_skinning && subset->original_material
+				? _anim_skin_shader(subset->original_material->shader)
+				: nullptr;
+			if (skin_shader != nullptr) {
+				material_t skin_material = material_copy(subset->original_material);
+				material_set_shader    (skin_material, skin_shader);
+				model_node_set_material(model, skin_node, skin_material);
+				material_release       (skin_material);
+				subset->modified_mesh = mesh_skin_gpu_instance(subset->original_mesh);
+				subset->gpu           = true;
+			} else {
+				subset->modified_mesh = mesh_copy(subset->original_mesh);
+			}
+			model_node_set_mesh(model, skin_node, subset->modified_mesh);
 		}
 	}
 }
@@ -218,11 +267,70 @@ void _anim_update_skin(model_t &model) {
 		for (int32_t b = 0; b < model->anim_data.skeletons[i].bone_count; b++) {
 			model->anim_inst.skinned_meshes[i].bone_transforms[b] = model_node_get_transform_model(model, model->anim_data.skeletons[i].bone_to_node_map[b]) * root;
 		}
-		mesh_update_skin(
-			model->anim_inst.skinned_meshes[i].modified_mesh,
+
+		mesh_t mesh = model->anim_inst.skinned_meshes[i].modified_mesh;
+		mesh_skin_prepare(mesh,
 			model->anim_inst.skinned_meshes[i].bone_transforms,
 			model->anim_data.skeletons     [i].bone_count);
+
+		// GPU skinned meshes only need their bone palette uploaded
+		if (model->anim_inst.skinned_meshes[i].gpu) {
+			mesh_skin_gpu_apply(mesh);
+			continue;
+		}
+
+		// Vertex deformation is queued up here, and spread across the skinning
+		// threads in anim_step once every model has been visited.
+		int32_t vert_count = (int32_t)mesh->vert_count;
+		for (int32_t start = 0; start < vert_count; start += anim_skin_job_size) {
+			anim_skin_job_t job = {};
+			job.mesh  = mesh;
+			job.start = start;
+			job.end   = mini(start + anim_skin_job_size, vert_count);
+			local.skin_jobs.add(job);
+		}
+		local.skin_verts += vert_count;
+	}
+}
+
+///////////////////////////////////////////
+
+void _anim_skin_work(int32_t start, int32_t end, void *) {
+	for (int32_t i = start; i < end; i++) {
+		anim_skin_job_t *job = &local.skin_jobs[i];
+		mesh_skin_range(job->mesh, job->start, job->end, &job->min, &job->max);
+	}
+}
+
+///////////////////////////////////////////
+
+void _anim_skin_execute() {
+	if (local.skin_jobs.count == 0) return;
+	profiler_zone("Anim Skinning");
+
+	// Not worth waking anyone up for small amounts of work. Otherwise the
+	// main thread pitches in on the batches while waiting on the workers.
+	if (local.skin_verts < anim_skin_job_size * 2) _anim_skin_work(0, local.skin_jobs.count, nullptr);
+	else                                            jobs_parallel_for(local.skin_jobs.count, 1, _anim_skin_work, nullptr);
+
+	// Jobs for a mesh are contiguous, so reduce each run of them into one set
+	// of bounds, and upload the result.
+	int32_t i = 0;
+	while (i < local.skin_jobs.count) {
+		mesh_t mesh = local.skin_jobs[i].mesh;
+		vec3   min  = local.skin_jobs[i].min;
+		vec3   max  = local.skin_jobs[i].max;
+		i += 1;
+		while (i < local.skin_jobs.count && local.skin_jobs[i].mesh == mesh) {
+			vec3 job_max = local.skin_jobs[i].max;
+			min   = vec3_min(min, local.skin_jobs[i].min);
+			max   = { fmaxf(max.x, job_max.x), fmaxf(max.y, job_max.y), fmaxf(max.z, job_max.z) };
+			i += 1;
+		}
+		mesh_skin_apply(mesh, min, max);
 	}
+	local.skin_jobs.clear();
+	local.skin_verts = 0;
 }
 
 ///////////////////////////////////////////
@@ -250,13 +358,39 @@ void anim_inst_play(model_t model, int32_t anim_id, anim_mode_ mode) {
 
 ///////////////////////////////////////////
 
-void anim_inst_destroy(anim_inst_t *inst) {
+void _anim_inst_free_skin(anim_inst_t *inst) {
 	for (int32_t i = 0; i < inst->skinned_mesh_count; i++) {
-		sk_free(inst->skinned_meshes[i].bone_transforms);
-		mesh_release(inst->skinned_meshes[i].original_mesh);
-		mesh_release(inst->skinned_meshes[i].modified_mesh);
+		sk_free         (inst->skinned_meshes[i].bone_transforms);
+		mesh_release    (inst->skinned_meshes[i].original_mesh);
+		mesh_release    (inst->skinned_meshes[i].modified_mesh);
+		material_release(inst->skinned_meshes[i].original_material);
 	}
 	sk_free(inst->skinned_meshes);
+	inst->skinned_meshes     = nullptr;
+	inst->skinned_mesh_count = 0;
+}
+
+///////////////////////////////////////////
+
+void anim_inst_reset_skin(model_t model) {
+	anim_inst_t *inst = &model->anim_inst;
+	if (inst->skinned_meshes == nullptr) return;
+
+	// Put the original mesh and material back on each skinned node, the next
+	// animation update will build new skinned meshes.
+	for (int32_t i = 0; i < inst->skinned_mesh_count; i++) {
+		model_node_id skin_node = model->anim_data.skeletons[i].skin_node;
+		model_node_set_mesh    (model, skin_node, inst->skinned_meshes[i].original_mesh);
+		model_node_set_material(model, skin_node, inst->skinned_meshes[i].original_material);
+	}
+	_anim_inst_free_skin(inst);
+	model->transforms_changed = true;
+}
+
+///////////////////////////////////////////
+
+void anim_inst_destroy(anim_inst_t *inst) {
+	_anim_inst_free_skin(inst);
 	sk_free(inst->curve_last_keyframe);
 	sk_free(inst->node_transforms);
 
@@ -344,11 +478,15 @@ anim_data_t anim_data_copy(anim_data_t *data) {
 void anim_step() {
 	animation_list.each(_anim_update_skin);
 	animation_list.clear();
+	_anim_skin_execute();
 }
 
 ///////////////////////////////////////////
 
 void anim_shutdown() {
+	local.skin_jobs.free();
+	local = {};
+
 	animation_list.free();
 }
 
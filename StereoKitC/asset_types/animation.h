@@ -53,9 +53,11 @@ struct anim_transform_t {
 };
 
 struct anim_inst_subset_t {
-	mesh_t  original_mesh;
-	mesh_t  modified_mesh;
-	matrix *bone_transforms;
+	mesh_t     original_mesh;
+	mesh_t     modified_mesh;
+	material_t original_material;
+	matrix    *bone_transforms;
+	bool32_t   gpu;
 };
 
 struct anim_inst_t {
@@ -75,6 +77,7 @@ void anim_update_model(model_t model);
 void anim_update_skin (model_t model);
 void anim_inst_play   (model_t model, int32_t anim_id, anim_mode_ mode);
 void anim_inst_destroy(anim_inst_t *inst);
+void anim_inst_reset_skin(model_t model);
 void anim_data_destroy(anim_data_t *data);
 anim_data_t anim_data_copy(anim_data_t *data);
 
@@ -26,6 +26,8 @@
 #include "../libraries/atomic_util.h"
 #include "../libraries/ferr_thread.h"
 #include "../systems/render_.h"
+#include "../systems/jobs.h"
+#include "../systems/profiler.h"
 
 #include <stdio.h>
 #include <assert.h>
@@ -45,14 +47,18 @@ struct asset_load_callback_t {
 	void *context;
 };
 
-struct asset_thread_t {
-	ft_id_t  id;
-	bool32_t running;
-};
-
 ///////////////////////////////////////////
 
+struct asset_index_t {
+	asset_header_t **slots;
+	int32_t          capacity;
+	int32_t          count;
+	int32_t          used; // count + tombstones
+};
+
 array_t<asset_header_t *>      assets = {};
+asset_index_t                  assets_index = {};
+ft_mutex_t                     assets_lock = {};
 array_t<asset_header_t *>      assets_multithread_destroy = {};
 ft_mutex_t                     assets_multithread_destroy_lock = {};
 ft_mutex_t                     assets_job_lock = {};
@@ -63,18 +69,111 @@ array_t<asset_header_t *>      assets_load_events = {};
 
 ///////////////////////////////////////////
 
-array_t<asset_thread_t>asset_threads         = {};
 bool32_t               asset_thread_enabled  = false;
-array_t<asset_task_t*> asset_thread_tasks    = {};
 ft_mutex_t             asset_thread_task_mtx = {};
 int32_t                asset_tasks_finished  = 0;
-int32_t                asset_tasks_processing= 0;
+volatile int32_t       asset_tasks_processing= 0;
 int32_t                asset_tasks_priority  = INT_MAX;
-ft_condition_t         asset_tasks_available = {};
 array_t<asset_task_t*> asset_active_tasks    = {};
 
-int32_t asset_thread   (void *);
-void    asset_step_task();
+void asset_task_run(void *task_ptr);
+
+///////////////////////////////////////////
+// Asset index                           //
+///////////////////////////////////////////
+
+// Marks a slot that used to hold an asset, so lookups keep probing past it.
+#define ASSET_INDEX_TOMBSTONE ((asset_header_t*)1)
+
+// The lock only exists between assets_init and assets_shutdown, outside of
+// that we're single threaded anyhow.
+inline void assets_lock_acquire() { if (assets_lock) ft_mutex_lock  (assets_lock); }
+inline void assets_lock_release() { if (assets_lock) ft_mutex_unlock(assets_lock); }
+
+///////////////////////////////////////////
+
+inline uint32_t asset_index_hash(uint64_t id, asset_type_ type) {
+	// ids are already fnv hashes, so this just needs to fold the type in
+	uint64_t h = id ^ ((uint64_t)type * 0x9E3779B97F4A7C15ULL);
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+///////////////////////////////////////////
+
+void asset_index_insert(asset_index_t *index, asset_header_t *asset);
+
+void asset_index_resize(asset_index_t *index, int32_t capacity) {
+	asset_header_t **old_slots    = index->slots;
+	int32_t          old_capacity = index->capacity;
+
+	index->slots    = sk_malloc_t(asset_header_t *, capacity);
+	index->capacity = capacity;
+	index->count    = 0;
+	index->used     = 0;
+	memset(index->slots, 0, sizeof(asset_header_t *) * capacity);
+
+	for (int32_t i = 0; i < old_capacity; i++) {
+		if (old_slots[i] != nullptr && old_slots[i] != ASSET_INDEX_TOMBSTONE)
+			asset_index_insert(index, old_slots[i]);
+	}
+	sk_free(old_slots);
+}
+
+///////////////////////////////////////////
+
+void asset_index_insert(asset_index_t *index, asset_header_t *asset) {
+	// Keep the load, tombstones included, under 3/4. If it's mostly
+	// tombstones, rebuilding at the same size is enough to clean them out.
+	if ((index->used + 1) * 4 > index->capacity * 3) {
+		int32_t capacity = index->capacity == 0 ? 256 : index->capacity;
+		while ((index->count + 1) * 2 > capacity) capacity *= 2;
+		asset_index_resize(index, capacity);
+	}
+
+	uint32_t mask = (uint32_t)index->capacity - 1;
+	uint32_t at   = asset_index_hash(asset->id, asset->type) & mask;
+	while (index->slots[at] != nullptr && index->slots[at] != ASSET_INDEX_TOMBSTONE)
+		at = (at + 1) & mask;
+
+	if (index->slots[at] == nullptr) index->used += 1;
+	index->slots[at] = asset;
+	index->count    += 1;
+}
+
+///////////////////////////////////////////
+
+void asset_index_remove(asset_index_t *index, asset_header_t *asset) {
+	if (index->capacity == 0) return;
+
+	uint32_t mask = (uint32_t)index->capacity - 1;
+	uint32_t at   = asset_index_hash(asset->id, asset->type) & mask;
+	while (index->slots[at] != nullptr) {
+		if (index->slots[at] == asset) {
+			index->slots[at] = ASSET_INDEX_TOMBSTONE;
+			index->count -= 1;
+			return;
+		}
+		at = (at + 1) & mask;
+	}
+}
+
+///////////////////////////////////////////
+
+asset_header_t *asset_index_find(const asset_index_t *index, uint64_t id, asset_type_ type) {
+	if (index->capacity == 0) return nullptr;
+
+	// The same id can show up more than once, like when an asset is waiting
+	// on destruction while a new one takes its name. Only live ones count.
+	uint32_t mask = (uint32_t)index->capacity - 1;
+	uint32_t at   = asset_index_hash(id, type) & mask;
+	while (index->slots[at] != nullptr) {
+		asset_header_t *asset = index->slots[at];
+		if (asset != ASSET_INDEX_TOMBSTONE && asset->id == id && asset->type == type && asset->refs > 0)
+			return asset;
+		at = (at + 1) & mask;
+	}
+	return nullptr;
+}
 
 ///////////////////////////////////////////
 
@@ -85,12 +184,10 @@ void *assets_find(const char *id, asset_type_ type) {
 ///////////////////////////////////////////
 
 void *assets_find(uint64_t id, asset_type_ type) {
-	int32_t count = assets.count;
-	for (int32_t i = 0; i < count; i++) {
-		if (assets[i]->id == id && assets[i]->type == type && assets[i]->refs > 0)
-			return assets[i];
-	}
-	return nullptr;
+	assets_lock_acquire();
+	void *result = asset_index_find(&assets_index, id, type);
+	assets_lock_release();
+	return result;
 }
 
 ///////////////////////////////////////////
@@ -125,11 +222,13 @@ void *assets_allocate(asset_type_ type) {
 	default: log_err("Unimplemented asset type!"); abort();
 	}
 
+	asset_header_t *header = (asset_header_t *)sk_malloc(size);
+	memset(header, 0, size);
+
+	assets_lock_acquire();
 	char name[64];
 	snprintf(name, sizeof(name), "auto/asset_%d", assets.count);
 
-	asset_header_t *header = (asset_header_t *)sk_malloc(size);
-	memset(header, 0, size);
 	header->type    = type;
 	header->id      = hash_fnv64_string(name);
 	header->id_text = string_copy(name);
@@ -137,6 +236,8 @@ void *assets_allocate(asset_type_ type) {
 	header->state   = asset_state_none;
 	assets_addref(header);
 	assets.add(header);
+	asset_index_insert(&assets_index, header);
+	assets_lock_release();
 	return header;
 }
 
@@ -159,7 +260,11 @@ void assets_set_id(asset_header_t *header, uint64_t id) {
 	}
 	assert(other == nullptr);
 #endif
+	assets_lock_acquire();
+	asset_index_remove(&assets_index, header);
 	header->id = id;
+	asset_index_insert(&assets_index, header);
+	assets_lock_release();
 }
 
 ///////////////////////////////////////////
@@ -236,12 +341,15 @@ void assets_destroy(asset_header_t *asset) {
 	}
 
 	// Remove it from our list of assets
+	assets_lock_acquire();
+	asset_index_remove(&assets_index, asset);
 	for (int32_t i = 0; i < assets.count; i++) {
 		if (assets[i] == asset) {
 			assets.remove(i);
 			break;
 		}
 	}
+	assets_lock_release();
 
 	// And at last, free the memory we allocated for it!
 	sk_free(asset);
@@ -347,25 +455,15 @@ char *assets_file(const char *file_name) {
 ///////////////////////////////////////////
 
 bool assets_init() {
+	assets_lock                     = ft_mutex_create();
 	assets_multithread_destroy_lock = ft_mutex_create();
 	assets_job_lock                 = ft_mutex_create();
 	asset_thread_task_mtx           = ft_mutex_create();
 	assets_load_event_lock          = ft_mutex_create();
-	asset_tasks_available           = ft_condition_create();
 
 	texture_compression_init();
 
-#if !defined(__EMSCRIPTEN__)
-	asset_threads.resize(3);
-#endif
 	asset_thread_enabled = true;
-	for (int32_t i = 0; i < asset_threads.capacity; i++)
-	{
-		asset_threads.add({});
-		asset_thread_t* th = &asset_threads.last();
-		ft_thread_create(asset_thread, th);
-	}
-
 	return true;
 }
 
@@ -373,10 +471,10 @@ bool assets_init() {
 
 array_t<asset_load_callback_t> assets_load_call_list = {};
 void assets_step() {
-	// If we have no asset threads for some reason (like WASM), then we'll need
+	// If we have no job workers for some reason (like WASM), then we'll need
 	// to make sure assets still get loaded here!
-	if (asset_threads.count <= 0) {
-		asset_step_task();
+	if (jobs_worker_count() <= 0) {
+		jobs_execute_one(job_priority_low);
 	}
 
 	// destroy objects where the request came from another thread
@@ -389,12 +487,21 @@ void assets_step() {
 
 	// Do any jobs the assets need on the main thread, like GPU buffer uploads
 	ft_mutex_lock(assets_job_lock);
-	for (int32_t i = 0; i < assets_gpu_jobs.count; i++) {
-		assets_gpu_jobs[i]->success  = assets_gpu_jobs[i]->asset_job(assets_gpu_jobs[i]->data);
-		assets_gpu_jobs[i]->finished = true;
-	}
-	assets_gpu_jobs.clear();
+	// Swap the list out first, completing a job can queue up the next one.
+	array_t<asset_job_t *> gpu_jobs = assets_gpu_jobs;
+	assets_gpu_jobs = {};
 	ft_mutex_unlock(assets_job_lock);
+	for (int32_t i = 0; i < gpu_jobs.count; i++) {
+		profiler_zone("Asset GPU Job");
+		asset_job_t *job = gpu_jobs[i];
+		// The job may be freed by the waiting thread as soon as finished is
+		// set, so grab everything we need from it first.
+		void (*on_complete)(asset_job_t *) = job->on_complete;
+		job->success = job->asset_job(job->data);
+		if (on_complete) on_complete(job);
+		else             job->finished = true;
+	}
+	gpu_jobs.free();
 
 	// Update any on_load event callbacks
 	ft_mutex_lock(assets_load_event_lock);
@@ -424,22 +531,19 @@ void assets_step() {
 ///////////////////////////////////////////
 
 void assets_shutdown() {
-	asset_thread_enabled = false;
-	ft_condition_broadcast(asset_tasks_available);
-	for (int32_t i = 0; i < asset_threads.count; i++) {
-		while (asset_threads[i].running) {
-			assets_step();
-			ft_yield();
-		}
+	// Let any in-flight loads run to completion, they may still need the
+	// main thread for GPU work.
+	while (asset_tasks_processing > 0) {
+		assets_step();
+		ft_yield();
 	}
-	asset_threads.free();
+	asset_thread_enabled = false;
 
 #if defined(SK_DEBUG_MEM)
 	assets_shutdown_check();
 #endif
 
 	ft_mutex_destroy(&asset_thread_task_mtx);
-	asset_thread_tasks.free();
 	asset_active_tasks.free();
 
 	assets_multithread_destroy.free();
@@ -447,12 +551,14 @@ void assets_shutdown() {
 	ft_mutex_destroy(&assets_multithread_destroy_lock);
 	ft_mutex_destroy(&assets_job_lock);
 	ft_mutex_destroy(&assets_load_event_lock);
-	ft_condition_destroy(&asset_tasks_available);
 
 	assets_load_call_list.free();
 	assets_load_callbacks.free();
 	assets_load_events   .free();
 	assets               .free();
+	sk_free(assets_index.slots);
+	assets_index = {};
+	ft_mutex_destroy(&assets_lock);
 
 	asset_tasks_processing = 0;
 	asset_tasks_finished   = 0;
@@ -569,35 +675,39 @@ void asset_release(asset_t asset) {
 // Asset thread                          //
 ///////////////////////////////////////////
 
+// Below this complexity, a load is cheap enough that it shouldn't wait behind
+// large textures and meshes.
+#define ASSET_TASK_LIGHT_COMPLEXITY (256 * 256)
+
+inline int32_t asset_task_complexity(const asset_task_t *task) {
+	return (int32_t)(task->sort & 0xFFFFFFFF);
+}
+
+// Loads with a priority below the default, and loads known to be cheap, go
+// ahead of the rest of the background work. A complexity of 0 means it isn't
+// known yet, like a file that hasn't been opened.
+inline job_priority_ asset_task_lane(const asset_task_t *task) {
+	int32_t complexity = asset_task_complexity(task);
+	return task->priority < 10 || (complexity > 0 && complexity < ASSET_TASK_LIGHT_COMPLEXITY)
+		? job_priority_normal
+		: job_priority_low;
+}
+
+///////////////////////////////////////////
+
 void assets_add_task(asset_task_t src_task) {
 	asset_task_t *task = sk_malloc_t(asset_task_t, 1);
 	memcpy(task, &src_task, sizeof(asset_task_t));
 	assets_addref(task->asset);
 
 	ft_mutex_lock(asset_thread_task_mtx);
-
-	// This array_t function has some strange behavior on 32 bit builds related
-	// to render sort items. We're duplicating it here without templating to
-	// avoid the issue for now.
-	int32_t idx = -1;
-	int32_t l = 0, r = asset_thread_tasks.count - 1;
-	while (l <= r) {
-		int32_t mid     = (l + r) / 2;
-		int64_t mid_val = asset_thread_tasks[mid]->sort;
-		if      (mid_val < task->sort) l = mid + 1;
-		else if (mid_val > task->sort) r = mid - 1;
-		else { idx = mid; break; };
-	}
-	if (idx == -1)
-		idx = r < 0 ? r : -(r + 2);
-
-	if (idx < 0) idx = ~idx;
-	asset_thread_tasks.insert(idx, task);
-	asset_tasks_processing += 1;
+	asset_active_tasks.add(task);
+	atomic_increment(&asset_tasks_processing);
+	if (asset_tasks_priority > task->priority)
+		asset_tasks_priority = task->priority;
 	ft_mutex_unlock(asset_thread_task_mtx);
 
-	if (asset_thread_tasks.count > 1) ft_condition_broadcast(asset_tasks_available);
-	else                              ft_condition_signal   (asset_tasks_available);
+	jobs_add(asset_task_run, task, asset_task_lane(task));
 }
 
 ///////////////////////////////////////////
@@ -608,58 +718,15 @@ int32_t assets_calculate_current_priority() {
 		if (result > asset_active_tasks[i]->priority)
 			result = asset_active_tasks[i]->priority;
 	}
-	if (asset_thread_tasks.count > 0 && result > asset_thread_tasks[0]->priority) {
-		result = asset_thread_tasks[0]->priority;
-	}
 	return result;
 }
 
 ///////////////////////////////////////////
 
-asset_task_t* assets_acquire_task() {
-	// Pop out the task we want to work on
-	ft_mutex_lock(asset_thread_task_mtx);
-	if (asset_thread_tasks.count <= 0) { ft_mutex_unlock(asset_thread_task_mtx); return nullptr; }
-	asset_task_t* result = nullptr;
-
-	// Find a task that's ready for work
-	for (int32_t i = 0; i < asset_thread_tasks.count; i++) {
-		asset_task_t*        task   = asset_thread_tasks[i];
-		asset_load_action_t* action = &task->actions[task->action_curr];
-		if (action->thread_affinity != asset_thread_gpu || task->gpu_started == false || task->gpu_job.finished) {
-			result = task;
-			asset_thread_tasks.remove(i);
-			asset_active_tasks.add(result);
-			asset_tasks_priority = assets_calculate_current_priority();
-			break;
-		}
-	}
-	ft_mutex_unlock(asset_thread_task_mtx);
-
-	return result;
-}
-
-///////////////////////////////////////////
-
-void assets_return_task(asset_task_t *task) {
-	ft_mutex_lock(asset_thread_task_mtx);
-	asset_active_tasks.remove(asset_active_tasks.index_of(task));
-	asset_thread_tasks.insert(0, task);
-	ft_mutex_unlock(asset_thread_task_mtx);
-
-	if (asset_thread_tasks.count > 1) ft_condition_broadcast(asset_tasks_available);
-	else                              ft_condition_signal   (asset_tasks_available);
-}
-
-///////////////////////////////////////////
-
 void assets_complete_task(asset_task_t* task) {
-	// Skip putting it back if it's complete :)
-
 	ft_mutex_lock(asset_thread_task_mtx);
 	asset_active_tasks.remove(asset_active_tasks.index_of(task));
 	asset_tasks_finished   += 1;
-	asset_tasks_processing -= 1;
 	asset_tasks_priority    = assets_calculate_current_priority();
 	ft_mutex_unlock(asset_thread_task_mtx);
 
@@ -674,96 +741,81 @@ void assets_complete_task(asset_task_t* task) {
 	if (task->free_data != nullptr) task->free_data(task->asset, task->load_data);
 	assets_releaseref_threadsafe(task->asset);
 	sk_free(task);
+
+	// Decrement last, shutdown waits on this before tearing anything down.
+	atomic_decrement(&asset_tasks_processing);
 }
 
 ///////////////////////////////////////////
 
 void assets_task_set_complexity(asset_task_t *task, int32_t complexity) {
+	// Complexity is often only known once the file header is read, so this
+	// picks the lane for the remainder of the task, it's re-queued after
+	// each GPU action.
+	task->sort = asset_sort(task->priority, complexity);
 }
 
 ///////////////////////////////////////////
 
-void asset_step_task() {
-	asset_task_t* task = assets_acquire_task();
-	if (task == nullptr) return;
+void asset_task_gpu_complete(asset_job_t *job) {
+	asset_task_t *task = (asset_task_t*)job->data;
+	if (job->success == false) {
+		// On failure, send an error message, and move to the end of the
+		// action list.
+		task->asset->state = asset_state_error;
+		if (task->on_failure != nullptr) task->on_failure(task->asset, task->load_data);
+		task->action_curr = task->action_count;
+	} else {
+		// On success, move to the next action in the task!
+		task->action_curr += 1;
+	}
+	task->gpu_job = {};
 
-	asset_load_action_t* action = &task->actions[task->action_curr];
-	if (action->thread_affinity == asset_thread_asset) {
-		// Execute the asset loading action!
-		bool result = action->action(task, task->asset, task->load_data);
+	// Hand the rest of the task back to the workers
+	if (task->action_curr < task->action_count) jobs_add(asset_task_run, task, asset_task_lane(task));
+	else                                        assets_complete_task(task);
+}
 
-		if (result == false) {
-			// On failure, send an error message, and move to the end
-			// of the action list.
-			if (task->on_failure != nullptr) task->on_failure(task->asset, task->load_data);
-			task->action_curr = task->action_count;
-		}
-		else {
-			// On success, move to the next action in the task!
-			task->action_curr += 1;
-		}
-	} else if (action->thread_affinity == asset_thread_gpu) {
-		if (task->gpu_started == false) {
-			task->gpu_started = true;
-
-			// Set up a job for the GPU thread
-			task->gpu_job.data = task;
-			task->gpu_job.asset_job = [](void* data) {
-				asset_task_t* task = (asset_task_t*)data;
-				asset_load_action_t* action = &task->actions[task->action_curr];
-				bool result = action->action(task, task->asset, task->load_data);
+///////////////////////////////////////////
+
+void asset_task_run(void *task_ptr) {
+	profiler_zone("Asset Task");
+	asset_task_t *task = (asset_task_t*)task_ptr;
+
+	while (task->action_curr < task->action_count) {
+		asset_load_action_t* action = &task->actions[task->action_curr];
 
-				return (bool32_t)result;
+		if (action->thread_affinity == asset_thread_gpu) {
+			// Set up a job for the GPU thread, it'll pick the task back up
+			// when it's done, so this job ends here.
+			task->gpu_job = {};
+			task->gpu_job.data        = task;
+			task->gpu_job.on_complete = asset_task_gpu_complete;
+			task->gpu_job.asset_job   = [](void* data) {
+				asset_task_t*        task   = (asset_task_t*)data;
+				asset_load_action_t* action = &task->actions[task->action_curr];
+				return (bool32_t)action->action(task, task->asset, task->load_data);
 			};
 
-			// Add the job to the list
 			ft_mutex_lock(assets_job_lock);
 			assets_gpu_jobs.add(&task->gpu_job);
 			ft_mutex_unlock(assets_job_lock);
-		} else if (task->gpu_job.finished) {
-			if (task->gpu_job.success == false) {
-				// On failure, send an error message, and move to
-				// the end of the action list.
-				task->asset->state = asset_state_error;
-				if (task->on_failure != nullptr) task->on_failure(task->asset, task->load_data);
-				task->action_curr = task->action_count;
-			}
-			else {
-				// On success, move to the next action in the task!
-				task->action_curr += 1;
-			}
-			task->gpu_job = {};
-			task->gpu_started = false;
+			return;
 		}
-	}
-
-	// Put it back in when we're done!
-	if (task->action_curr < task->action_count) {
-		assets_return_task(task);
-	} else {
-		assets_complete_task(task);
-	}
-}
-
-///////////////////////////////////////////
 
-int32_t asset_thread(void *thread_inst_obj) {
-	asset_thread_t* thread = (asset_thread_t*)thread_inst_obj;
-	thread->id      = ft_id_current();
-	thread->running = true;
-
-	ft_mutex_t wait_mtx = ft_mutex_create();
-
-	while (asset_thread_enabled || asset_thread_tasks.count>0) {
-		asset_step_task();
-
-		if (asset_thread_enabled && asset_thread_tasks.count == 0)
-			ft_condition_wait(asset_tasks_available, wait_mtx);
+		// Execute the asset loading action!
+		if (action->action(task, task->asset, task->load_data) == false) {
+			// On failure, send an error message, and move to the end
+			// of the action list.
+			if (task->on_failure != nullptr) task->on_failure(task->asset, task->load_data);
+			task->action_curr = task->action_count;
+		} else {
+			// On success, move to the next action in the task!
+			task->action_curr += 1;
+		}
 	}
 
-	ft_mutex_destroy(&wait_mtx);
-	thread->running = false;
-	return 0;
+	assets_complete_task(task);
 }
 
 ///////////////////////////////////////////
@@ -775,13 +827,9 @@ void assets_block_until(asset_header_t *asset, asset_state_ state) {
 	if (asset->state >= state || asset->state <= asset_state_none)
 		return;
 
-	ft_id_t curr_id = ft_id_current();
-	for (int32_t i = 0; i < asset_threads.count; i++)
-	{
-		if (ft_id_equal(curr_id, asset_threads[i].id)) {
-			log_err("assets_block_ should not be called on the assets thread!");
-			return;
-		}
+	if (jobs_is_worker()) {
+		log_err("assets_block_ should not be called on the assets thread!");
+		return;
 	}
 
 	while (asset->state < state && asset->state >= 0) {
@@ -794,13 +842,9 @@ void assets_block_until(asset_header_t *asset, asset_state_ state) {
 ///////////////////////////////////////////
 
 void assets_block_for_priority(int32_t priority) {
-	ft_id_t curr_id = ft_id_current();
-	for (int32_t i = 0; i < asset_threads.count; i++)
-	{
-		if (ft_id_equal(curr_id, asset_threads[i].id)) {
-			log_err("assets_block_ should not be called on the assets thread!");
-			return;
-		}
+	if (jobs_is_worker()) {
+		log_err("assets_block_ should not be called on the assets thread!");
+		return;
 	}
 
 	// This handles if the user passes in INT_MAX
@@ -19,6 +19,8 @@ struct asset_job_t {
 	bool32_t  success;
 	void     *data;
 	bool32_t(*asset_job)(void *data);
+	// Optional, called on the main thread right after asset_job runs.
+	void    (*on_complete)(asset_job_t *job);
 };
 
 typedef enum asset_thread_ {
@@ -44,7 +46,6 @@ struct asset_task_t {
 	int32_t              priority;
 	int64_t              sort;
 	asset_job_t          gpu_job;
-	bool32_t             gpu_started;
 };
 
 void *assets_find          (const char *id, asset_type_ type);
@@ -69,7 +70,7 @@ void  assets_on_load_remove(asset_header_t *asset, void (*on_load)(asset_header_
 // ensure it is run on the GPU thread.
 bool32_t assets_execute_gpu        (bool32_t (*asset_job)(void *data), void *data);
 void     assets_add_task           (asset_task_t task);
-void     assets_task_set_complexity(asset_task_t *task, int32_t priority);
+void     assets_task_set_complexity(asset_task_t *task, int32_t complexity);
 void     assets_block_until        (asset_header_t *asset, asset_state_ state);
 
 inline int64_t asset_sort(int32_t priority, int32_t complexity) { return ((int64_t)priority << 32) | ((int64_t)complexity); }
@@ -7,6 +7,9 @@
 #include "../rect_atlas.h"
 #include "../platforms/platform.h"
 #include "../sk_memory.h"
+#include "../systems/jobs.h"
+#include "../systems/profiler.h"
+#include "../libraries/atomic_util.h"
 
 #include <stdio.h>
 #define __STDC_FORMAT_MACROS
@@ -24,6 +27,18 @@ typedef struct font_source_t {
 	float          char_height;
 } font_source_t;
 
+// A glyph's pixels, rasterized on a worker thread into its own buffer so
+// the atlas can keep growing on the main thread in the meantime. The source
+// info is copied in, since the font_sources array can move.
+struct font_tile_t {
+	stbtt_fontinfo   info;
+	float            scale;
+	int32_t          glyph_idx;
+	int32_t          x, y, w, h;
+	uint8_t         *pixels;
+	volatile int32_t done;
+};
+
 array_t<font_t>        font_list       = {};
 array_t<font_source_t> font_sources    = {};
 const int32_t          font_resolution = 64;
@@ -32,11 +47,11 @@ const int32_t          font_resolution = 64;
 
 font_glyph_t font_find_glyph    (font_t font, char32_t character);
 font_char_t  font_place_glyph   (font_t font, font_glyph_t glyph);
-void         font_render_glyph  (font_t font, font_glyph_t glyph, const font_char_t *ch);
+void         font_render_tile   (void *tile);
 int32_t      font_add_character (font_t font, char32_t character);
 void         font_upsize_texture(font_t font);
 void         font_update_texture(font_t font);
-void         font_update_cache  (font_t font);
+void         font_update_cache  (font_t font, bool wait);
 
 int32_t      font_source_add     (const char *filename);
 int32_t      font_source_add_data(const char *name, const void *data, size_t data_size);
@@ -151,7 +166,8 @@ bool font_setup(font_t font) {
 
 	for (char32_t i = 65; i < 128; i++) font_add_character(font, i);
 	for (char32_t i = 32; i < 65;  i++) font_add_character(font, i);
-	font_update_cache(font);
+	// The basic characters need to be there before anyone draws with this.
+	font_update_cache(font, true);
 
 	// Get information about character sizes for this font
 	font_source_t *src = &font_sources[font->font_ids[0]];
@@ -260,6 +276,14 @@ void font_release(font_t font) {
 ///////////////////////////////////////////
 
 void font_destroy(font_t font) {
+	// Tiles still being rasterized reference the font source data
+	jobs_wait(&font->tile_jobs, job_priority_normal);
+	for (int32_t i = 0; i < font->tiles_pending.count; i++) {
+		sk_free(font->tiles_pending[i]->pixels);
+		sk_free(font->tiles_pending[i]);
+	}
+	font->tiles_pending.free();
+
 	int32_t idx = font_list.index_of(font);
 	if (idx >= 0)
 		font_list.remove(idx);
@@ -343,13 +367,10 @@ font_char_t font_place_glyph(font_t font, font_glyph_t glyph) {
 
 ///////////////////////////////////////////
 
-void font_render_glyph(font_t font, font_glyph_t glyph, const font_char_t *ch) {
+void font_render_tile(void *data) {
+	profiler_zone("Font Rasterize");
+	font_tile_t  *tile        = (font_tile_t *)data;
 	const int32_t pad_content = PAD_SIZE;
-	int32_t x = (int32_t)(ch->u0 * font->atlas.w + 0.5f)-pad_content;
-	int32_t y = (int32_t)(ch->v0 * font->atlas.h + 0.5f)-pad_content;
-	int32_t w = (int32_t)((ch->u1 * font->atlas.w) - x - 0.5f);
-	int32_t h = (int32_t)((ch->v1 * font->atlas.h) - y - 0.5f);
-	font_source_t *source = &font_sources[glyph.font];
 
 	stbtt__bitmap gbm;
 
@@ -358,7 +379,7 @@ void font_render_glyph(font_t font, font_glyph_t glyph, const font_char_t *ch) {
 	int ix0, iy0;
 	const int32_t multisample = 1;
 	int width, height;
-	gbm.pixels = stbtt_GetGlyphSDF(&source->info, source->scale, glyph.idx, pad_content, 128, 10, &width, &height, &ix0, &iy0);
+	gbm.pixels = stbtt_GetGlyphSDF(&tile->info, tile->scale, tile->glyph_idx, pad_content, 128, 10, &width, &height, &ix0, &iy0);
 	gbm.w      = width;
 	gbm.h      = height;
 	gbm.stride = gbm.w;
@@ -372,22 +393,22 @@ void font_render_glyph(font_t font, font_glyph_t glyph, const font_char_t *ch) {
 	const int32_t multisample = 3;
 
 	stbtt_vertex* vertices;
-	int num_verts = stbtt_GetGlyphShape(&source->info, glyph.idx, &vertices);
-	stbtt_GetGlyphBitmapBoxSubpixel(&source->info, glyph.idx, source->scale * multisample, source->scale * multisample, 0, 0, &ix0, &iy0, &ix1, &iy1);
+	int num_verts = stbtt_GetGlyphShape(&tile->info, tile->glyph_idx, &vertices);
+	stbtt_GetGlyphBitmapBoxSubpixel(&tile->info, tile->glyph_idx, tile->scale * multisample, tile->scale * multisample, 0, 0, &ix0, &iy0, &ix1, &iy1);
 	// now we get the size
-	gbm.w      = w*multisample;
-	gbm.h      = h*multisample;
+	gbm.w      = tile->w*multisample;
+	gbm.h      = tile->h*multisample;
 	gbm.pixels = (unsigned char *)sk_malloc(gbm.w * gbm.h);
 	gbm.stride = gbm.w;
-	stbtt_Rasterize(&gbm, 0.35f, vertices, num_verts, source->scale*multisample, source->scale*multisample, 0, 0, ix0, iy0, 1, nullptr);
+	stbtt_Rasterize(&gbm, 0.35f, vertices, num_verts, tile->scale*multisample, tile->scale*multisample, 0, 0, ix0, iy0, 1, nullptr);
 	sk_free(vertices);
 #endif
 
 	// Now average the multisamples to get a final value, and add it to the
-	// atlas data.
-	for (int32_t py = 0; py < gbm.h; py+=multisample) {
-		int32_t yoff = (y + py/multisample) * font->atlas.w;
-	for (int32_t px = 0; px < gbm.w; px+=multisample) {
+	// tile.
+	for (int32_t py = 0; py < gbm.h && py/multisample < tile->h; py+=multisample) {
+		int32_t yoff = (py/multisample) * tile->w;
+	for (int32_t px = 0; px < gbm.w && px/multisample < tile->w; px+=multisample) {
 		int32_t total = 0;
 		for (int32_t oy = 0; oy < multisample; oy+=1) {
 			int32_t oyoff = (py+oy) * gbm.w;
@@ -396,9 +417,12 @@ void font_render_glyph(font_t font, font_glyph_t glyph, const font_char_t *ch) {
 		}}
 		total = total / (multisample*multisample);
 
-		font->atlas_data[(x + px/multisample) + yoff] = (uint8_t)total;
+		tile->pixels[px/multisample + yoff] = (uint8_t)total;
 	}}
 	sk_free(gbm.pixels);
+
+	atomic_barrier();
+	tile->done = true;
 }
 
 ///////////////////////////////////////////
@@ -458,6 +482,7 @@ void font_upsize_texture(font_t font) {
 	font->atlas_data = new_data;
 	font->atlas.w = new_w;
 	font->atlas.h = new_h;
+	font->uv_generation += 1;
 }
 
 ///////////////////////////////////////////
@@ -524,21 +549,63 @@ const font_char_t *font_get_glyph(font_t font, char32_t character) {
 
 ///////////////////////////////////////////
 
-void font_update_cache(font_t font) {
+void font_update_cache(font_t font, bool wait) {
+	// Send new glyphs off to be rasterized. Their spot in the atlas is
+	// already reserved and blank, so they just draw as empty until their
+	// tile lands. Pixel positions don't move when the atlas grows, so they
+	// can be worked out now.
+	const int32_t pad_content = PAD_SIZE;
 	for (int32_t i = 0; i < font->update_queue.count; i++) {
-		font_render_glyph(font, font->update_queue[i], font->glyph_map.get(font->update_queue[i]));
+		font_glyph_t       glyph = font->update_queue[i];
+		const font_char_t *ch    = font->glyph_map.get(glyph);
+		int32_t            x     = (int32_t)(ch->u0 * font->atlas.w + 0.5f)-pad_content;
+		int32_t            y     = (int32_t)(ch->v0 * font->atlas.h + 0.5f)-pad_content;
+		int32_t            w     = (int32_t)((ch->u1 * font->atlas.w) - x - 0.5f);
+		int32_t            h     = (int32_t)((ch->v1 * font->atlas.h) - y - 0.5f);
+		if (w <= 0 || h <= 0) continue; // Whitespace and missing glyphs
+
+		font_tile_t *tile = sk_malloc_t(font_tile_t, 1);
+		*tile = {};
+		tile->info      = font_sources[glyph.font].info;
+		tile->scale     = font_sources[glyph.font].scale;
+		tile->glyph_idx = glyph.idx;
+		tile->x         = x;
+		tile->y         = y;
+		tile->w         = w;
+		tile->h         = h;
+		tile->pixels    = sk_malloc_t(uint8_t, tile->w * tile->h);
+		memset(tile->pixels, 0, tile->w * tile->h);
+		font->tiles_pending.add(tile);
+		jobs_add(font_render_tile, tile, job_priority_normal, &font->tile_jobs);
 	}
-	if (font->update_queue.count > 0) {
-		font_update_texture(font);
-		font->update_queue.clear();
+	font->update_queue.clear();
+
+	if (wait)
+		jobs_wait(&font->tile_jobs, job_priority_normal);
+
+	// Copy any finished tiles into the atlas, and upload once for all of them
+	bool dirty = font->font_tex == nullptr;
+	for (int32_t i = font->tiles_pending.count - 1; i >= 0; i--) {
+		font_tile_t *tile = font->tiles_pending[i];
+		if (!tile->done) continue;
+
+		for (int32_t y = 0; y < tile->h; y++)
+			memcpy(&font->atlas_data[tile->x + (tile->y + y) * font->atlas.w], &tile->pixels[y * tile->w], tile->w);
+		sk_free(tile->pixels);
+		sk_free(tile);
+		font->tiles_pending.remove(i);
+		dirty = true;
 	}
+	if (dirty)
+		font_update_texture(font);
 }
 
 ///////////////////////////////////////////
 
 void font_update_fonts() {
+	profiler_zone("Font Update");
 	for (int32_t i = 0; i < font_list.count; i++) {
-		font_update_cache(font_list[i]);
+		font_update_cache(font_list[i], false);
 	}
 }
 
@@ -3,6 +3,7 @@
 #include "../stereokit.h"
 #include "../libraries/array.h"
 #include "../rect_atlas.h"
+#include "../systems/jobs.h"
 #include "assets.h"
 
 namespace sk {
@@ -18,6 +19,8 @@ struct font_glyph_t {
 	int32_t font;
 };
 
+struct font_tile_t;
+
 struct _font_t {
 	asset_header_t header;
 	tex_t       font_tex;
@@ -30,10 +33,13 @@ struct _font_t {
 	hashmap_t<font_glyph_t, font_char_t> glyph_map;
 	hashmap_t<char32_t,     font_char_t> character_map;
 	array_t  <font_glyph_t>              update_queue;
+	array_t  <font_tile_t*>              tiles_pending; // Glyphs being rasterized on worker threads
+	job_counter_t                        tile_jobs;
 	array_t  <int32_t>                   font_ids;
 
 	rect_atlas_t   atlas;
 	uint8_t       *atlas_data;
+	uint32_t       uv_generation; // Bumped whenever the atlas grows and glyph UVs move
 };
 
 font_t font_create_default();
@@ -13,11 +13,13 @@
 namespace sk {
 
 _material_buffer_t material_buffers[14] = {};
+uint32_t           material_sort_changes = 0;
 
 ///////////////////////////////////////////
 
 void material_copy_pipeline(material_t dest, const material_t src);
 void material_update_label (material_t material);
+void material_sort_changed (material_t material);
 
 ///////////////////////////////////////////
 
@@ -301,6 +303,7 @@ void material_set_transparency(material_t material, transparency_ mode) {
 	material->alpha_mode = mode;
 	skg_pipeline_set_transparency(&material->pipeline, (skg_transparency_)mode);
 	material_update_label(material);
+	material_sort_changed(material);
 }
 
 ///////////////////////////////////////////
@@ -339,6 +342,7 @@ void material_set_depth_write(material_t material, bool32_t write_enabled) {
 
 void material_set_queue_offset(material_t material, int32_t offset) {
 	material->queue_offset = offset;
+	material_sort_changed(material);
 }
 
 ///////////////////////////////////////////
@@ -352,6 +356,14 @@ void material_set_chain(material_t material, material_t chain_material) {
 	if (chain_material ) material_addref (chain_material);
 	if (material->chain) material_release(material->chain);
 	material->chain = chain_material;
+	material_sort_changed(material);
+}
+
+///////////////////////////////////////////
+
+void material_sort_changed(material_t material) {
+	material->sort_generation += 1;
+	material_sort_changes     += 1;
 }
 
 ///////////////////////////////////////////
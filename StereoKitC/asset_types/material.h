@@ -34,6 +34,7 @@ struct _material_t {
 	int32_t           queue_offset;
 	skg_pipeline_t    pipeline;
 	material_t        chain;
+	uint32_t          sort_generation; // Bumped when the render sort key or chain changes
 };
 
 struct _material_buffer_t {
@@ -47,5 +48,8 @@ void   material_check_tex_changes(material_t material);
 size_t material_param_size       (material_param_ type);
 
 extern _material_buffer_t material_buffers[14];
+// Bumped along with any material's sort_generation, so render lists can
+// cheaply tell when none of them have changed.
+extern uint32_t           material_sort_changes;
 
 } // namespace sk
\ No newline at end of file
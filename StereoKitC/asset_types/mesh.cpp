@@ -4,6 +4,11 @@
 #include "../sk_math_dx.h"
 #include "mesh.h"
 #include "assets.h"
+#include "../libraries/atomic_util.h"
+#include "../libraries/ferr_thread.h"
+#include "../platforms/platform.h"
+#include "../systems/render.h"
+#include "../systems/jobs.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -16,7 +21,9 @@ using namespace DirectX;
 
 namespace sk {
 
-void mesh_update_label(mesh_t mesh);
+void mesh_update_label        (mesh_t mesh);
+void mesh_collision_invalidate(mesh_t mesh);
+void mesh_bvh_queue_build     (mesh_t mesh);
 
 ///////////////////////////////////////////
 
@@ -28,6 +35,15 @@ void mesh_set_keep_data(mesh_t mesh, bool32_t keep_data) {
 
 	mesh->discard_data = !keep_data;
 	if (mesh->discard_data) {
+		// Collision data borrows the vertex and index data, so if it's in
+		// use, it takes ownership instead of losing it.
+		mesh_collision_t &coll = mesh->collision_data;
+		if (coll.verts != nullptr && coll.owned_verts == nullptr) {
+			coll.owned_verts = mesh->verts;
+			coll.owned_inds  = mesh->inds;
+			mesh->verts = nullptr;
+			mesh->inds  = nullptr;
+		}
 		sk_free(mesh->verts);
 		sk_free(mesh->inds );
 	}
@@ -44,6 +60,7 @@ bool32_t mesh_get_keep_data(mesh_t mesh) {
 void _mesh_set_verts(mesh_t mesh, const vert_t *vertices, uint32_t vertex_count, bool32_t calculate_bounds, bool update_original) {
 	// Keep track of vertex data for use on CPU side
 	if (!mesh->discard_data && update_original) {
+		mesh_collision_invalidate(mesh);
 		if (mesh->vert_capacity < vertex_count)
 			mesh->verts = sk_realloc_t(vert_t, mesh->verts, vertex_count);
 		memcpy(mesh->verts, vertices, sizeof(vert_t) * vertex_count);
@@ -74,6 +91,7 @@ void _mesh_set_verts(mesh_t mesh, const vert_t *vertices, uint32_t vertex_count,
 		// buffer, just copy things over!
 		skg_buffer_set_contents(&mesh->vert_buffer, vertices, sizeof(vert_t)*vertex_count);
 	}
+	render_stats_add_mesh_upload((int64_t)sizeof(vert_t) * vertex_count);
 
 	mesh->vert_count = vertex_count;
 
@@ -130,6 +148,7 @@ void _mesh_set_inds (mesh_t mesh, const vind_t *indices, uint32_t index_count) {
 
 	// Keep track of index data for use on CPU side
 	if (!mesh->discard_data) {
+		mesh_collision_invalidate(mesh);
 		if (mesh->ind_capacity < index_count)
 			mesh->inds = sk_realloc_t(vind_t, mesh->inds, index_count);
 		memcpy(mesh->inds, indices, sizeof(vind_t) * index_count);
@@ -160,6 +179,7 @@ void _mesh_set_inds (mesh_t mesh, const vind_t *indices, uint32_t index_count) {
 		// buffer, just copy things over!
 		skg_buffer_set_contents(&mesh->ind_buffer, indices, sizeof(vind_t) * index_count);
 	}
+	render_stats_add_mesh_upload((int64_t)sizeof(vind_t) * index_count);
 
 	mesh->ind_count = index_count;
 	mesh->ind_draw  = index_count;
@@ -185,6 +205,27 @@ void mesh_set_inds(mesh_t mesh, const vind_t *indices,  int32_t index_count) {
 
 ///////////////////////////////////////////
 
+void mesh_borrow_inds(mesh_t mesh, mesh_t source) {
+	struct ind_borrow_job_t {
+		mesh_t mesh;
+		mesh_t source;
+	};
+	ind_borrow_job_t job_data = {mesh, source};
+
+	assets_execute_gpu([](void *data) {
+		ind_borrow_job_t *job_data = (ind_borrow_job_t *)data;
+		// The borrowing mesh never creates an index buffer of its own, so
+		// there's nothing here to clean up.
+		skg_mesh_set_inds(&job_data->mesh->gpu_mesh, &job_data->source->ind_buffer);
+		job_data->mesh->ind_count = job_data->source->ind_count;
+		job_data->mesh->ind_draw  = job_data->source->ind_count;
+		
+		return (bool32_t)true;
+	}, &job_data);
+}
+
+///////////////////////////////////////////
+
 void mesh_set_data(mesh_t mesh, const vert_t *vertices, int32_t vertex_count, const vind_t *indices, int32_t index_count, bool32_t calculate_bounds) {
 	struct mesh_upload_job_t {
 		mesh_t        mesh;
@@ -374,6 +415,10 @@ bool _mesh_set_skin(mesh_t mesh, const bone_weight_t *bone_weights, uint32_t bon
 		return false;
 	}
 
+	// GPU skinned instances will rebuild this from the new weights
+	if (skg_buffer_is_valid(&mesh->skin_weight_buffer))
+		skg_buffer_destroy(&mesh->skin_weight_buffer);
+
 	mesh->skin_data.bone_data      = sk_malloc_t(bone_weight_t, bone_weight_count);
 	mesh->skin_data.deformed_verts = sk_malloc_t(vert_t,        mesh->vert_count);
 	memcpy(mesh->skin_data.deformed_verts, mesh->verts, sizeof(vert_t) * mesh->vert_count);
@@ -417,57 +462,277 @@ void mesh_set_skin_inv(mesh_t mesh, const bone_weight_t* bone_weights, uint32_t
 ///////////////////////////////////////////
 
 void mesh_update_skin(mesh_t mesh, const matrix *bone_transforms, int32_t bone_count) {
+	struct skin_split_t {
+		mesh_t  mesh;
+		int32_t vert_count;
+		vec3   *bounds; // min/max pairs, one per job
+	};
+
+	mesh_skin_prepare(mesh, bone_transforms, bone_count);
+
+	// Same split as the animation system uses, small meshes aren't worth
+	// waking the workers for.
+	int32_t vert_count = (int32_t)mesh->vert_count;
+	int32_t job_count  = (vert_count + mesh_skin_job_size - 1) / mesh_skin_job_size;
+	if (job_count < 2) {
+		vec3 min, max;
+		mesh_skin_range(mesh, 0, vert_count, &min, &max);
+		mesh_skin_apply(mesh, min, max);
+		return;
+	}
+
+	skin_split_t split = { mesh, vert_count, sk_malloc_t(vec3, job_count * 2) };
+	jobs_parallel_for(job_count, 1, [](int32_t start, int32_t end, void *data) {
+		skin_split_t *split = (skin_split_t *)data;
+		for (int32_t j = start; j < end; j++) {
+			mesh_skin_range(split->mesh,
+				j * mesh_skin_job_size,
+				mini((j + 1) * mesh_skin_job_size, split->vert_count),
+				&split->bounds[j*2], &split->bounds[j*2+1]);
+		}
+	}, &split);
+
+	vec3 min = split.bounds[0];
+	vec3 max = split.bounds[1];
+	for (int32_t j = 1; j < job_count; j++) {
+		vec3 job_max = split.bounds[j*2+1];
+		min = vec3_min(min, split.bounds[j*2]);
+		max = { fmaxf(max.x, job_max.x), fmaxf(max.y, job_max.y), fmaxf(max.z, job_max.z) };
+	}
+	sk_free(split.bounds);
+	mesh_skin_apply(mesh, min, max);
+}
+
+///////////////////////////////////////////
+
+void mesh_skin_prepare(mesh_t mesh, const matrix *bone_transforms, int32_t bone_count) {
 	for (int32_t i = 0; i < bone_count; i++) {
 		mesh->skin_data.bone_transforms[i] = mesh->skin_data.bone_inverse_transforms[i] * bone_transforms[i];
 	}
+}
 
-	XMVECTOR max = g_XMFltMin;
-	XMVECTOR min = g_XMFltMax;
-	for (uint32_t i = 0; i < mesh->vert_count; i++) {
-		XMVECTOR pos  = XMLoadFloat3((XMFLOAT3 *)&mesh->verts[i].pos);
-		XMVECTOR norm = XMLoadFloat3((XMFLOAT3 *)&mesh->verts[i].norm);
-		XMVECTOR new_pos, new_norm;
+///////////////////////////////////////////
 
-		const bone_weight_t *bone = &mesh->skin_data.bone_data[i];
+inline XMMATRIX mesh_skin_blend(const matrix *bones, const bone_weight_t *bone) {
+	// Blending the bone matrices first and then transforming once is the same
+	// math as transforming by each bone and blending the results, but it's
+	// far fewer instructions per vertex.
+	XMVECTOR w      = XMVectorReplicate(bone->weight[0] * (1 / 255.0f));
+	XMMATRIX b      = XMLoadFloat4x4((XMFLOAT4X4*)&bones[bone->bone_id[0]]);
+	XMMATRIX result;
+	result.r[0] = XMVectorMultiply(b.r[0], w);
+	result.r[1] = XMVectorMultiply(b.r[1], w);
+	result.r[2] = XMVectorMultiply(b.r[2], w);
+	result.r[3] = XMVectorMultiply(b.r[3], w);
+	for (int32_t i = 1; i < 4; i++) {
+		if (bone->weight[i] == 0) continue;
+		w = XMVectorReplicate(bone->weight[i] * (1 / 255.0f));
+		b = XMLoadFloat4x4((XMFLOAT4X4*)&bones[bone->bone_id[i]]);
+		result.r[0] = XMVectorMultiplyAdd(b.r[0], w, result.r[0]);
+		result.r[1] = XMVectorMultiplyAdd(b.r[1], w, result.r[1]);
+		result.r[2] = XMVectorMultiplyAdd(b.r[2], w, result.r[2]);
+		result.r[3] = XMVectorMultiplyAdd(b.r[3], w, result.r[3]);
+	}
+	return result;
+}
 
-		{
-			float w = bone->weight[0] / 255.0f;
-			XMMATRIX xm0 = XMLoadFloat4x4((XMFLOAT4X4*)&mesh->skin_data.bone_transforms[bone->bone_id[0]]);
-			new_pos      =             XMVectorScale(XMVector3Transform      (pos,  xm0), w);
-			new_norm     =             XMVectorScale(XMVector3TransformNormal(norm, xm0), w);
+///////////////////////////////////////////
+
+// Accumulates one bone influence for a batch of 4 verts into a blended
+// matrix stored as structure of arrays. m[r*3+c] holds element [r][c] of
+// each vert's matrix, one vert per lane. The last column isn't needed for
+// transforming positions and normals, so it's dropped.
+inline void mesh_skin_blend4(const matrix *bones, const bone_weight_t *b, int32_t influence, XMVECTOR *m, bool first) {
+	XMVECTOR w = XMVectorScale(XMVectorSet(
+		b[0].weight[influence], b[1].weight[influence],
+		b[2].weight[influence], b[3].weight[influence]), 1 / 255.0f);
+	XMMATRIX b0 = XMLoadFloat4x4((XMFLOAT4X4*)&bones[b[0].bone_id[influence]]);
+	XMMATRIX b1 = XMLoadFloat4x4((XMFLOAT4X4*)&bones[b[1].bone_id[influence]]);
+	XMMATRIX b2 = XMLoadFloat4x4((XMFLOAT4X4*)&bones[b[2].bone_id[influence]]);
+	XMMATRIX b3 = XMLoadFloat4x4((XMFLOAT4X4*)&bones[b[3].bone_id[influence]]);
+	for (int32_t r = 0; r < 4; r++) {
+		// Row r from each of the 4 matrices, transposed so each vector is
+		// one element across all 4 verts.
+		XMMATRIX soa = XMMatrixTranspose(XMMATRIX(b0.r[r], b1.r[r], b2.r[r], b3.r[r]));
+		for (int32_t c = 0; c < 3; c++) {
+			m[r*3+c] = first
+				? XMVectorMultiply   (soa.r[c], w)
+				: XMVectorMultiplyAdd(soa.r[c], w, m[r*3+c]);
 		}
-		if (bone->weight[1] != 0) {
-			float w = bone->weight[1] / 255.0f;
-			XMMATRIX xm1 = XMLoadFloat4x4((XMFLOAT4X4*)&mesh->skin_data.bone_transforms[bone->bone_id[1]]);
-			new_pos      = XMVectorAdd(XMVectorScale(XMVector3Transform      (pos,  xm1), w), new_pos);
-			new_norm     = XMVectorAdd(XMVectorScale(XMVector3TransformNormal(norm, xm1), w), new_norm);
+	}
+}
+
+///////////////////////////////////////////
+
+void mesh_skin_range(mesh_t mesh, int32_t start, int32_t end, vec3 *out_min, vec3 *out_max) {
+	const matrix        *bones = mesh->skin_data.bone_transforms;
+	const bone_weight_t *data  = mesh->skin_data.bone_data;
+	const vert_t        *src   = mesh->verts;
+	vert_t              *dst   = mesh->skin_data.deformed_verts;
+
+	XMVECTOR max = g_XMFltMin;
+	XMVECTOR min = g_XMFltMax;
+	int32_t  i   = start;
+
+	// Work in batches of 4 verts, one per SIMD lane. Positions, normals and
+	// the blended bone matrices are all transposed into xxxx/yyyy/zzzz form,
+	// so every vector op blends or transforms 4 verts at once. Rigid
+	// sections of a mesh (hard surface props, heads, etc.) are bound to a
+	// single bone, so influences that are zero across the whole batch are
+	// skipped.
+	for (; i + 4 <= end; i += 4) {
+		const bone_weight_t *b = &data[i];
+
+		XMVECTOR m[12];
+		mesh_skin_blend4(bones, b, 0, m, true);
+		for (int32_t k = 1; k < 4; k++) {
+			if ((b[0].weight[k] | b[1].weight[k] | b[2].weight[k] | b[3].weight[k]) == 0) continue;
+			mesh_skin_blend4(bones, b, k, m, false);
 		}
-		if (bone->weight[2] != 0) {
-			float w = bone->weight[2] / 255.0f;
-			XMMATRIX xm2 = XMLoadFloat4x4((XMFLOAT4X4*)&mesh->skin_data.bone_transforms[bone->bone_id[2]]);
-			new_pos      = XMVectorAdd(XMVectorScale(XMVector3Transform      (pos,  xm2), w), new_pos);
-			new_norm     = XMVectorAdd(XMVectorScale(XMVector3TransformNormal(norm, xm2), w), new_norm);
+
+		XMMATRIX pos = XMMatrixTranspose(XMMATRIX(
+			XMLoadFloat3((XMFLOAT3*)&src[i  ].pos), XMLoadFloat3((XMFLOAT3*)&src[i+1].pos),
+			XMLoadFloat3((XMFLOAT3*)&src[i+2].pos), XMLoadFloat3((XMFLOAT3*)&src[i+3].pos)));
+		XMMATRIX norm = XMMatrixTranspose(XMMATRIX(
+			XMLoadFloat3((XMFLOAT3*)&src[i  ].norm), XMLoadFloat3((XMFLOAT3*)&src[i+1].norm),
+			XMLoadFloat3((XMFLOAT3*)&src[i+2].norm), XMLoadFloat3((XMFLOAT3*)&src[i+3].norm)));
+
+		// Row vector convention, out[c] = x*m[0][c] + y*m[1][c] + z*m[2][c],
+		// plus m[3][c] for positions.
+		XMVECTOR out_pos [4];
+		XMVECTOR out_norm[4];
+		for (int32_t c = 0; c < 3; c++) {
+			out_pos[c] = XMVectorMultiplyAdd(pos.r[0], m[c],
+			             XMVectorMultiplyAdd(pos.r[1], m[3+c],
+			             XMVectorMultiplyAdd(pos.r[2], m[6+c], m[9+c])));
+			out_norm[c] = XMVectorMultiplyAdd(norm.r[0], m[c],
+			              XMVectorMultiplyAdd(norm.r[1], m[3+c],
+			              XMVectorMultiply   (norm.r[2], m[6+c])));
 		}
-		if (bone->weight[3] != 0) {
-			float w = bone->weight[3] / 255.0f;
-			XMMATRIX xm3 = XMLoadFloat4x4((XMFLOAT4X4*)&mesh->skin_data.bone_transforms[bone->bone_id[3]]);
-			new_pos      = XMVectorAdd(XMVectorScale(XMVector3Transform      (pos,  xm3), w), new_pos);
-			new_norm     = XMVectorAdd(XMVectorScale(XMVector3TransformNormal(norm, xm3), w), new_norm);
+		out_pos [3] = XMVectorZero();
+		out_norm[3] = XMVectorZero();
+		XMMATRIX aos_pos  = XMMatrixTranspose(XMMATRIX(out_pos [0], out_pos [1], out_pos [2], out_pos [3]));
+		XMMATRIX aos_norm = XMMatrixTranspose(XMMATRIX(out_norm[0], out_norm[1], out_norm[2], out_norm[3]));
+		for (int32_t v = 0; v < 4; v++) {
+			XMStoreFloat3((XMFLOAT3*)&dst[i+v].pos,  aos_pos .r[v]);
+			XMStoreFloat3((XMFLOAT3*)&dst[i+v].norm, aos_norm.r[v]);
+			min = XMVectorMin(min, aos_pos.r[v]);
+			max = XMVectorMax(max, aos_pos.r[v]);
 		}
-		XMStoreFloat3((XMFLOAT3 *)&mesh->skin_data.deformed_verts[i].pos,  new_pos );
-		XMStoreFloat3((XMFLOAT3 *)&mesh->skin_data.deformed_verts[i].norm, new_norm);
-		min = XMVectorMin(min, new_pos);
-		max = XMVectorMax(max, new_pos);
 	}
-	XMVECTOR center     = XMVectorMultiplyAdd(min, g_XMOneHalf, XMVectorMultiply(max, g_XMOneHalf));
-	XMVECTOR dimensions = XMVectorSubtract(max, min);
-	mesh->bounds.center     = math_fast_to_vec3(center);
-	mesh->bounds.dimensions = math_fast_to_vec3(dimensions);
+	// Leftover verts that didn't fit in a batch
+	for (; i < end; i++) {
+		XMMATRIX xm   = mesh_skin_blend(bones, &data[i]);
+		XMVECTOR pos  = XMVector3Transform      (XMLoadFloat3((XMFLOAT3*)&src[i].pos ), xm);
+		XMVECTOR norm = XMVector3TransformNormal(XMLoadFloat3((XMFLOAT3*)&src[i].norm), xm);
+		XMStoreFloat3((XMFLOAT3*)&dst[i].pos,  pos );
+		XMStoreFloat3((XMFLOAT3*)&dst[i].norm, norm);
+		min = XMVectorMin(min, pos);
+		max = XMVectorMax(max, pos);
+	}
+	*out_min = math_fast_to_vec3(min);
+	*out_max = math_fast_to_vec3(max);
+}
+
+///////////////////////////////////////////
+
+void mesh_skin_apply(mesh_t mesh, vec3 min, vec3 max) {
+	mesh->bounds.center     = (min + max) * 0.5f;
+	mesh->bounds.dimensions = max - min;
 	_mesh_set_verts(mesh, mesh->skin_data.deformed_verts, mesh->vert_count, false, false);
 }
 
 ///////////////////////////////////////////
 
+void mesh_skin_gpu_weights(mesh_t source) {
+	if (skg_buffer_is_valid(&source->skin_weight_buffer)) return;
+
+	// The weights are packed 16 bytes per vert so the shader can fetch them
+	// by vertex id: xy hold 4 16-bit bone ids, z holds 4 8-bit weights.
+	uint32_t *packed = sk_malloc_t(uint32_t, source->vert_count * 4);
+	for (uint32_t i = 0; i < source->vert_count; i++) {
+		const bone_weight_t *b = &source->skin_data.bone_data[i];
+		packed[i*4 + 0] = (uint32_t)b->bone_id[0] | ((uint32_t)b->bone_id[1] << 16);
+		packed[i*4 + 1] = (uint32_t)b->bone_id[2] | ((uint32_t)b->bone_id[3] << 16);
+		packed[i*4 + 2] = (uint32_t)b->weight[0] | ((uint32_t)b->weight[1] << 8) | ((uint32_t)b->weight[2] << 16) | ((uint32_t)b->weight[3] << 24);
+		packed[i*4 + 3] = 0;
+	}
+	source->skin_weight_buffer = skg_buffer_create(packed, source->vert_count, sizeof(uint32_t) * 4, skg_buffer_type_compute, (skg_use_)(skg_use_static | skg_use_compute_read));
+	render_stats_add_mesh_upload((int64_t)sizeof(uint32_t) * 4 * source->vert_count);
+	sk_free(packed);
+}
+
+///////////////////////////////////////////
+
+mesh_t mesh_skin_gpu_instance(mesh_t source) {
+	if (!mesh_has_skin(source)) {
+		log_err("mesh_skin_gpu_instance: source mesh has no skin!");
+		return nullptr;
+	}
+	mesh_skin_gpu_weights(source);
+
+	mesh_t result = (mesh_t)assets_allocate(asset_type_mesh);
+	result->skin_source  = source;
+	result->gpu_mesh     = source->gpu_mesh;
+	result->vert_count   = source->vert_count;
+	result->ind_count    = source->ind_count;
+	result->ind_draw     = source->ind_draw;
+	result->bounds       = source->bounds;
+	result->discard_data = true;
+	mesh_addref(source);
+
+	int32_t bone_count = source->skin_data.bone_count;
+	result->skin_data.bone_count              = bone_count;
+	result->skin_data.bone_transforms         = sk_malloc_t(matrix, bone_count);
+	result->skin_data.bone_inverse_transforms = sk_malloc_t(matrix, bone_count);
+	result->skin_data.bone_palette            = sk_malloc_t(matrix, bone_count);
+	memcpy(result->skin_data.bone_inverse_transforms, source->skin_data.bone_inverse_transforms, sizeof(matrix) * bone_count);
+	result->skin_bone_buffer = skg_buffer_create(nullptr, bone_count, sizeof(matrix), skg_buffer_type_compute, (skg_use_)(skg_use_dynamic | skg_use_compute_read));
+
+	return result;
+}
+
+///////////////////////////////////////////
+
+void mesh_skin_gpu_apply(mesh_t instance) {
+	// The source's buffers may have been recreated since last frame, so
+	// pick up its current state rather than trusting our copy.
+	mesh_t source = instance->skin_source;
+	mesh_skin_gpu_weights(source);
+	instance->gpu_mesh   = source->gpu_mesh;
+	instance->vert_count = source->vert_count;
+	instance->ind_count  = source->ind_count;
+	instance->ind_draw   = source->ind_draw;
+
+	int32_t   bone_count = instance->skin_data.bone_count;
+	bounds_t  src_bounds = source->bounds;
+	matrix   *palette    = instance->skin_data.bone_palette;
+
+	// Every skinned vert is a weighted average of that vert moved by each of
+	// its bones, so it can't leave the combined box of the source bounds
+	// moved by each bone.
+	vec3 min = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+	vec3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (int32_t i = 0; i < bone_count; i++) {
+		palette[i] = matrix_transpose(instance->skin_data.bone_transforms[i]);
+
+		bounds_t b = bounds_transform(src_bounds, instance->skin_data.bone_transforms[i]);
+		vec3     b_min = b.center - b.dimensions * 0.5f;
+		vec3     b_max = b.center + b.dimensions * 0.5f;
+		min = vec3_min(min, b_min);
+		max = { fmaxf(max.x, b_max.x), fmaxf(max.y, b_max.y), fmaxf(max.z, b_max.z) };
+	}
+	skg_buffer_set_contents(&instance->skin_bone_buffer, palette, sizeof(matrix) * bone_count);
+	render_stats_add_mesh_upload((int64_t)sizeof(matrix) * bone_count);
+
+	if (bone_count > 0) {
+		instance->bounds.center     = (min + max) * 0.5f;
+		instance->bounds.dimensions = max - min;
+	}
+}
+
+///////////////////////////////////////////
+
 mesh_t mesh_find(const char *id) {
 	mesh_t result = (mesh_t)assets_find(id, asset_type_mesh);
 	if (result != nullptr) {
@@ -524,9 +789,12 @@ mesh_t mesh_copy(mesh_t mesh) {
 	}
 
 	mesh_t result = (mesh_t)assets_allocate(asset_type_mesh);
-	result->bounds       = mesh->bounds;
-	result->discard_data = mesh->discard_data;
-	result->ind_draw     = mesh->ind_draw;
+	result->bounds           = mesh->bounds;
+	result->unbounded        = mesh->unbounded;
+	result->discard_data     = mesh->discard_data;
+	result->ind_draw         = mesh->ind_draw;
+	result->bvh_async        = mesh->bvh_async;
+	result->collision_planes = mesh->collision_planes;
 
 	if (mesh->discard_data) {
 		log_err("mesh_copy not yet implemented for meshes with discard data set!");
@@ -543,35 +811,138 @@ mesh_t mesh_copy(mesh_t mesh) {
 ///////////////////////////////////////////
 
 const mesh_collision_t *mesh_get_collision_data(mesh_t mesh) {
-	if (mesh->collision_data.pts != nullptr)
+	if (mesh->skin_source != nullptr)
+		return mesh_get_collision_data(mesh->skin_source);
+	if (mesh->collision_data.verts != nullptr)
 		return &mesh->collision_data;
-	if (mesh->discard_data)
+	if (mesh->discard_data || mesh->verts == nullptr || mesh->inds == nullptr)
 		return nullptr;
 
 	mesh_collision_t &coll = mesh->collision_data;
-	coll.pts    = sk_malloc_t(vec3   , mesh->ind_count);
-	coll.planes = sk_malloc_t(plane_t, mesh->ind_count/3);
-
-	for (uint32_t i = 0; i < mesh->ind_count; i++) coll.pts[i] = mesh->verts[mesh->inds[i]].pos;
+	coll.inds      = mesh->inds;
+	coll.ind_count = mesh->ind_count;
+
+	if (mesh->collision_planes) {
+		mesh_collision_plane_t *planes = sk_malloc_t(mesh_collision_plane_t, mesh->ind_count/3);
+		for (uint32_t i = 0; i < mesh->ind_count; i += 3) {
+			vec3    p0    = mesh->verts[mesh->inds[i  ]].pos;
+			vec3    p1    = mesh->verts[mesh->inds[i+1]].pos;
+			vec3    p2    = mesh->verts[mesh->inds[i+2]].pos;
+			plane_t plane = mesh_collision_plane_calc(p0, p1, p2);
+
+			// Octahedron encode the normal
+			vec3  n   = plane.normal;
+			float sum = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+			vec2  oct = sum > 0 ? vec2{ n.x / sum, n.y / sum } : vec2{ 0, 0 };
+			if (n.z < 0) {
+				vec2 wrapped = {
+					(1 - fabsf(oct.y)) * (oct.x >= 0 ? 1 : -1),
+					(1 - fabsf(oct.x)) * (oct.y >= 0 ? 1 : -1) };
+				oct = wrapped;
+			}
+			mesh_collision_plane_t *dest = &planes[i/3];
+			dest->normal_oct[0] = (int16_t)roundf(fmaxf(-1, fminf(1, oct.x)) * 32767.0f);
+			dest->normal_oct[1] = (int16_t)roundf(fmaxf(-1, fminf(1, oct.y)) * 32767.0f);
 
-	for (uint32_t i = 0; i < mesh->ind_count; i += 3) {
-		vec3    dir1   = coll.pts[i+1] - coll.pts[i];
-		vec3    dir2   = coll.pts[i+1] - coll.pts[i+2];
-		vec3    normal = vec3_normalize( vec3_cross(dir2, dir1) );
-		plane_t plane  = { normal, -vec3_dot(coll.pts[i + 1], normal) };
-		coll.planes[i/3] = plane;
+			// Recalculate d from the quantized normal, so the plane still
+			// passes through the triangle.
+			dest->d = -vec3_dot(p1, mesh_collision_normal_decode(dest->normal_oct));
+		}
+		coll.planes = planes;
 	}
 
+	// verts goes last, it's what marks the collision data as ready
+	coll.verts = mesh->verts;
 	return &mesh->collision_data;
 }
 
 ///////////////////////////////////////////
 
+void mesh_collision_invalidate(mesh_t mesh) {
+	mesh_collision_t &coll = mesh->collision_data;
+	if (coll.verts == nullptr || coll.owned_verts != nullptr)
+		return;
+
+	// An async BVH build is reading the collision data, so it has to finish
+	// before the data underneath it can change.
+	while (mesh->bvh_building) {
+		if (!jobs_execute_one(job_priority_low))
+			ft_yield();
+	}
+	if (mesh->bvh_data) {
+		mesh_bvh_destroy(mesh->bvh_data);
+		mesh->bvh_data = nullptr;
+	}
+	mesh->bvh_failed = false;
+	sk_free(coll.planes);
+	coll = {};
+}
+
+///////////////////////////////////////////
+
+bool32_t mesh_bvh_build_action(asset_task_t *, asset_header_t *asset, void *) {
+	mesh_t      mesh = (mesh_t)asset;
+	mesh_bvh_t *bvh  = mesh_bvh_create(mesh, 16, false, job_priority_normal);
+
+	// Make sure the finished BVH is visible before anyone can see the pointer,
+	// and the pointer is visible before anyone sees the build as done.
+	atomic_barrier();
+	mesh->bvh_data   = bvh;
+	mesh->bvh_failed = bvh == nullptr;
+	atomic_barrier();
+	mesh->bvh_building = false;
+	return bvh != nullptr;
+}
+
+///////////////////////////////////////////
+
+void mesh_bvh_queue_build(mesh_t mesh) {
+	if (mesh->bvh_data != nullptr || mesh->bvh_building || mesh->bvh_failed || mesh->ind_count == 0)
+		return;
+
+	// Collision data is lazily created, so do it here while we're still on
+	// the calling thread.
+	if (mesh_get_collision_data(mesh) == nullptr)
+		return;
+
+	static const asset_load_action_t actions[] = {
+		asset_load_action_t {mesh_bvh_build_action, asset_thread_asset},
+	};
+	asset_task_t task = {};
+	task.asset        = &mesh->header;
+	task.actions      = (asset_load_action_t *)actions;
+	task.action_count = _countof(actions);
+	task.priority     = 10;
+	task.sort         = asset_sort(task.priority, (int32_t)mesh->ind_count);
+
+	mesh->bvh_building = true;
+	assets_add_task(task);
+}
+
+///////////////////////////////////////////
+
 const mesh_bvh_t *mesh_get_bvh_data(mesh_t mesh) {
+	if (mesh->skin_source != nullptr)
+		return mesh_get_bvh_data(mesh->skin_source);
+	const mesh_bvh_t *bvh = mesh->bvh_data;
+	if (bvh != nullptr)
+		return bvh;
+	if (mesh->discard_data && mesh->collision_data.verts == nullptr)
+		return nullptr;
+	if (mesh->bvh_building || mesh->ind_count == 0)
+		return nullptr;
+
+	// An async build may have finished since bvh_data was read above.
+	atomic_barrier();
 	if (mesh->bvh_data != nullptr)
 		return mesh->bvh_data;
-	if (mesh->discard_data)
+	if (mesh->bvh_failed)
+		return nullptr;
+
+	if (mesh->bvh_async) {
+		mesh_bvh_queue_build(mesh);
 		return nullptr;
+	}
 
 	mesh->bvh_data = mesh_bvh_create(mesh, 16);
 
@@ -580,6 +951,39 @@ const mesh_bvh_t *mesh_get_bvh_data(mesh_t mesh) {
 
 ///////////////////////////////////////////
 
+void mesh_set_bvh_async(mesh_t mesh, bool32_t async) {
+	mesh->bvh_async = async;
+
+	// Turning this on for a mesh that already has its data gets the build
+	// started right away, rather than on the first ray query.
+	if (async && mesh->skin_source == nullptr && !mesh->discard_data)
+		mesh_bvh_queue_build(mesh);
+}
+
+///////////////////////////////////////////
+
+bool32_t mesh_get_bvh_async(mesh_t mesh) {
+	return mesh->bvh_async;
+}
+
+///////////////////////////////////////////
+
+void mesh_set_collision_planes(mesh_t mesh, bool32_t store_planes) {
+	if (mesh->collision_planes == store_planes)
+		return;
+	mesh->collision_planes = store_planes;
+	// Rebuilt with the new setting the next time something asks for it
+	mesh_collision_invalidate(mesh);
+}
+
+///////////////////////////////////////////
+
+bool32_t mesh_get_collision_planes(mesh_t mesh) {
+	return mesh->collision_planes;
+}
+
+///////////////////////////////////////////
+
 void mesh_release(mesh_t mesh) {
 	if (mesh == nullptr)
 		return;
@@ -589,19 +993,27 @@ void mesh_release(mesh_t mesh) {
 ///////////////////////////////////////////
 
 void mesh_destroy(mesh_t mesh) {
-	skg_mesh_destroy  (&mesh->gpu_mesh);
-	skg_buffer_destroy(&mesh->vert_buffer);
-	skg_buffer_destroy(&mesh->ind_buffer);
+	// GPU skinned instances only borrow the source's mesh and buffers
+	if (mesh->skin_source == nullptr) {
+		skg_mesh_destroy  (&mesh->gpu_mesh);
+		skg_buffer_destroy(&mesh->vert_buffer);
+		skg_buffer_destroy(&mesh->ind_buffer);
+	}
+	skg_buffer_destroy(&mesh->skin_weight_buffer);
+	skg_buffer_destroy(&mesh->skin_bone_buffer);
+	mesh_release(mesh->skin_source);
 	sk_free(mesh->verts);
 	sk_free(mesh->inds);
-	sk_free(mesh->collision_data.pts   );	// XXX doesn't this fail when no colldata has been created?
-	sk_free(mesh->collision_data.planes);
 	if (mesh->bvh_data)
 		mesh_bvh_destroy(mesh->bvh_data);
+	sk_free(mesh->collision_data.planes);
+	sk_free(mesh->collision_data.owned_verts);
+	sk_free(mesh->collision_data.owned_inds);
 
 	sk_free(mesh->skin_data.bone_data);
 	sk_free(mesh->skin_data.bone_inverse_transforms);
 	sk_free(mesh->skin_data.bone_transforms);
+	sk_free(mesh->skin_data.bone_palette);
 	sk_free(mesh->skin_data.deformed_verts);
 
 	*mesh = {};
@@ -632,9 +1044,9 @@ bool32_t mesh_ray_intersect(mesh_t mesh, ray_t model_space_ray, ray_t *out_pt, u
 
 	vec3  pt = {};
 	float nearest_dist = FLT_MAX;
-	for (uint32_t i = 0; i < mesh->ind_count; i+=3) {
+	for (uint32_t i = 0; i < data->ind_count; i+=3) {
 
-		const plane_t& plane = data->planes[i / 3];
+		plane_t plane = mesh_collision_plane(data, i / 3);
 
 		float denom = vec3_dot(model_space_ray.dir, plane.normal);
 
@@ -665,9 +1077,10 @@ bool32_t mesh_ray_intersect(mesh_t mesh, ray_t model_space_ray, ray_t *out_pt, u
 		// https://blackpawn.com/texts/pointinpoly/default.html
 
 		// Compute vectors
-		vec3 v0 = data->pts[i+1] - data->pts[i];
-		vec3 v1 = data->pts[i+2] - data->pts[i];
-		vec3 v2 = pt - data->pts[i];
+		vec3 p0 = mesh_collision_pt(data, i);
+		vec3 v0 = mesh_collision_pt(data, i+1) - p0;
+		vec3 v1 = mesh_collision_pt(data, i+2) - p0;
+		vec3 v2 = pt - p0;
 
 		// Compute dot products
 		float dot00 = vec3_dot(v0, v0);
@@ -687,7 +1100,7 @@ bool32_t mesh_ray_intersect(mesh_t mesh, ray_t model_space_ray, ray_t *out_pt, u
 			if (nearest_dist > dist) {
 				nearest_dist = dist;
 				if (out_start_inds) *out_start_inds = i;
-				*out_pt = {pt, data->planes[i / 3].normal};
+				*out_pt = {pt, plane.normal};
 			}
 		}
 	}
@@ -700,18 +1113,65 @@ bool32_t mesh_ray_intersect(mesh_t mesh, ray_t model_space_ray, ray_t *out_pt, u
 bool32_t mesh_ray_intersect_bvh(mesh_t mesh, ray_t model_space_ray, ray_t *out_pt, uint32_t* out_start_inds, cull_ cull_mode) {
 	vec3 result = {};
 
-	const mesh_bvh_t *bvh = mesh_get_bvh_data(mesh);
-	if (bvh == nullptr)
-		return false;
 	if (!bounds_ray_intersect(mesh->bounds, model_space_ray, &result))
 		return false;
 
+	const mesh_bvh_t *bvh = mesh_get_bvh_data(mesh);
+	if (bvh == nullptr) {
+		// While an async BVH is still building, test every triangle instead.
+		// The build only starts once collision data exists, so that's safe.
+		mesh_t source = mesh->skin_source != nullptr ? mesh->skin_source : mesh;
+		if (source->bvh_building)
+			return mesh_ray_intersect(mesh, model_space_ray, out_pt, out_start_inds, cull_mode);
+
+		// The build may have finished between reading bvh_data and
+		// bvh_building, so look at the published pointer once more.
+		atomic_barrier();
+		bvh = source->bvh_data;
+		if (bvh == nullptr)
+			return false;
+	}
+
 	return mesh_bvh_intersect(bvh, model_space_ray, out_pt, out_start_inds, cull_mode);
 }
 
 ///////////////////////////////////////////
 
+int32_t mesh_ray_intersect_bvh_batch(mesh_t mesh, const ray_t *in_arr_model_space_rays, int32_t ray_count, ray_t *out_arr_hits, bool32_t *out_arr_hit_results, cull_ cull_mode) {
+	struct ray_batch_t {
+		mesh_t           mesh;
+		const ray_t     *rays;
+		ray_t           *hits;
+		bool32_t        *results;
+		cull_            cull_mode;
+		volatile int32_t hit_count;
+	};
+	if (mesh == nullptr || ray_count <= 0)
+		return 0;
+
+	// The BVH and collision data are lazily created, and that has to happen
+	// here before any workers start reading them.
+	mesh_get_bvh_data(mesh);
+
+	ray_batch_t batch = { mesh, in_arr_model_space_rays, out_arr_hits, out_arr_hit_results, cull_mode, 0 };
+	jobs_parallel_for(ray_count, 32, [](int32_t start, int32_t end, void *data) {
+		ray_batch_t *batch = (ray_batch_t *)data;
+		for (int32_t i = start; i < end; i++) {
+			bool32_t hit = mesh_ray_intersect_bvh(batch->mesh, batch->rays[i], &batch->hits[i], nullptr, batch->cull_mode);
+			if (batch->results) batch->results[i] = hit;
+			if (hit) atomic_increment(&batch->hit_count);
+			else     batch->hits[i] = {};
+		}
+	}, &batch);
+
+	return batch.hit_count;
+}
+
+///////////////////////////////////////////
+
 bool32_t mesh_get_triangle(mesh_t mesh, uint32_t triangle_index, vert_t* a, vert_t* b, vert_t* c) {
+	if (mesh->skin_source != nullptr)
+		return mesh_get_triangle(mesh->skin_source, triangle_index, a, b, c);
 	if (mesh->discard_data) {
 		log_err("mesh_get_triangle: can't work with a mesh that doesn't keep data, ensure mesh_get_keep_data() is true");
 		return false;
@@ -15,6 +15,7 @@ struct mesh_weights_t {
 	bone_weight_t *bone_data;
 	matrix   *bone_inverse_transforms;
 	matrix   *bone_transforms;
+	matrix   *bone_palette;   // Upload scratch for GPU skinned instances
 	vert_t   *deformed_verts;
 	int32_t   bone_count;
 };
@@ -32,14 +33,49 @@ struct _mesh_t {
 	uint32_t         ind_draw;
 	skg_mesh_t       gpu_mesh;
 	bounds_t         bounds;
+	bool32_t         unbounded; // Shader displaces verts past bounds, so don't frustum cull
 	bool32_t         discard_data;
 	vert_t*          verts;
 	vind_t*          inds;
 	mesh_collision_t collision_data;
-	mesh_bvh_t*      bvh_data;
+	mesh_bvh_t* volatile bvh_data;
+	bool32_t         bvh_async;    // Build the BVH on an asset thread instead of blocking the first query
+	volatile bool32_t bvh_building; // An async BVH build is in flight, bvh_data is published when done
+	bool32_t         bvh_failed;   // The last async build came back empty, don't retry until the data changes
+	bool32_t         collision_planes; // Store quantized triangle planes with the collision data, rather than computing them per query
 	mesh_weights_t   skin_data;
+	skg_buffer_t     skin_weight_buffer; // Packed bone ids/weights for GPU skinning, lives on the source mesh
+	skg_buffer_t     skin_bone_buffer;   // Bone palette, lives on a GPU skinned instance
+	mesh_t           skin_source;        // GPU skinned instances borrow this mesh's buffers
 };
 
 void mesh_destroy(mesh_t mesh);
 
+// Lazily builds the BVH unless it's async, in which case this may return
+// nullptr until the asset thread finishes it.
+const mesh_bvh_t *mesh_get_bvh_data(mesh_t mesh);
+
+// Points a mesh at another mesh's index buffer instead of its own, so batches
+// with the same index pattern can share one. This has to be called again if
+// the source's index buffer is ever replaced by a larger one.
+void mesh_borrow_inds(mesh_t mesh, mesh_t source);
+
+// Skinning is split into steps so the vertex work can be spread across
+// threads. Prepare and apply must be called from the main thread, range may be
+// called from any thread on non-overlapping vertex ranges.
+//
+// Verts per skinning job. Small enough to balance across the workers, large
+// enough that taking a job is cheap next to the work inside it.
+const int32_t mesh_skin_job_size = 2048;
+
+void mesh_skin_prepare(mesh_t mesh, const matrix *bone_transforms, int32_t bone_count);
+void mesh_skin_range  (mesh_t mesh, int32_t start, int32_t end, vec3 *out_min, vec3 *out_max);
+void mesh_skin_apply  (mesh_t mesh, vec3 min, vec3 max);
+
+// GPU skinned instances share the vertex and index buffers of a skinned
+// source mesh, and only upload a bone palette each frame. Call prepare before
+// gpu_apply.
+mesh_t mesh_skin_gpu_instance(mesh_t source);
+void   mesh_skin_gpu_apply   (mesh_t instance);
+
 } // namespace sk
\ No newline at end of file
@@ -4,9 +4,25 @@
 
 namespace sk {
 
+// A triangle plane with its normal octahedron encoded into two snorm16s,
+// 8 bytes instead of plane_t's 16.
+struct mesh_collision_plane_t {
+	int16_t normal_oct[2];
+	float   d;
+};
+
+// Collision data indexes straight into the mesh's own vertex and index data
+// rather than keeping an unshared copy of every triangle. Planes are only
+// stored when the mesh asks for them, otherwise they're computed on the fly.
 struct mesh_collision_t {
-	vec3*    pts;
-	plane_t* planes;
+	const vert_t           *verts;
+	const vind_t           *inds;
+	uint32_t                ind_count;
+	mesh_collision_plane_t *planes;
+	// When a mesh discards its data after collision was created, ownership
+	// of the vertex and index data moves here.
+	vert_t                 *owned_verts;
+	vind_t                 *owned_inds;
 };
 
 struct bone_weight_t {
@@ -19,4 +35,44 @@ void                    mesh_calculate_normals (      vert_t *verts, int32_t ver
 bounds_t                mesh_calculate_bounds  (const vert_t *verts, int32_t vert_count);
 void                    mesh_set_skin_inv      (mesh_t mesh, const bone_weight_t* bone_weights, uint32_t bone_weight_count, const matrix* bone_resting_transforms_inverted, int32_t bone_count);
 
-} // namespace sk
\ No newline at end of file
+///////////////////////////////////////////
+
+inline vec3 mesh_collision_pt(const mesh_collision_t *coll, uint32_t ind) {
+	return coll->verts[coll->inds[ind]].pos;
+}
+
+///////////////////////////////////////////
+
+inline plane_t mesh_collision_plane_calc(vec3 p0, vec3 p1, vec3 p2) {
+	vec3 normal = vec3_normalize( vec3_cross(p1 - p2, p1 - p0) );
+	return { normal, -vec3_dot(p1, normal) };
+}
+
+///////////////////////////////////////////
+
+inline vec3 mesh_collision_normal_decode(const int16_t oct[2]) {
+	vec3 n = {
+		oct[0] / 32767.0f,
+		oct[1] / 32767.0f, 0 };
+	n.z = 1 - fabsf(n.x) - fabsf(n.y);
+	if (n.z < 0) {
+		float x = n.x;
+		n.x = (1 - fabsf(n.y)) * (x   >= 0 ? 1 : -1);
+		n.y = (1 - fabsf(x  )) * (n.y >= 0 ? 1 : -1);
+	}
+	return vec3_normalize(n);
+}
+
+///////////////////////////////////////////
+
+inline plane_t mesh_collision_plane(const mesh_collision_t *coll, uint32_t tri) {
+	if (coll->planes == nullptr) {
+		uint32_t i = tri * 3;
+		return mesh_collision_plane_calc(mesh_collision_pt(coll, i), mesh_collision_pt(coll, i+1), mesh_collision_pt(coll, i+2));
+	}
+
+	const mesh_collision_plane_t *p = &coll->planes[tri];
+	return { mesh_collision_normal_decode(p->normal_oct), p->d };
+}
+
+} // namespace sk
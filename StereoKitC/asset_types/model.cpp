@@ -6,6 +6,7 @@
 #include "model.h"
 #include "mesh.h"
 #include "../libraries/stref.h"
+#include "../libraries/atomic_util.h"
 #include "../platforms/platform.h"
 
 using namespace DirectX;
@@ -81,9 +82,15 @@ model_t model_copy(model_t model) {
 			vis->mesh = model->anim_inst.skinned_meshes[i].original_mesh;
 			mesh_addref (vis->mesh);
 			mesh_release(old_mesh);
+
+			material_t old_material = vis->material;
+			vis->material = model->anim_inst.skinned_meshes[i].original_material;
+			material_addref (vis->material);
+			material_release(old_material);
 		}
 	}
-	result->anim_data = anim_data_copy(&model->anim_data);
+	result->anim_data    = anim_data_copy(&model->anim_data);
+	result->gpu_skinning = model->gpu_skinning;
 
 	return result;
 }
@@ -285,7 +292,8 @@ void model_set_mesh(model_t model, int32_t subset, mesh_t mesh) {
 		(asset_header_t**)&model->visuals[subset].mesh,
 		(asset_header_t* )mesh);
 
-	model->bounds_dirty = true;
+	model->bounds_dirty    = true;
+	model->ray_accel.valid = false;
 }
 
 ///////////////////////////////////////////
@@ -328,6 +336,7 @@ void model_remove_subset(model_t model, int32_t subset) {
 	mesh_release    (model->visuals[subset].mesh);
 	material_release(model->visuals[subset].material);
 	model->visuals.remove(subset);
+	model->ray_accel.valid = false;
 
 	for (int32_t i = 0; i < model->nodes.count; i++) {
 		if (model->nodes[i].visual > subset)
@@ -379,56 +388,209 @@ bounds_t model_get_bounds(model_t model) {
 
 ///////////////////////////////////////////
 
-bool32_t model_ray_intersect(model_t model, ray_t model_space_ray, ray_t *out_pt, cull_ cull_mode) {
-	*out_pt = {};
+void model_ray_item_bound(model_t model, model_ray_item_t *item) {
+	const model_node_t *n      = &model->nodes[item->node];
+	bounds_t            bounds = bounds_transform(mesh_get_bounds(model->visuals[n->visual].mesh), n->transform_model);
+	item->inverse = matrix_invert(n->transform_model);
+	item->bbox    = { bounds.center - bounds.dimensions / 2, bounds.center + bounds.dimensions / 2 };
+}
 
-	vec3 bounds_at;
-	if (!bounds_ray_intersect(model->bounds, model_space_ray, &bounds_at))
-		return false;
+///////////////////////////////////////////
 
-	float closest = FLT_MAX;
-	for (int32_t i = 0; i < model->nodes.count; i++) {
-		const model_node_t *n = &model->nodes[i];
-		if (!n->solid || n->visual == -1 || model->visuals[n->visual].mesh == nullptr)
-			continue;
+void model_ray_node_bound(model_ray_accel_t *accel, int32_t node_id) {
+	model_ray_node_t *node = &accel->nodes[node_id];
+	if (node->count == 0) {
+		node->bbox = bbox_combine(accel->nodes[node->first].bbox, accel->nodes[node->first+1].bbox);
+		return;
+	}
+	node->bbox = accel->items[node->first].bbox;
+	for (int32_t i = node->first+1; i < node->first + node->count; i++)
+		node->bbox = bbox_combine(node->bbox, accel->items[i].bbox);
+}
 
-		matrix inverse   = matrix_invert(n->transform_model);
-		ray_t  local_ray = matrix_transform_ray(inverse, model_space_ray);
-		ray_t  at;
-		if (mesh_ray_intersect(model->visuals[n->visual].mesh, local_ray, &at, nullptr, cull_mode)) {
-			float d = vec3_distance_sq(local_ray.pos, at.pos);
-			if (closest > d) {
-				closest = d;
-				*out_pt = matrix_transform_ray(n->transform_model, at);
+///////////////////////////////////////////
+
+// Midpoint splits can make arbitrarily deep trees when items are unevenly
+// spread out. Past this depth the builder only uses median splits, which
+// halve the item count each level, so the tree can never be deeper than
+// this plus 31, and traversal fits in MODEL_RAY_STACK_SIZE.
+#define MODEL_RAY_MIDPOINT_DEPTH 24
+#define MODEL_RAY_STACK_SIZE     64
+
+inline float model_ray_item_center(const model_ray_item_t *item, int axis) {
+	vec3 center = bbox_center(item->bbox);
+	return (&center.x)[axis];
+}
+
+///////////////////////////////////////////
+
+// Partially sorts items along the axis, so the nth item is in its sorted
+// position, with smaller items before it and larger ones after.
+void model_ray_items_select(model_ray_item_t *items, int32_t count, int32_t nth, int axis) {
+	int32_t lo = 0;
+	int32_t hi = count - 1;
+	while (lo < hi) {
+		float   pivot = model_ray_item_center(&items[lo + (hi - lo) / 2], axis);
+		int32_t i     = lo;
+		int32_t j     = hi;
+		while (i <= j) {
+			while (model_ray_item_center(&items[i], axis) < pivot) i++;
+			while (model_ray_item_center(&items[j], axis) > pivot) j--;
+			if (i <= j) {
+				model_ray_item_t tmp = items[i];
+				items[i++] = items[j];
+				items[j--] = tmp;
 			}
 		}
+		if      (nth <= j) hi = j;
+		else if (nth >= i) lo = i;
+		else               break;
 	}
-	return closest != FLT_MAX;
 }
 
 ///////////////////////////////////////////
 
-bool32_t model_ray_intersect_bvh(model_t model, ray_t model_space_ray, ray_t *out_pt, cull_ cull_mode) {
-	*out_pt = {};
+void model_ray_node_build(model_ray_accel_t *accel, int32_t node_id, int32_t first, int32_t count, int32_t depth) {
+	const int32_t leaf_size = 4;
+
+	accel->nodes[node_id].first = first;
+	accel->nodes[node_id].count = count;
+	model_ray_node_bound(accel, node_id);
+	if (count <= leaf_size)
+		return;
+
+	// Split at the middle of the longest axis of the item centers, and fall
+	// back to a median split if everything lands on one side, or if the
+	// tree is getting too deep.
+	boundingbox centers;
+	bbox_clear(centers);
+	for (int32_t i = first; i < first + count; i++)
+		bbox_update(centers, bbox_center(accel->items[i].bbox));
+	vec3  size = bbox_size(centers);
+	int   axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+	vec3  mid  = bbox_center(centers);
+
+	int32_t split = first;
+	if (depth < MODEL_RAY_MIDPOINT_DEPTH) {
+		for (int32_t i = first; i < first + count; i++) {
+			if (model_ray_item_center(&accel->items[i], axis) < (&mid.x)[axis]) {
+				model_ray_item_t tmp  = accel->items[i];
+				accel->items[i]       = accel->items[split];
+				accel->items[split++] = tmp;
+			}
+		}
+	}
+	if (split == first || split == first + count) {
+		model_ray_items_select(&accel->items[first], count, count / 2, axis);
+		split = first + count / 2;
+	}
+
+	int32_t left = accel->nodes.count;
+	accel->nodes.add({});
+	accel->nodes.add({});
+	accel->nodes[node_id].first = left;
+	accel->nodes[node_id].count = 0;
+	model_ray_node_build(accel, left,   first, split - first,         depth + 1);
+	model_ray_node_build(accel, left+1, split, first + count - split, depth + 1);
+	model_ray_node_bound(accel, node_id);
+}
+
+///////////////////////////////////////////
 
+void model_ray_accel_update(model_t model) {
+	model_ray_accel_t *accel = &model->ray_accel;
+
+	if (!accel->valid) {
+		accel->items.clear();
+		accel->nodes.clear();
+		for (int32_t i = 0; i < model->nodes.count; i++) {
+			const model_node_t *n = &model->nodes[i];
+			if (!n->solid || n->visual == -1 || model->visuals[n->visual].mesh == nullptr)
+				continue;
+			model_ray_item_t item = {};
+			item.node = i;
+			model_ray_item_bound(model, &item);
+			accel->items.add(item);
+		}
+		if (accel->items.count > 0) {
+			accel->nodes.add({});
+			model_ray_node_build(accel, 0, 0, accel->items.count, 0);
+		}
+		accel->valid = true;
+		accel->refit = false;
+	} else if (accel->refit) {
+		// Children are always added after their parents, so walking the
+		// nodes backwards bounds every child before its parent.
+		for (int32_t i = 0; i < accel->items.count; i++)
+			model_ray_item_bound(model, &accel->items[i]);
+		for (int32_t i = accel->nodes.count - 1; i >= 0; i--)
+			model_ray_node_bound(accel, i);
+		accel->refit = false;
+	}
+}
+
+///////////////////////////////////////////
+
+bool32_t model_ray_query(model_t model, ray_t model_space_ray, bool use_bvh, cull_ cull_mode, ray_t *out_pt, mesh_t *out_mesh, matrix *out_matrix, uint32_t *out_start_inds) {
 	vec3 bounds_at;
 	if (!bounds_ray_intersect(model->bounds, model_space_ray, &bounds_at))
 		return false;
 
-	float closest = FLT_MAX;
-	for (int32_t i = 0; i < model->nodes.count; i++) {
-		const model_node_t *n = &model->nodes[i];
-		if (!n->solid || n->visual == -1 || model->visuals[n->visual].mesh == nullptr)
+	model_ray_accel_update(model);
+	const model_ray_accel_t *accel = &model->ray_accel;
+	if (accel->nodes.count == 0)
+		return false;
+
+	// Node hits are compared by squared distance in model space, and the
+	// ray's t values convert to that with the ray direction's length.
+	bbox_ray_t bbox_ray = model_space_ray;
+	float      dir_sq   = vec3_magnitude_sq(model_space_ray.dir);
+	float      closest  = FLT_MAX;
+
+	// The builder bounds tree depth, so this can't overflow, each level
+	// pops one node and pushes two.
+	int32_t stack[MODEL_RAY_STACK_SIZE];
+	int32_t stack_top = 0;
+	stack[0] = 0;
+	while (stack_top >= 0) {
+		const model_ray_node_t *node = &accel->nodes[stack[stack_top--]];
+		float t_min, t_max;
+		if (!bbox_intersect_full(node->bbox, t_min, t_max, bbox_ray, 0, FLT_MAX))
 			continue;
+		if (t_min > 0 && t_min * t_min * dir_sq > closest)
+			continue;
+
+		if (node->count == 0) {
+			assert(stack_top + 2 < MODEL_RAY_STACK_SIZE);
+			stack[++stack_top] = node->first;
+			stack[++stack_top] = node->first + 1;
+			continue;
+		}
 
-		matrix inverse   = matrix_invert(n->transform_model);
-		ray_t  local_ray = matrix_transform_ray(inverse, model_space_ray);
-		ray_t  at;
-		if (mesh_ray_intersect_bvh(model->visuals[n->visual].mesh, local_ray, &at, nullptr, cull_mode)) {
-			float d = vec3_distance_sq(local_ray.pos, at.pos);
+		for (int32_t i = node->first; i < node->first + node->count; i++) {
+			const model_ray_item_t *item = &accel->items[i];
+			if (!bbox_intersect(item->bbox, bbox_ray, 0, FLT_MAX))
+				continue;
+
+			const model_node_t *n         = &model->nodes[item->node];
+			mesh_t              mesh      = model->visuals[n->visual].mesh;
+			ray_t               local_ray = matrix_transform_ray(item->inverse, model_space_ray);
+			ray_t               at;
+			uint32_t            local_start_inds;
+			bool32_t            hit       = use_bvh
+				? mesh_ray_intersect_bvh(mesh, local_ray, &at, &local_start_inds, cull_mode)
+				: mesh_ray_intersect    (mesh, local_ray, &at, &local_start_inds, cull_mode);
+			if (!hit)
+				continue;
+
+			ray_t model_at = matrix_transform_ray(n->transform_model, at);
+			float d        = vec3_distance_sq(model_space_ray.pos, model_at.pos);
 			if (closest > d) {
 				closest = d;
-				*out_pt = matrix_transform_ray(n->transform_model, at);
+				*out_pt = model_at;
+				if (out_mesh      ) *out_mesh       = mesh;
+				if (out_start_inds) *out_start_inds = local_start_inds;
+				if (out_matrix    ) *out_matrix     = n->transform_model;
 			}
 		}
 	}
@@ -437,39 +599,63 @@ bool32_t model_ray_intersect_bvh(model_t model, ray_t model_space_ray, ray_t *ou
 
 ///////////////////////////////////////////
 
+bool32_t model_ray_intersect(model_t model, ray_t model_space_ray, ray_t *out_pt, cull_ cull_mode) {
+	*out_pt = {};
+	return model_ray_query(model, model_space_ray, false, cull_mode, out_pt, nullptr, nullptr, nullptr);
+}
+
+///////////////////////////////////////////
+
+bool32_t model_ray_intersect_bvh(model_t model, ray_t model_space_ray, ray_t *out_pt, cull_ cull_mode) {
+	*out_pt = {};
+	return model_ray_query(model, model_space_ray, true, cull_mode, out_pt, nullptr, nullptr, nullptr);
+}
+
+///////////////////////////////////////////
+
 // Same as model_ray_intersect_bvh, but returns mesh, mesh transform and start index if intersection found
 bool32_t model_ray_intersect_bvh_detailed(model_t model, ray_t model_space_ray, ray_t *out_pt, mesh_t *out_mesh, matrix *out_matrix, uint32_t* out_start_inds, cull_ cull_mode) {
 	*out_pt = {};
 	if (out_mesh      ) *out_mesh       = nullptr;
 	if (out_matrix    ) *out_matrix     = {};
 	if (out_start_inds) *out_start_inds = 0;
+	return model_ray_query(model, model_space_ray, true, cull_mode, out_pt, out_mesh, out_matrix, out_start_inds);
+}
 
-	vec3 bounds_at;
-	if (!bounds_ray_intersect(model->bounds, model_space_ray, &bounds_at))
-		return false;
+///////////////////////////////////////////
 
-	float closest = FLT_MAX;
-	for (int32_t i = 0; i < model->nodes.count; i++) {
-		const model_node_t *n = &model->nodes[i];
-		if (!n->solid || n->visual == -1 || model->visuals[n->visual].mesh == nullptr)
-			continue;
+int32_t model_ray_intersect_bvh_batch(model_t model, const ray_t *in_arr_model_space_rays, int32_t ray_count, ray_t *out_arr_hits, bool32_t *out_arr_hit_results, cull_ cull_mode) {
+	struct ray_batch_t {
+		model_t          model;
+		const ray_t     *rays;
+		ray_t           *hits;
+		bool32_t        *results;
+		cull_            cull_mode;
+		volatile int32_t hit_count;
+	};
+	if (model == nullptr || ray_count <= 0)
+		return 0;
 
-		matrix   inverse   = matrix_invert(n->transform_model);
-		ray_t    local_ray = matrix_transform_ray(inverse, model_space_ray);
-		ray_t    at;
-		uint32_t local_start_inds;
-		if (mesh_ray_intersect_bvh(model->visuals[n->visual].mesh, local_ray, &at, &local_start_inds, cull_mode)) {
-			float d = vec3_distance_sq(local_ray.pos, at.pos);
-			if (closest > d) {
-				closest = d;
-				if (out_mesh      ) *out_mesh       = model->visuals[n->visual].mesh;
-				if (out_start_inds) *out_start_inds = local_start_inds;
-				if (out_matrix    ) *out_matrix     = n->transform_model;
-				*out_pt = matrix_transform_ray(n->transform_model, at);
-			}
-		}
+	// Everything the queries lazily create has to exist before any workers
+	// start reading it.
+	model_ray_accel_update(model);
+	for (int32_t i = 0; i < model->ray_accel.items.count; i++) {
+		const model_node_t *n = &model->nodes[model->ray_accel.items[i].node];
+		mesh_get_bvh_data(model->visuals[n->visual].mesh);
 	}
-	return closest != FLT_MAX;
+
+	ray_batch_t batch = { model, in_arr_model_space_rays, out_arr_hits, out_arr_hit_results, cull_mode, 0 };
+	jobs_parallel_for(ray_count, 32, [](int32_t start, int32_t end, void *data) {
+		ray_batch_t *batch = (ray_batch_t *)data;
+		for (int32_t i = start; i < end; i++) {
+			batch->hits[i] = {};
+			bool32_t hit = model_ray_query(batch->model, batch->rays[i], true, batch->cull_mode, &batch->hits[i], nullptr, nullptr, nullptr);
+			if (batch->results) batch->results[i] = hit;
+			if (hit) atomic_increment(&batch->hit_count);
+		}
+	}, &batch);
+
+	return batch.hit_count;
 }
 
 ///////////////////////////////////////////
@@ -487,6 +673,8 @@ void model_destroy(model_t model) {
 	}
 	model->nodes  .free();
 	model->visuals.free();
+	model->ray_accel.items.free();
+	model->ray_accel.nodes.free();
 	*model = {};
 }
 
@@ -555,6 +743,7 @@ model_node_id model_node_add_child(model_t model, model_node_id parent, const ch
 	}
 
 	model->nodes.add(node);
+	model->ray_accel.valid = false;
 	return node_id;
 }
 
@@ -716,6 +905,7 @@ void model_node_set_name(model_t model, model_node_id node, const char* name) {
 
 void model_node_set_solid(model_t model, model_node_id node, bool32_t solid) {
 	model->nodes[node].solid = solid;
+	model->ray_accel.valid   = false;
 }
 
 ///////////////////////////////////////////
@@ -755,7 +945,8 @@ void model_node_set_mesh(model_t model, model_node_id node, mesh_t mesh) {
 	}
 	mesh_t prev_mesh = model->visuals[vis].mesh;
 	model->visuals[vis].mesh = mesh;
-	model->bounds_dirty = true;
+	model->bounds_dirty      = true;
+	model->ray_accel.valid   = false;
 	if (mesh)
 		mesh_addref(mesh);
 	mesh_release(prev_mesh);
@@ -777,6 +968,7 @@ void _model_node_update_transforms(model_t model, model_node_id node) {
 		_model_node_update_transforms(model, curr);
 		curr = model->nodes[curr].sibling;
 	}
+	model->ray_accel.refit = true;
 }
 
 ///////////////////////////////////////////
@@ -800,6 +992,7 @@ void model_node_set_transform_model(model_t model, model_node_id node, matrix tr
 	}
 	model->transforms_changed = true;
 	model->bounds_dirty       = true;
+	model->ray_accel.refit    = true;
 }
 
 ///////////////////////////////////////////
@@ -885,6 +1078,13 @@ bool32_t model_node_info_iterate(model_t model, model_node_id node, int32_t* ref
 
 void model_step_anim(model_t model) {
 	anim_update_model(model);
+
+	// Render list shards never touch animation, so stepping here also has
+	// to queue up the skin, or shard-drawn models would never deform.
+	if (model->transforms_changed && model->anim_data.skeletons.count > 0) {
+		model->transforms_changed = false;
+		anim_update_skin(model);
+	}
 }
 
 ///////////////////////////////////////////
@@ -988,4 +1188,20 @@ float model_anim_get_duration(model_t model, int32_t index) {
 	return model->anim_data.anims[index].duration;
 }
 
+///////////////////////////////////////////
+
+void model_set_gpu_skinning(model_t model, bool32_t gpu_skinning) {
+	if (model->gpu_skinning == gpu_skinning) return;
+	model->gpu_skinning = gpu_skinning;
+
+	// Skinned meshes get rebuilt for the new mode on the next update
+	anim_inst_reset_skin(model);
+}
+
+///////////////////////////////////////////
+
+bool32_t model_get_gpu_skinning(model_t model) {
+	return model->gpu_skinning;
+}
+
 } // namespace sk
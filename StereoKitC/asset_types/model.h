@@ -2,6 +2,7 @@
 
 #include "../stereokit.h"
 #include "../libraries/array.h"
+#include "../systems/bbox.h"
 #include "assets.h"
 #include "animation.h"
 
@@ -27,6 +28,30 @@ struct model_node_t {
 	dictionary_t<char*> info;
 };
 
+// Cached per solid node for ray queries, so rays don't need to invert each
+// node's transform.
+struct model_ray_item_t {
+	model_node_id node;
+	boundingbox   bbox;
+	matrix        inverse;
+};
+
+struct model_ray_node_t {
+	boundingbox bbox;
+	int32_t     first; // Leaves: first item. Branches: left child, right is first+1
+	int32_t     count; // 0 for branches
+};
+
+// A BVH over the model space bounds of every solid node, so ray queries on
+// models with many nodes only visit the nodes the ray can actually hit.
+// Structural changes rebuild it, transform changes just refit it.
+struct model_ray_accel_t {
+	array_t<model_ray_item_t> items;
+	array_t<model_ray_node_t> nodes;
+	bool32_t                  valid;
+	bool32_t                  refit;
+};
+
 struct _model_t {
 	asset_header_t          header;
 	array_t<model_visual_t> visuals;
@@ -37,6 +62,8 @@ struct _model_t {
 	anim_inst_t             anim_inst;
 	bounds_t                bounds;
 	bool32_t                bounds_dirty;
+	bool32_t                gpu_skinning;
+	model_ray_accel_t       ray_accel;
 };
 
 bool modelfmt_obj (model_t model, const char *filename, const void *file_data, size_t file_size, shader_t shader);
@@ -45,4 +72,8 @@ bool modelfmt_stl (model_t model, const char *filename, const void *file_data, s
 bool modelfmt_ply (model_t model, const char *filename, const void *file_data, size_t file_size, shader_t shader);
 void model_destroy(model_t model);
 
+// Brings the ray acceleration structure up to date. Ray queries do this
+// lazily, but it must be called before querying from multiple threads.
+void model_ray_accel_update(model_t model);
+
 } // namespace sk
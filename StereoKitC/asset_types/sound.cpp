@@ -5,7 +5,9 @@
 #include "../sk_math.h"
 #include "../platforms/platform.h"
 #include "../systems/audio.h"
+#include "../systems/audio_decode.h"
 #include "../libraries/ferr_thread.h"
+#include "../libraries/atomic_util.h"
 
 #include <string.h>
 
@@ -51,7 +53,9 @@ sound_t sound_create(const char *filename) {
 	}
 
 	result = (_sound_t*)assets_allocate(asset_type_sound);
-	result->type = sound_type_decode;
+	result->type      = sound_type_decode;
+	result->file_data = data;
+	result->file_size = length;
 	sound_set_id(result, filename);
 
 	ma_decoder_config config = ma_decoder_config_init(AU_SAMPLE_FORMAT, 1, AU_SAMPLE_RATE);
@@ -60,16 +64,24 @@ sound_t sound_create(const char *filename) {
 		assets_releaseref(&result->header);
 		return nullptr;
 	}
+
+	// Short clips get decoded up front on the asset threads, so playing them
+	// is just a copy.
+	audio_pcm_request(result);
 	return result;
 }
 
 ///////////////////////////////////////////
 
-sound_t sound_create_stream(float buffer_duration) {
+sound_t _sound_create_stream(float buffer_duration, bool32_t lockfree) {
 	sound_t result = (_sound_t*)assets_allocate(asset_type_sound);
 
-	result->type      = sound_type_stream;
-	result->data_lock = ft_mutex_create();
+	result->type            = sound_type_stream;
+	result->stream_lockfree = lockfree;
+	// App-side reads always lock, they have to stay out of the mixer's way.
+	if (!lockfree)
+		result->data_lock = ft_mutex_create();
+	result->read_lock = ft_mutex_create();
 	result->buffer.capacity = (uint64_t)((double)buffer_duration * AU_SAMPLE_RATE);
 	result->buffer.data     = sk_malloc_t(float, (size_t)result->buffer.capacity);
 	memset(result->buffer.data, 0, (size_t)(result->buffer.capacity * sizeof(float)));
@@ -80,6 +92,18 @@ sound_t sound_create_stream(float buffer_duration) {
 
 ///////////////////////////////////////////
 
+sound_t sound_create_stream(float buffer_duration) {
+	return _sound_create_stream(buffer_duration, false);
+}
+
+///////////////////////////////////////////
+
+sound_t sound_create_stream_lockfree(float buffer_duration) {
+	return _sound_create_stream(buffer_duration, true);
+}
+
+///////////////////////////////////////////
+
 sound_t sound_create_samples(const float *samples_at_48000s, uint64_t sample_count) {
 	sound_t result = (_sound_t*)assets_allocate(asset_type_sound);
 
@@ -110,13 +134,16 @@ sound_t sound_generate(float (*function)(float sample_time), float duration) {
 
 ///////////////////////////////////////////
 
-void sound_write_samples(sound_t sound, const float *samples, uint64_t sample_count) {
-	if (sound->type != sound_type_stream) { log_err("Sound read/write is only supported for streaming type sounds!"); return; }
+uint64_t sound_stream_write(sound_t sound, const float *samples, uint64_t sample_count) {
+	// ma_pcm_rb is safe for one producer and one consumer without locking,
+	// so this only touches the write side.
+	uint64_t available = ma_pcm_rb_available_write(&sound->stream_buffer);
+	if (sample_count > available) {
+		atomic_add64(&sound->stream_overruns, 1);
+		sample_count = available;
+	}
 
-	sample_count = mini((uint32_t)sample_count, ma_pcm_rb_available_write(&sound->stream_buffer));
-	
 	ma_uint32 written  = 0;
-	ft_mutex_lock(sound->data_lock);
 	ma_uint32 writable = 0;
 	void*     write_to = nullptr;
 	while (written < sample_count) {
@@ -131,21 +158,18 @@ void sound_write_samples(sound_t sound, const float *samples, uint64_t sample_co
 		
 		written += writable;
 	}
-	ft_mutex_unlock(sound->data_lock);
 
 	sound->buffer.count = mini(sound->buffer.count + written, sound->buffer.capacity);
+	return written;
 }
 
 ///////////////////////////////////////////
 
-uint64_t sound_read_samples(sound_t sound, float *out_samples, uint64_t sample_count) {
-	if (sound->type != sound_type_stream) { log_err("Sound read/write is only supported for streaming type sounds!"); return 0; }
-
+uint64_t sound_stream_read(sound_t sound, float *out_samples, uint64_t sample_count) {
 	ma_uint32 available = ma_pcm_rb_available_read(&sound->stream_buffer);
 	sample_count = mini((uint32_t)sample_count, available);
 
-	ma_uint32 read  = 0;
-	ft_mutex_lock(sound->data_lock);
+	ma_uint32 read      = 0;
 	ma_uint32 readable  = 0;
 	void*     read_from = nullptr;
 	while (read < sample_count) {
@@ -161,13 +185,83 @@ uint64_t sound_read_samples(sound_t sound, float *out_samples, uint64_t sample_c
 		
 		read += readable;
 	}
-	ft_mutex_unlock(sound->data_lock);
+	return read;
+}
+
+///////////////////////////////////////////
 
+uint64_t sound_stream_read_mixer(sound_t sound, float *out_samples, uint64_t sample_count) {
+	uint64_t read = sound_stream_read(sound, out_samples, sample_count);
+
+	// Count each time a flowing stream runs dry, rather than every block it
+	// stays empty for.
+	if (read < sample_count) {
+		if (!sound->stream_starved) atomic_add64(&sound->stream_underruns, 1);
+		sound->stream_starved = true;
+	} else {
+		sound->stream_starved = false;
+	}
 	return read;
 }
 
 ///////////////////////////////////////////
 
+void sound_write_samples(sound_t sound, const float *samples, uint64_t sample_count) {
+	if (sound->type != sound_type_stream) { log_err("Sound read/write is only supported for streaming type sounds!"); return; }
+
+	if (sound->stream_lockfree) {
+		sound_stream_write(sound, samples, sample_count);
+	} else {
+		ft_mutex_lock(sound->data_lock);
+		sound_stream_write(sound, samples, sample_count);
+		ft_mutex_unlock(sound->data_lock);
+	}
+}
+
+///////////////////////////////////////////
+
+uint64_t sound_read_samples(sound_t sound, float *out_samples, uint64_t sample_count) {
+	if (sound->type != sound_type_stream) { log_err("Sound read/write is only supported for streaming type sounds!"); return 0; }
+
+	// The ring buffer only supports a single reader, and while the sound is
+	// playing, that's the mixer.
+	ft_mutex_lock(sound->read_lock);
+	uint64_t read = 0;
+	if (sound->stream_playing) log_warn("sound_read_samples: Can't read from a stream sound while it's playing.");
+	else                       read = sound_stream_read(sound, out_samples, sample_count);
+	ft_mutex_unlock(sound->read_lock);
+	return read;
+}
+
+///////////////////////////////////////////
+
+void sound_stream_set_playing(sound_t sound, bool32_t playing) {
+	if (playing) {
+		// Once this returns, no app-side read is in flight, and none will
+		// start until the voice is reclaimed.
+		ft_mutex_lock(sound->read_lock);
+		sound->stream_playing = true;
+		ft_mutex_unlock(sound->read_lock);
+	} else {
+		atomic_barrier();
+		sound->stream_playing = false;
+	}
+}
+
+///////////////////////////////////////////
+
+uint64_t sound_stream_get_overruns(sound_t sound) {
+	return sound->stream_overruns;
+}
+
+///////////////////////////////////////////
+
+uint64_t sound_stream_get_underruns(sound_t sound) {
+	return sound->stream_underruns;
+}
+
+///////////////////////////////////////////
+
 uint64_t sound_unread_samples(sound_t sound) {
 	return sound->type == sound_type_stream
 		? ma_pcm_rb_available_read(&sound->stream_buffer)
@@ -177,35 +271,33 @@ uint64_t sound_unread_samples(sound_t sound) {
 ///////////////////////////////////////////
 
 sound_inst_t sound_play(sound_t sound, vec3 at, float volume) {
-	ma_decoder_seek_to_pcm_frame(&sound->decoder, 0);
-	sound->buffer.cursor = 0;
+	return audio_voice_play(sound, at, volume);
+}
+
+///////////////////////////////////////////
 
-	sound_inst_t result;
-	result._id   = 0;
-	result._slot = -1;
+void sound_set_priority(sound_t sound, int32_t priority) {
+	sound->priority = priority;
+}
 
-	for (size_t i = 0; i < _countof(au_active_sounds); i++) {
-		if (au_active_sounds[i].sound == sound) {
-			au_active_sounds[i] = {sound, au_active_sounds[i].id, at, volume };
+///////////////////////////////////////////
 
-			result._id   = au_active_sounds[i].id;
-			result._slot = (int16_t)i;
-			return result;
-		}
-	}
+int32_t sound_get_priority(sound_t sound) {
+	return sound->priority;
+}
 
-	for (size_t i = 0; i < _countof(au_active_sounds); i++) {
-		if (au_active_sounds[i].sound == nullptr) {
-			sound_addref(sound);
-			au_active_sounds[i] = { sound, (uint16_t)(au_active_sounds[i].id+1), at, volume };
+///////////////////////////////////////////
 
-			result._id   = au_active_sounds[i].id;
-			result._slot = (int16_t)i;
-			return result;
-		}
-	}
-	return result;
+void sound_set_cache_budget(uint64_t bytes) {
+	audio_pcm_set_budget(bytes);
 }
+
+///////////////////////////////////////////
+
+uint64_t sound_get_cache_budget() {
+	return audio_pcm_get_budget();
+}
+
 ///////////////////////////////////////////
 
 uint64_t sound_total_samples(sound_t sound) {
@@ -227,8 +319,14 @@ uint64_t sound_total_samples(sound_t sound) {
 ///////////////////////////////////////////
 
 uint64_t sound_cursor_samples(sound_t sound) {
-	return sound->type == sound_type_stream
-		? sound->buffer.count-ma_pcm_rb_pointer_distance(&sound->stream_buffer)
+	if (sound->type == sound_type_stream)
+		return sound->buffer.count-ma_pcm_rb_pointer_distance(&sound->stream_buffer);
+
+	// Each voice has its own cursor, so report the most recently played one.
+	// Once it's done, buffer.cursor holds where it stopped.
+	au_voice_t *voice = audio_voice_get(sound->last_inst);
+	return voice != nullptr
+		? voice->cursor
 		: sound->buffer.cursor;
 }
 
@@ -268,59 +366,56 @@ void sound_release(sound_t sound) {
 ///////////////////////////////////////////
 
 void sound_destroy(sound_t sound) {
+	audio_pcm_remove(sound);
 	ma_decoder_uninit(&sound->decoder);
+	sk_free(sound->file_data);
 	if (sound->type == sound_type_stream) {
 		ma_pcm_rb_uninit(&sound->stream_buffer);
 	}
-	if (sound->buffer.data) {
-		sk_free         ( sound->buffer.data);
-		ft_mutex_destroy(&sound->data_lock);
-	}
+	sk_free(sound->buffer.data);
+	if (sound->data_lock) ft_mutex_destroy(&sound->data_lock);
+	if (sound->read_lock) ft_mutex_destroy(&sound->read_lock);
 	memset(sound, 0, sizeof(_sound_t));
 }
 
 ///////////////////////////////////////////
 
 void sound_inst_stop(sound_inst_t sound_inst) {
-	if (sound_inst._slot < 0 || au_active_sounds[sound_inst._slot].id != sound_inst._id) return;
-
-	sound_t sound = au_active_sounds[sound_inst._slot].sound;
-	au_active_sounds[sound_inst._slot].sound = nullptr;
-	sound_release(sound);
+	au_voice_t *voice = audio_voice_get(sound_inst);
+	if (voice != nullptr) audio_voice_stop(voice);
 }
 
 ///////////////////////////////////////////
 
 bool32_t sound_inst_is_playing(sound_inst_t sound_inst) {
-	if (sound_inst._slot < 0 || au_active_sounds[sound_inst._slot].id != sound_inst._id) return false;
-	return au_active_sounds[sound_inst._slot].sound != nullptr;
+	return audio_voice_get(sound_inst) != nullptr;
 }
 
 ///////////////////////////////////////////
 void sound_inst_set_pos(sound_inst_t sound_inst, vec3 pos) {
-	if (sound_inst._slot < 0 || au_active_sounds[sound_inst._slot].id != sound_inst._id) return;
-	au_active_sounds[sound_inst._slot].position = pos;
+	au_voice_t *voice = audio_voice_get(sound_inst);
+	if (voice != nullptr) voice->position = pos;
 }
 
 ///////////////////////////////////////////
 
 vec3 sound_inst_get_pos(sound_inst_t sound_inst) {
-	if (sound_inst._slot < 0 || au_active_sounds[sound_inst._slot].id != sound_inst._id) return vec3_zero;
-	return au_active_sounds[sound_inst._slot].position;
+	au_voice_t *voice = audio_voice_get(sound_inst);
+	return voice != nullptr ? voice->position : vec3_zero;
 }
 
 ///////////////////////////////////////////
 
 void sound_inst_set_volume(sound_inst_t sound_inst, float volume) {
-	if (sound_inst._slot < 0 || au_active_sounds[sound_inst._slot].id != sound_inst._id) return;
-	au_active_sounds[sound_inst._slot].volume = volume;
+	au_voice_t *voice = audio_voice_get(sound_inst);
+	if (voice != nullptr) voice->volume = volume;
 }
 
 ///////////////////////////////////////////
 
 float sound_inst_get_volume(sound_inst_t sound_inst) {
-	if (sound_inst._slot < 0 || au_active_sounds[sound_inst._slot].id != sound_inst._id) return 0;
-	return au_active_sounds[sound_inst._slot].volume;
+	au_voice_t *voice = audio_voice_get(sound_inst);
+	return voice != nullptr ? voice->volume : 0;
 }
 
 }
\ No newline at end of file
@@ -6,6 +6,8 @@
 
 namespace sk {
 
+struct au_pcm_t;
+
 struct buffer_t {
 	float*   data;
 	uint64_t capacity;
@@ -23,12 +25,34 @@ typedef enum sound_type_ {
 struct _sound_t {
 	asset_header_t header;
 	sound_type_    type;
-	ma_decoder     decoder;
+	ma_decoder     decoder;    // Only used for info queries, voices never decode from it
+	void          *file_data;  // Encoded file, kept around for creating voice decoders
+	size_t         file_size;
 	buffer_t       buffer;
 	ma_pcm_rb      stream_buffer;
-	ft_mutex_t     data_lock;
+	ft_mutex_t     data_lock;      // Serializes app-side writers, never taken by the audio thread
+	ft_mutex_t     read_lock;      // Serializes app-side readers and starting playback, never taken by the audio thread
+	bool32_t       stream_lockfree;// Single producer, single consumer, no locks on the write side
+	volatile bool32_t stream_playing; // A voice is reading the stream, so app-side reads are rejected
+	volatile uint64_t stream_overruns;
+	volatile uint64_t stream_underruns;
+	bool32_t       stream_starved;
+	au_pcm_t      *pcm;            // Decoded samples, if resident in the cache. Guarded by the cache's lock
+	bool32_t       pcm_pending;    // A background decode is queued
+	bool32_t       pcm_uncacheable;// Too long to cache, always streams
+	int32_t        priority;   // Higher priority voices are stolen last
+	sound_inst_t   last_inst;  // Most recently played voice, for sound_cursor_samples
 };
 
-void sound_destroy(sound_t sound);
+void     sound_destroy          (sound_t sound);
+// Lock free stream access, these are safe with exactly one writing thread and
+// one reading thread. The mixer reads through sound_stream_read_mixer, and
+// while it does, sound_read_samples refuses to read.
+uint64_t sound_stream_write      (sound_t sound, const float *samples, uint64_t sample_count);
+uint64_t sound_stream_read       (sound_t sound, float *out_samples, uint64_t sample_count);
+uint64_t sound_stream_read_mixer (sound_t sound, float *out_samples, uint64_t sample_count);
+// Main thread, marks the stream as owned by the mixer, waiting for any
+// app-side read that's already in progress.
+void     sound_stream_set_playing(sound_t sound, bool32_t playing);
 
 }
\ No newline at end of file
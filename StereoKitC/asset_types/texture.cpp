@@ -11,6 +11,7 @@
 #include "../sk_math.h"
 #include "../sk_memory.h"
 #include "../spherical_harmonics.h"
+#include "../systems/render.h"
 #include "texture.h"
 #include "texture_.h"
 #include "texture_compression.h"
@@ -901,6 +902,20 @@ void tex_on_load_remove(tex_t texture, void (*on_load)(tex_t texture, void *cont
 
 ///////////////////////////////////////////
 
+void _tex_count_upload(tex_format_ format, int32_t width, int32_t height, void **array_data, int32_t array_count, int32_t mip_count) {
+	if (array_data == nullptr || *array_data == nullptr) return;
+
+	int64_t bytes = 0;
+	for (int32_t m = 0; m < mip_count; m++) {
+		int32_t mip_w = width  >> m; if (mip_w < 1) mip_w = 1;
+		int32_t mip_h = height >> m; if (mip_h < 1) mip_h = 1;
+		bytes += tex_format_size(format, mip_w, mip_h);
+	}
+	render_stats_add_tex_upload(bytes * array_count);
+}
+
+///////////////////////////////////////////
+
 void _tex_set_color_arr(tex_t texture, int32_t width, int32_t height, void **array_data, int32_t array_count, int32_t mip_count, spherical_harmonics_t *sh_lighting_info, int32_t multisample) {
 	bool dynamic        = texture->type & tex_type_dynamic;
 	bool different_size = texture->width != width || texture->height != height || texture->tex.array_count != array_count;
@@ -921,6 +936,7 @@ void _tex_set_color_arr(tex_t texture, int32_t width, int32_t height, void **arr
 		skg_tex_t new_tex = skg_tex_create(type, use, format, use_mips);
 		_tex_set_options(&new_tex, texture->sample_mode, texture->address_mode, texture->anisotropy);
 		skg_tex_set_contents_arr(&new_tex, (const void**)array_data, array_count, mip_count, width, height, multisample);
+		_tex_count_upload(texture->format, width, height, array_data, array_count, mip_count);
 		skg_tex_t old_tex = texture->tex;
 		texture->tex = new_tex;
 		if (skg_tex_is_valid(&old_tex))
@@ -935,6 +951,7 @@ void _tex_set_color_arr(tex_t texture, int32_t width, int32_t height, void **arr
 		tex_update_label(texture);
 	} else if (dynamic) {
 		skg_tex_set_contents_arr(&texture->tex, (const void**)array_data, array_count, mip_count, width, height, multisample);
+		_tex_count_upload(texture->format, width, height, array_data, array_count, mip_count);
 	} else {
 		log_warn("Attempting additional writes to a non-dynamic texture!");
 	}
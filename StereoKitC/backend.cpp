@@ -3,6 +3,9 @@
 #include "platforms/platform.h"
 
 #include <sk_gpu.h>
+#if defined(SK_GPU_NULL)
+#include "libraries/sk_gpu_null.h"
+#endif
 
 namespace sk {
 
@@ -159,7 +162,9 @@ void *backend_android_get_jni_env () { log_err(backend_err_wrong_backend); retur
 ///////////////////////////////////////////
 
 backend_graphics_ backend_graphics_get() {
-#if defined(SKG_DIRECT3D11)
+#if defined(SK_GPU_NULL)
+	return backend_graphics_null;
+#elif defined(SKG_DIRECT3D11)
 	return backend_graphics_d3d11;
 #elif defined(_SKG_GL_LOAD_WGL)
 	return backend_graphics_opengl_wgl;
@@ -325,4 +330,35 @@ void* backend_opengl_egl_get_display() {
 #endif
 }
 
+///////////////////////////////////////////
+
+backend_null_stats_t backend_null_get_stats() {
+#if !defined(SK_GPU_NULL)
+	log_err(backend_err_wrong_backend);
+	return {};
+#else
+	skg_null_stats_t     stats  = skg_null_get_stats();
+	backend_null_stats_t result = {};
+	result.draw_calls       = (int64_t)stats.draw_calls;
+	result.instances        = (int64_t)stats.instances;
+	result.indices          = (int64_t)stats.indices;
+	result.buffer_bytes     = (int64_t)stats.buffer_bytes;
+	result.texture_bytes    = (int64_t)stats.texture_bytes;
+	result.buffers_created  = (int64_t)stats.buffers_created;
+	result.textures_created = (int64_t)stats.textures_created;
+	result.frames           = (int64_t)stats.frames;
+	return result;
+#endif
+}
+
+///////////////////////////////////////////
+
+void backend_null_reset_stats() {
+#if !defined(SK_GPU_NULL)
+	log_err(backend_err_wrong_backend);
+#else
+	skg_null_reset_stats();
+#endif
+}
+
 }
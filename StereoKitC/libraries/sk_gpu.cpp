@@ -1,3 +1,8 @@
+// With SK_GPU_NULL, sk_gpu_null.cpp provides the implementation instead.
+#if !defined(SK_GPU_NULL)
+
 #define SKG_IMPL
 #define SKG_NO_D3DCOMPILER
-#include <sk_gpu.h>
\ No newline at end of file
+#include <sk_gpu.h>
+
+#endif
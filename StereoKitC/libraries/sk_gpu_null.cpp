@@ -0,0 +1,489 @@
+// A null sk_gpu backend, for running StereoKit without a GPU. Build with
+// SK_GPU_NULL to use this in place of sk_gpu.cpp. Every device call succeeds
+// and does nothing, but draws and uploads are still counted, so the CPU side
+// of the frame loop can be profiled on machines that have no graphics device.
+//
+// sk_gpu's own implementation is still compiled here, with its device facing
+// functions renamed out of the way. That way the parts that don't touch a
+// device, like shader file parsing and texture format math, are the real
+// thing and stay in sync with sk_gpu.
+
+#if defined(SK_GPU_NULL)
+
+#define skg_init                      skg_device_init
+#define skg_adapter_name              skg_device_adapter_name
+#define skg_shutdown                  skg_device_shutdown
+#define skg_get_platform_data         skg_device_get_platform_data
+#define skg_capability                skg_device_capability
+#define skg_event_begin               skg_device_event_begin
+#define skg_event_end                 skg_device_event_end
+#define skg_draw_begin                skg_device_draw_begin
+#define skg_draw                      skg_device_draw
+#define skg_compute                   skg_device_compute
+#define skg_viewport                  skg_device_viewport
+#define skg_viewport_get              skg_device_viewport_get
+#define skg_scissor                   skg_device_scissor
+#define skg_target_clear              skg_device_target_clear
+#define skg_buffer_create             skg_device_buffer_create
+#define skg_buffer_name               skg_device_buffer_name
+#define skg_buffer_is_valid           skg_device_buffer_is_valid
+#define skg_buffer_set_contents       skg_device_buffer_set_contents
+#define skg_buffer_get_contents       skg_device_buffer_get_contents
+#define skg_buffer_bind               skg_device_buffer_bind
+#define skg_buffer_clear              skg_device_buffer_clear
+#define skg_buffer_destroy            skg_device_buffer_destroy
+#define skg_mesh_create               skg_device_mesh_create
+#define skg_mesh_name                 skg_device_mesh_name
+#define skg_mesh_set_verts            skg_device_mesh_set_verts
+#define skg_mesh_set_inds             skg_device_mesh_set_inds
+#define skg_mesh_bind                 skg_device_mesh_bind
+#define skg_mesh_destroy              skg_device_mesh_destroy
+#define skg_shader_create_memory      skg_device_shader_create_memory
+#define skg_shader_name               skg_device_shader_name
+#define skg_shader_is_valid           skg_device_shader_is_valid
+#define skg_shader_destroy            skg_device_shader_destroy
+#define skg_pipeline_create           skg_device_pipeline_create
+#define skg_pipeline_name             skg_device_pipeline_name
+#define skg_pipeline_bind             skg_device_pipeline_bind
+#define skg_pipeline_set_transparency skg_device_pipeline_set_transparency
+#define skg_pipeline_set_cull         skg_device_pipeline_set_cull
+#define skg_pipeline_set_wireframe    skg_device_pipeline_set_wireframe
+#define skg_pipeline_set_depth_write  skg_device_pipeline_set_depth_write
+#define skg_pipeline_set_depth_test   skg_device_pipeline_set_depth_test
+#define skg_pipeline_destroy          skg_device_pipeline_destroy
+#define skg_swapchain_create          skg_device_swapchain_create
+#define skg_swapchain_resize          skg_device_swapchain_resize
+#define skg_swapchain_present         skg_device_swapchain_present
+#define skg_swapchain_bind            skg_device_swapchain_bind
+#define skg_swapchain_destroy         skg_device_swapchain_destroy
+#define skg_tex_create_from_existing  skg_device_tex_create_from_existing
+#define skg_tex_create_from_layer     skg_device_tex_create_from_layer
+#define skg_tex_create                skg_device_tex_create
+#define skg_tex_name                  skg_device_tex_name
+#define skg_tex_is_valid              skg_device_tex_is_valid
+#define skg_tex_copy_to               skg_device_tex_copy_to
+#define skg_tex_copy_to_swapchain     skg_device_tex_copy_to_swapchain
+#define skg_tex_gen_mips              skg_device_tex_gen_mips
+#define skg_tex_attach_depth          skg_device_tex_attach_depth
+#define skg_tex_settings              skg_device_tex_settings
+#define skg_tex_set_contents          skg_device_tex_set_contents
+#define skg_tex_set_contents_arr      skg_device_tex_set_contents_arr
+#define skg_tex_get_contents          skg_device_tex_get_contents
+#define skg_tex_get_mip_contents      skg_device_tex_get_mip_contents
+#define skg_tex_get_mip_contents_arr  skg_device_tex_get_mip_contents_arr
+#define skg_tex_get_native            skg_device_tex_get_native
+#define skg_tex_bind                  skg_device_tex_bind
+#define skg_tex_clear                 skg_device_tex_clear
+#define skg_tex_target_bind           skg_device_tex_target_bind
+#define skg_tex_target_get            skg_device_tex_target_get
+#define skg_tex_destroy               skg_device_tex_destroy
+#define skg_tex_fmt_to_native         skg_device_tex_fmt_to_native
+#define skg_tex_fmt_from_native       skg_device_tex_fmt_from_native
+#define skg_tex_fmt_supported         skg_device_tex_fmt_supported
+
+#define SKG_IMPL
+#define SKG_NO_D3DCOMPILER
+#include <sk_gpu.h>
+
+#undef skg_init
+#undef skg_adapter_name
+#undef skg_shutdown
+#undef skg_get_platform_data
+#undef skg_capability
+#undef skg_event_begin
+#undef skg_event_end
+#undef skg_draw_begin
+#undef skg_draw
+#undef skg_compute
+#undef skg_viewport
+#undef skg_viewport_get
+#undef skg_scissor
+#undef skg_target_clear
+#undef skg_buffer_create
+#undef skg_buffer_name
+#undef skg_buffer_is_valid
+#undef skg_buffer_set_contents
+#undef skg_buffer_get_contents
+#undef skg_buffer_bind
+#undef skg_buffer_clear
+#undef skg_buffer_destroy
+#undef skg_mesh_create
+#undef skg_mesh_name
+#undef skg_mesh_set_verts
+#undef skg_mesh_set_inds
+#undef skg_mesh_bind
+#undef skg_mesh_destroy
+#undef skg_shader_create_memory
+#undef skg_shader_name
+#undef skg_shader_is_valid
+#undef skg_shader_destroy
+#undef skg_pipeline_create
+#undef skg_pipeline_name
+#undef skg_pipeline_bind
+#undef skg_pipeline_set_transparency
+#undef skg_pipeline_set_cull
+#undef skg_pipeline_set_wireframe
+#undef skg_pipeline_set_depth_write
+#undef skg_pipeline_set_depth_test
+#undef skg_pipeline_destroy
+#undef skg_swapchain_create
+#undef skg_swapchain_resize
+#undef skg_swapchain_present
+#undef skg_swapchain_bind
+#undef skg_swapchain_destroy
+#undef skg_tex_create_from_existing
+#undef skg_tex_create_from_layer
+#undef skg_tex_create
+#undef skg_tex_name
+#undef skg_tex_is_valid
+#undef skg_tex_copy_to
+#undef skg_tex_copy_to_swapchain
+#undef skg_tex_gen_mips
+#undef skg_tex_attach_depth
+#undef skg_tex_settings
+#undef skg_tex_set_contents
+#undef skg_tex_set_contents_arr
+#undef skg_tex_get_contents
+#undef skg_tex_get_mip_contents
+#undef skg_tex_get_mip_contents_arr
+#undef skg_tex_get_native
+#undef skg_tex_bind
+#undef skg_tex_clear
+#undef skg_tex_target_bind
+#undef skg_tex_target_get
+#undef skg_tex_destroy
+#undef skg_tex_fmt_to_native
+#undef skg_tex_fmt_from_native
+#undef skg_tex_fmt_supported
+
+#include "sk_gpu_null.h"
+#include "../log.h"
+
+#include <string.h>
+
+using namespace sk;
+
+///////////////////////////////////////////
+
+static skg_null_stats_t skg_null_stats  = {};
+static skg_tex_t       *skg_null_target = nullptr;
+static int32_t          skg_null_viewport[4] = {};
+
+///////////////////////////////////////////
+
+namespace sk {
+
+skg_null_stats_t skg_null_get_stats  () { return skg_null_stats; }
+void             skg_null_reset_stats() { skg_null_stats = {}; }
+
+}
+
+///////////////////////////////////////////
+// Device
+///////////////////////////////////////////
+
+int32_t skg_init(const char *, void *) {
+	skg_null_stats = {};
+	return 1;
+}
+
+///////////////////////////////////////////
+
+const char *skg_adapter_name() {
+	return "Null GPU";
+}
+
+///////////////////////////////////////////
+
+void skg_shutdown() {
+	log_infof("Null GPU totals: %llu frames, %llu draws, %llu instances, %llu buffer bytes, %llu texture bytes",
+		(unsigned long long)skg_null_stats.frames,
+		(unsigned long long)skg_null_stats.draw_calls,
+		(unsigned long long)skg_null_stats.instances,
+		(unsigned long long)skg_null_stats.buffer_bytes,
+		(unsigned long long)skg_null_stats.texture_bytes);
+	skg_null_target = nullptr;
+}
+
+///////////////////////////////////////////
+
+skg_platform_data_t skg_get_platform_data() { return {}; }
+bool                skg_capability       (skg_cap_) { return false; }
+void                skg_event_begin      (const char *) {}
+void                skg_event_end        () {}
+
+///////////////////////////////////////////
+
+void skg_draw_begin() {
+	skg_null_target = nullptr;
+}
+
+///////////////////////////////////////////
+
+void skg_draw(int32_t, int32_t, int32_t index_count, int32_t instance_count) {
+	skg_null_stats.draw_calls += 1;
+	skg_null_stats.instances  += instance_count;
+	skg_null_stats.indices    += (uint64_t)index_count * instance_count;
+}
+
+///////////////////////////////////////////
+
+void skg_compute     (uint32_t, uint32_t, uint32_t) {}
+void skg_viewport    (const int32_t *xywh)   { memcpy(skg_null_viewport, xywh, sizeof(skg_null_viewport)); }
+void skg_viewport_get(int32_t *out_xywh)     { memcpy(out_xywh, skg_null_viewport, sizeof(skg_null_viewport)); }
+void skg_scissor     (const int32_t *)       {}
+void skg_target_clear(bool, const float *)   {}
+
+///////////////////////////////////////////
+// Buffers
+///////////////////////////////////////////
+
+// Buffers have no backend handle here, so a non-zero stride is what marks
+// one as valid.
+skg_buffer_t skg_buffer_create(const void *data, uint32_t size_count, uint32_t size_stride, skg_buffer_type_ type, skg_use_ use) {
+	skg_buffer_t result = {};
+	result.use    = use;
+	result.type   = type;
+	result.stride = size_stride;
+	skg_null_stats.buffers_created += 1;
+	if (data != nullptr)
+		skg_null_stats.buffer_bytes += (uint64_t)size_count * size_stride;
+	return result;
+}
+
+///////////////////////////////////////////
+
+void skg_buffer_set_contents(skg_buffer_t *, const void *, uint32_t size_bytes) {
+	skg_null_stats.buffer_bytes += size_bytes;
+}
+
+///////////////////////////////////////////
+
+void skg_buffer_get_contents(const skg_buffer_t *, void *ref_buffer, uint32_t buffer_size) {
+	memset(ref_buffer, 0, buffer_size);
+}
+
+///////////////////////////////////////////
+
+void skg_buffer_name    (skg_buffer_t *, const char *) {}
+bool skg_buffer_is_valid(const skg_buffer_t *buffer) { return buffer->stride != 0; }
+void skg_buffer_bind    (const skg_buffer_t *, skg_bind_t) {}
+void skg_buffer_clear   (skg_bind_t) {}
+void skg_buffer_destroy (skg_buffer_t *buffer) { *buffer = {}; }
+
+///////////////////////////////////////////
+// Meshes
+///////////////////////////////////////////
+
+skg_mesh_t skg_mesh_create   (const skg_buffer_t *, const skg_buffer_t *) { return {}; }
+void       skg_mesh_name     (skg_mesh_t *, const char *) {}
+void       skg_mesh_set_verts(skg_mesh_t *, const skg_buffer_t *) {}
+void       skg_mesh_set_inds (skg_mesh_t *, const skg_buffer_t *) {}
+void       skg_mesh_bind     (const skg_mesh_t *) {}
+void       skg_mesh_destroy  (skg_mesh_t *mesh) { *mesh = {}; }
+
+///////////////////////////////////////////
+// Shaders and pipelines
+///////////////////////////////////////////
+
+// Materials need the shader's parameter metadata, so the file is still
+// parsed for real, only the shader stages are skipped.
+skg_shader_t skg_shader_create_memory(const void *sks_data, size_t sks_data_size) {
+	skg_shader_t      result = {};
+	skg_shader_file_t file   = {};
+	if (!skg_shader_file_load_memory(sks_data, sks_data_size, &file))
+		return result;
+
+	result.meta = file.meta;
+	skg_shader_meta_reference(result.meta);
+	skg_shader_file_destroy(&file);
+	return result;
+}
+
+///////////////////////////////////////////
+
+void skg_shader_destroy(skg_shader_t *shader) {
+	skg_shader_meta_release(shader->meta);
+	*shader = {};
+}
+
+///////////////////////////////////////////
+
+void skg_shader_name    (skg_shader_t *, const char *) {}
+bool skg_shader_is_valid(const skg_shader_t *shader) { return shader->meta != nullptr; }
+
+///////////////////////////////////////////
+
+skg_pipeline_t skg_pipeline_create(skg_shader_t *shader) {
+	skg_pipeline_t result = {};
+	result.transparency = skg_transparency_none;
+	result.cull         = skg_cull_back;
+	result.wireframe    = false;
+	result.depth_write  = true;
+	result.depth_test   = skg_depth_test_less;
+	result.meta         = shader->meta;
+	skg_shader_meta_reference(result.meta);
+	return result;
+}
+
+///////////////////////////////////////////
+
+void skg_pipeline_destroy(skg_pipeline_t *pipeline) {
+	skg_shader_meta_release(pipeline->meta);
+	*pipeline = {};
+}
+
+///////////////////////////////////////////
+
+void skg_pipeline_name            (skg_pipeline_t *, const char *) {}
+void skg_pipeline_bind            (const skg_pipeline_t *) {}
+void skg_pipeline_set_transparency(skg_pipeline_t *pipeline, skg_transparency_ transparency) { pipeline->transparency = transparency; }
+void skg_pipeline_set_cull        (skg_pipeline_t *pipeline, skg_cull_ cull)                 { pipeline->cull         = cull; }
+void skg_pipeline_set_wireframe   (skg_pipeline_t *pipeline, bool wireframe)                 { pipeline->wireframe    = wireframe; }
+void skg_pipeline_set_depth_write (skg_pipeline_t *pipeline, bool write)                     { pipeline->depth_write  = write; }
+void skg_pipeline_set_depth_test  (skg_pipeline_t *pipeline, skg_depth_test_ test)           { pipeline->depth_test   = test; }
+
+///////////////////////////////////////////
+// Swapchains
+///////////////////////////////////////////
+
+skg_swapchain_t skg_swapchain_create(void *, skg_tex_fmt_, skg_tex_fmt_, int32_t requested_width, int32_t requested_height) {
+	skg_swapchain_t result = {};
+	result.width  = requested_width;
+	result.height = requested_height;
+	return result;
+}
+
+///////////////////////////////////////////
+
+void skg_swapchain_resize(skg_swapchain_t *swapchain, int32_t width, int32_t height) {
+	swapchain->width  = width;
+	swapchain->height = height;
+}
+
+///////////////////////////////////////////
+
+void skg_swapchain_present(skg_swapchain_t *) {
+	skg_null_stats.frames += 1;
+}
+
+///////////////////////////////////////////
+
+void skg_swapchain_bind   (skg_swapchain_t *) {}
+void skg_swapchain_destroy(skg_swapchain_t *swapchain) { *swapchain = {}; }
+
+///////////////////////////////////////////
+// Textures
+///////////////////////////////////////////
+
+// Textures have no backend handle here either, a format is what marks one
+// as valid.
+skg_tex_t skg_tex_create(skg_tex_type_ type, skg_use_ use, skg_tex_fmt_ format, skg_mip_ mip_maps) {
+	skg_tex_t result = {};
+	result.type        = type;
+	result.use         = use;
+	result.format      = format;
+	result.mips        = mip_maps;
+	result.array_count = 1;
+	skg_null_stats.textures_created += 1;
+	return result;
+}
+
+///////////////////////////////////////////
+
+skg_tex_t skg_tex_create_from_existing(void *, skg_tex_type_ type, skg_tex_fmt_ format, int32_t width, int32_t height, int32_t array_count, int32_t multisample, int32_t) {
+	skg_tex_t result = skg_tex_create(type, skg_use_static, format, skg_mip_none);
+	result.width       = width;
+	result.height      = height;
+	result.array_count = array_count;
+	result.multisample = multisample;
+	return result;
+}
+
+///////////////////////////////////////////
+
+skg_tex_t skg_tex_create_from_layer(void *, skg_tex_type_ type, skg_tex_fmt_ format, int32_t width, int32_t height, int32_t array_layer) {
+	skg_tex_t result = skg_tex_create(type, skg_use_static, format, skg_mip_none);
+	result.width       = width;
+	result.height      = height;
+	result.array_start = array_layer;
+	return result;
+}
+
+///////////////////////////////////////////
+
+void skg_tex_set_contents_arr(skg_tex_t *tex, const void **array_data, int32_t array_count, int32_t mip_count, int32_t width, int32_t height, int32_t multisample) {
+	tex->width       = width;
+	tex->height      = height;
+	tex->array_count = array_count;
+	tex->multisample = multisample;
+	if (array_data == nullptr)
+		return;
+
+	uint64_t bytes = 0;
+	for (int32_t m = 0; m < (mip_count > 0 ? mip_count : 1); m++) {
+		int32_t mip_w, mip_h;
+		skg_mip_dimensions(width, height, m, &mip_w, &mip_h);
+		bytes += skg_tex_fmt_memory(tex->format, mip_w, mip_h);
+	}
+	skg_null_stats.texture_bytes += bytes * array_count;
+}
+
+///////////////////////////////////////////
+
+void skg_tex_set_contents(skg_tex_t *tex, const void *data, int32_t width, int32_t height) {
+	const void *data_arr[1] = { data };
+	skg_tex_set_contents_arr(tex, data != nullptr ? data_arr : nullptr, 1, 1, width, height, 1);
+}
+
+///////////////////////////////////////////
+
+bool skg_tex_get_contents(skg_tex_t *, void *ref_data, size_t data_size) {
+	memset(ref_data, 0, data_size);
+	return true;
+}
+
+///////////////////////////////////////////
+
+bool skg_tex_get_mip_contents(skg_tex_t *, int32_t, void *ref_data, size_t data_size) {
+	memset(ref_data, 0, data_size);
+	return true;
+}
+
+///////////////////////////////////////////
+
+bool skg_tex_get_mip_contents_arr(skg_tex_t *, int32_t, int32_t, void *ref_data, size_t data_size) {
+	memset(ref_data, 0, data_size);
+	return true;
+}
+
+///////////////////////////////////////////
+
+void skg_tex_target_bind(skg_tex_t *render_target, int32_t, int32_t) {
+	skg_null_target = render_target;
+}
+
+///////////////////////////////////////////
+
+skg_tex_t *skg_tex_target_get() {
+	return skg_null_target;
+}
+
+///////////////////////////////////////////
+
+void         skg_tex_name             (skg_tex_t *, const char *) {}
+bool         skg_tex_is_valid         (const skg_tex_t *tex) { return tex->format != skg_tex_fmt_none; }
+void         skg_tex_copy_to          (const skg_tex_t *, int32_t, skg_tex_t *, int32_t) {}
+void         skg_tex_copy_to_swapchain(const skg_tex_t *, skg_swapchain_t *) {}
+void         skg_tex_gen_mips         (skg_tex_t *) {}
+void         skg_tex_attach_depth     (skg_tex_t *, skg_tex_t *) {}
+void         skg_tex_settings         (skg_tex_t *, skg_tex_address_, skg_tex_sample_, int32_t) {}
+void        *skg_tex_get_native       (const skg_tex_t *) { return nullptr; }
+void         skg_tex_bind             (const skg_tex_t *, skg_bind_t) {}
+void         skg_tex_clear            (skg_bind_t) {}
+void         skg_tex_destroy          (skg_tex_t *tex) { if (skg_null_target == tex) skg_null_target = nullptr; *tex = {}; }
+int64_t      skg_tex_fmt_to_native    (skg_tex_fmt_ format) { return (int64_t)format; }
+skg_tex_fmt_ skg_tex_fmt_from_native  (int64_t format)      { return (skg_tex_fmt_)format; }
+bool         skg_tex_fmt_supported    (skg_tex_fmt_)        { return true; }
+
+#endif // SK_GPU_NULL
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace sk {
+
+// Totals from the null GPU backend, which is only built when SK_GPU_NULL is
+// defined. Everything sk_gpu is asked to do is accepted and dropped, but the
+// work is still counted so CPU side benchmarks can see what would have hit
+// the GPU.
+struct skg_null_stats_t {
+	uint64_t draw_calls;
+	uint64_t instances;
+	uint64_t indices;
+	uint64_t buffer_bytes;
+	uint64_t texture_bytes;
+	uint64_t buffers_created;
+	uint64_t textures_created;
+	uint64_t frames;
+};
+
+skg_null_stats_t skg_null_get_stats  ();
+void             skg_null_reset_stats();
+
+} // namespace sk
@@ -3,10 +3,12 @@
 #include "shader_builtin_skybox.hlsl.h"
 #include "shader_builtin_pbr.hlsl.h"
 #include "shader_builtin_pbr_clip.hlsl.h"
+#include "shader_builtin_pbr_skin.hlsl.h"
 #include "shader_builtin_default.hlsl.h"
 #include "shader_builtin_blit.hlsl.h"
 #include "shader_builtin_unlit.hlsl.h"
 #include "shader_builtin_unlit_clip.hlsl.h"
+#include "shader_builtin_unlit_skin.hlsl.h"
 #include "shader_builtin_lightmap.hlsl.h"
 #include "shader_builtin_equirect.hlsl.h"
 #include "shader_builtin_blit.hlsl.h"
@@ -27,13 +27,13 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float4 world = mul(input.pos, sk_inst[id].world);
+	float4 world = mul(input.pos, sk_inst(id).world);
 	o.pos        = mul(world,     sk_viewproj[o.view_id]);
 
-	float3 normal = normalize(mul(input.norm, (float3x3)sk_inst[id].world));
+	float3 normal = normalize(mul(input.norm, (float3x3)sk_inst(id).world));
 
 	o.uv         = (input.uv * tex_trans.zw) + tex_trans.xy;
-	o.color      = color * input.col * sk_inst[id].color;
+	o.color      = color * input.col * sk_inst(id).color;
 	o.color.rgb *= sk_lighting(normal);
 	return o;
 }
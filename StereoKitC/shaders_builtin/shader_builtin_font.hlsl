@@ -25,7 +25,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float3 world = mul(float4(input.pos.xyz, 1), sk_inst[id].world).xyz;
+	float3 world = mul(float4(input.pos.xyz, 1), sk_inst(id).world).xyz;
 	o.pos        = mul(float4(world,         1), sk_viewproj[o.view_id]);
 
 	o.uv    = input.uv;
@@ -49,12 +49,12 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	o.world = mul(float4(input.pos.xyz, 1), sk_inst[id].world).xyz;
+	o.world = mul(float4(input.pos.xyz, 1), sk_inst(id).world).xyz;
 	o.pos   = mul(float4(o.world,  1), sk_viewproj[o.view_id]);
 
-	o.normal     = normalize(mul(float4(input.norm, 0), sk_inst[id].world).xyz);
+	o.normal     = normalize(mul(float4(input.norm, 0), sk_inst(id).world).xyz);
 	o.uv         = (input.uv * tex_trans.zw) + tex_trans.xy;
-	o.color      = input.color * sk_inst[id].color * color;
+	o.color      = input.color * sk_inst(id).color * color;
 	o.irradiance = sk_lighting(o.normal);
 	o.view_dir   = sk_camera_pos[o.view_id].xyz - o.world;
 	return o;
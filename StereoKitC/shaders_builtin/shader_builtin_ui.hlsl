@@ -25,12 +25,12 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float3 normal = normalize(mul(input.norm, (float3x3) sk_inst[id].world));
-	float4 world  = mul(input.pos, sk_inst[id].world);
+	float3 normal = normalize(mul(input.norm, (float3x3) sk_inst(id).world));
+	float4 world  = mul(input.pos, sk_inst(id).world);
 	o.pos   = mul(world, sk_viewproj[o.view_id]);
 	o.world = world.xyz;
 	o.uv    = input.uv;
-	o.color = (color * input.color * sk_inst[id].color).rgb * sk_lighting(normal);
+	o.color = (color * input.color * sk_inst(id).color).rgb * sk_lighting(normal);
 	return o;
 }
 
@@ -24,7 +24,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	id        = id / sk_view_count;
 	
 	// Extract scale from the matrix
-	float4x4 world_mat = sk_inst[id].world;
+	float4x4 world_mat = sk_inst(id).world;
 	float3   scale     = float3(
 		length(float3(world_mat._11,world_mat._12,world_mat._13)),
 		length(float3(world_mat._21,world_mat._22,world_mat._23)),
@@ -40,13 +40,13 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	sized_pos.xy = input.pos.xy + input.quadrant * scale.xy * 0.5;
 	sized_pos.zw = input.pos.zw;
 	
-	sized_pos.xyz += input.norm * sk_inst[id].color.a * 0.002;
+	sized_pos.xyz += input.norm * sk_inst(id).color.a * 0.002;
 
 	float4 world = mul(sized_pos, world_mat);
 	float3 normal = normalize(mul(input.norm, (float3x3) world_mat));
 	o.pos   = mul(world, sk_viewproj[o.view_id]);
 	o.world = world.xyz;
-	o.color = lerp(color, sk_inst[id].color, input.color.a) * sk_lighting(normal);
+	o.color = lerp(color, sk_inst(id).color, input.color.a) * sk_lighting(normal);
 	return o;
 }
 
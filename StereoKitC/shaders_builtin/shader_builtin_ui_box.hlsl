@@ -31,7 +31,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	id        = id / sk_view_count;
 
 	// Extract scale from the matrix
-	float4x4 world_mat = sk_inst[id].world;
+	float4x4 world_mat = sk_inst(id).world;
 	float3   scale     = float3(
 		length(float3(world_mat._11,world_mat._12,world_mat._13)),
 		length(float3(world_mat._21,world_mat._22,world_mat._23)),
@@ -46,7 +46,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.pos   = mul(o.world,    sk_viewproj[o.view_id]);
 
 	o.uv    = input.uv-0.5;
-	o.color = color * input.col * sk_inst[id].color;
+	o.color = color * input.col * sk_inst(id).color;
 	return o;
 }
 float4 ps(psIn input) : SV_TARGET {
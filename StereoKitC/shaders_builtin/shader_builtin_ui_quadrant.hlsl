@@ -19,7 +19,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	id        = id / sk_view_count;
 	
 	// Extract scale from the matrix
-	float4x4 world_mat = sk_inst[id].world;
+	float4x4 world_mat = sk_inst(id).world;
 	float2   scale     = float2(
 		length(float3(world_mat._11,world_mat._12,world_mat._13)),
 		length(float3(world_mat._21,world_mat._22,world_mat._23))
@@ -37,7 +37,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	float4 world  = mul(sized_pos, world_mat);
 	o.pos    = mul(world, sk_viewproj[o.view_id]);
 	o.world  = world.xyz;
-	o.color.rgb = input.color.rgb * sk_inst[id].color.rgb * sk_lighting(normal);
+	o.color.rgb = input.color.rgb * sk_inst(id).color.rgb * sk_lighting(normal);
 	o.color.a   = input.color.a;
 	return o;
 }
@@ -29,11 +29,11 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	float4 world = mul(float4(input.pos.xyz, 1), sk_inst[id].world);
+	float4 world = mul(float4(input.pos.xyz, 1), sk_inst(id).world);
 	o.pos        = mul(world,                    sk_viewproj[o.view_id]);
 
 	o.uv    = (input.uv * tex_trans.zw) + tex_trans.xy;
-	o.color = input.col * color * sk_inst[id].color;
+	o.color = input.col * color * sk_inst(id).color;
 	return o;
 }
 
@@ -22,6 +22,8 @@
 #include "systems/line_drawer.h"
 #include "systems/world.h"
 #include "systems/defaults.h"
+#include "systems/jobs.h"
+#include "systems/profiler.h"
 #include "asset_types/animation.h"
 #include "platforms/_platform.h"
 #include "platforms/web.h"
@@ -64,6 +66,7 @@ struct sk_state_t {
 	uint64_t  app_init_time;
 	system_t *app_system;
 	int32_t   app_system_idx;
+	bool      app_zone;
 	quit_reason_ quit_reason;
 };
 static sk_state_t local;
@@ -144,6 +147,7 @@ bool32_t sk_init(sk_settings_t settings) {
 	log_diagf("Initializing StereoKit v%s...", sk_version_name());
 
 	stm_setup();
+	profiler_init();
 	sk_step_timer();
 	local.frame = 0;
 	rand_set_seed((uint32_t)stm_now());
@@ -200,8 +204,13 @@ bool32_t sk_init(sk_settings_t settings) {
 	sys_renderer.func_shutdown   = render_shutdown;
 	systems_add(&sys_renderer);
 
+	system_t sys_jobs = { "Jobs" };
+	sys_jobs.func_initialize = jobs_init;
+	sys_jobs.func_shutdown   = jobs_shutdown;
+	systems_add(&sys_jobs);
+
 	system_t sys_assets = { "Assets" };
-	system_set_initialize_deps(sys_assets, "Platform");
+	system_set_initialize_deps(sys_assets, "Platform", "Jobs");
 	system_set_step_deps      (sys_assets, "FrameRender");
 	sys_assets.func_initialize       = assets_init;
 	sys_assets.func_step             = assets_step;
@@ -209,7 +218,7 @@ bool32_t sk_init(sk_settings_t settings) {
 	systems_add(&sys_assets);
 
 	system_t sys_audio = { "Audio" };
-	system_set_initialize_deps(sys_audio, "Platform");
+	system_set_initialize_deps(sys_audio, "Platform", "Assets");
 	system_set_step_deps      (sys_audio, "Platform");
 	sys_audio.func_initialize = audio_init;
 	sys_audio.func_step       = audio_step;
@@ -311,6 +320,7 @@ void sk_shutdown_unsafe(void) {
 	log_show_any_fail_reason();
 
 	systems_shutdown      ();
+	profiler_shutdown     ();
 	sk_mem_log_allocations();
 	log_clear_subscribers ();
 
@@ -334,14 +344,18 @@ void sk_first_step() {
 
 void sk_step_begin() {
 	local.in_step = true;
+	profiler_frame_begin();
 	sk_step_timer();
 	systems_step_partial(system_run_before, local.app_system_idx);
 	local.app_system->profile_frame_start = stm_now();
+	local.app_zone = profiler_zone_push(local.app_system->name);
 }
 
 ///////////////////////////////////////////
 
 bool32_t sk_step_end() {
+	if (local.app_zone) profiler_zone_pop();
+	local.app_zone = false;
 	local.app_system->profile_step_duration += stm_since(local.app_system->profile_frame_start);
 	local.app_system->profile_step_count += 1;
 
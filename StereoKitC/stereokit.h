@@ -796,6 +796,11 @@ SK_DeclarePrivateType(solid_t);
 SK_DeclarePrivateType(anchor_t);
 SK_DeclarePrivateType(render_list_t);
 
+// Identifies a persistent render list item. This packs the item's slot with a
+// generation counter, so ids from removed items are rejected rather than
+// affecting whatever reuses their slot. -1 is never a valid id.
+typedef int32_t render_item_id_t;
+
 ///////////////////////////////////////////
 
 typedef struct gradient_key_t {
@@ -888,6 +893,11 @@ SK_API void        mesh_update_skin     (mesh_t mesh, const matrix *in_arr_bone_
 // TODO: in 0.4 move cull_mode parameter up to directly after out_pt (both functions)
 SK_API bool32_t    mesh_ray_intersect   (mesh_t mesh, ray_t model_space_ray, ray_t* out_pt, uint32_t* out_start_inds sk_default(nullptr), cull_ cull_mode sk_default(cull_back));
 SK_API bool32_t    mesh_ray_intersect_bvh(mesh_t mesh, ray_t model_space_ray, ray_t* out_pt, uint32_t* out_start_inds sk_default(nullptr), cull_ cull_mode sk_default(cull_back));
+SK_API int32_t     mesh_ray_intersect_bvh_batch(mesh_t mesh, const ray_t *in_arr_model_space_rays, int32_t ray_count, ray_t *out_arr_hits, bool32_t *out_arr_hit_results sk_default(nullptr), cull_ cull_mode sk_default(cull_back));
+SK_API void        mesh_set_bvh_async   (mesh_t mesh, bool32_t async);
+SK_API bool32_t    mesh_get_bvh_async   (mesh_t mesh);
+SK_API void        mesh_set_collision_planes(mesh_t mesh, bool32_t store_planes);
+SK_API bool32_t    mesh_get_collision_planes(mesh_t mesh);
 SK_API bool32_t    mesh_get_triangle    (mesh_t mesh, uint32_t triangle_index, vert_t* out_a, vert_t* out_b, vert_t* out_c);
 
 SK_API mesh_t      mesh_gen_plane       (vec2 dimensions, vec3 plane_normal, vec3 plane_top_direction, int32_t subdivisions sk_default(0), bool32_t double_sided sk_default(false));
@@ -1541,6 +1551,7 @@ SK_API bool32_t      model_ray_intersect           (model_t model, ray_t model_s
 SK_API bool32_t      model_ray_intersect_bvh       (model_t model, ray_t model_space_ray, ray_t *out_pt, cull_ cull_mode sk_default(cull_back));
 // TODO: in 0.4 move cull_mode parameter up to directly after out_pt
 SK_API bool32_t      model_ray_intersect_bvh_detailed(model_t model, ray_t model_space_ray, ray_t *out_pt, mesh_t *out_mesh sk_default(nullptr), matrix *out_matrix sk_default(nullptr), uint32_t* out_start_inds sk_default(nullptr), cull_ cull_mode sk_default(cull_back));
+SK_API int32_t       model_ray_intersect_bvh_batch (model_t model, const ray_t *in_arr_model_space_rays, int32_t ray_count, ray_t *out_arr_hits, bool32_t *out_arr_hit_results sk_default(nullptr), cull_ cull_mode sk_default(cull_back));
 
 SK_API void          model_step_anim               (model_t model);
 SK_API bool32_t      model_play_anim               (model_t model, const char *animation_name, anim_mode_ mode);
@@ -1555,6 +1566,8 @@ SK_API float         model_anim_active_time        (model_t model);
 SK_API float         model_anim_active_completion  (model_t model);
 SK_API const char*   model_anim_get_name           (model_t model, int32_t index);
 SK_API float         model_anim_get_duration       (model_t model, int32_t index);
+SK_API void          model_set_gpu_skinning        (model_t model, bool32_t gpu_skinning);
+SK_API bool32_t      model_get_gpu_skinning        (model_t model);
 
 // TODO: this whole section gets removed in v0.4, prefer the model_node api
 SK_API const char*   model_get_name                (model_t model, int32_t subset);
@@ -1686,6 +1699,41 @@ typedef enum projection_ {
 	projection_ortho = 1
 } projection_;
 
+/*A summary of the renderer's work, either over a whole frame, or for a
+  single render list. Every draw of a list adds to these, so stereo views,
+  screenshots, viewpoints and render_to calls all contribute.*/
+typedef struct render_stats_t {
+	/*Bytes of per-instance data uploaded to the GPU for drawing.*/
+	int64_t instance_bytes;
+	/*Bytes of texture data uploaded to the GPU.*/
+	int64_t texture_bytes;
+	/*Bytes of vertex, index and bone data uploaded to the GPU.*/
+	int64_t mesh_bytes;
+	/*GPU time spent drawing render lists, in milliseconds. This trails the
+	  CPU by a few frames, and is -1 where the graphics backend can't
+	  measure it.*/
+	float   gpu_ms;
+	/*Items in the list when it was prepared for drawing, including
+	  persistent items.*/
+	int32_t items_queued;
+	/*Items skipped because no view could see them.*/
+	int32_t items_culled;
+	/*Items that needed a full sort.*/
+	int32_t items_sorted;
+	/*Sorts skipped because last frame's order was still valid.*/
+	int32_t sort_reused;
+	/*Sorts that needed the full radix sort.*/
+	int32_t sort_radix;
+	/*Draw calls submitted to the GPU.*/
+	int32_t draw_calls;
+	/*Instances drawn across all draw calls.*/
+	int32_t draw_instances;
+	/*How many times a new mesh was bound.*/
+	int32_t swaps_mesh;
+	/*How many times a new material was bound.*/
+	int32_t swaps_material;
+} render_stats_t;
+
 //TODO: for v0.4, rename render_set_clip and render_set_fov to indicate they are only for perspective
 SK_API void                  render_set_clip       (float near_plane sk_default(0.08f), float far_plane sk_default(50));
 SK_API void                  render_set_fov        (float field_of_view_degrees sk_default(90.0f));
@@ -1727,10 +1775,14 @@ SK_API void                  render_screenshot_pose(const char *file_utf8, int32
 //TODO: for v0.4, reorder parameters, context in particular should be next to callback
 SK_API void                  render_screenshot_capture  (void (*render_on_screenshot_callback)(color32* color_buffer, int32_t width, int32_t height, void* context), pose_t viewpoint, int32_t width, int32_t height, float field_of_view_degrees, tex_format_ tex_format sk_default(tex_format_rgba32), void *context sk_default(nullptr));
 SK_API void                  render_screenshot_viewpoint(void (*render_on_screenshot_callback)(color32* color_buffer, int32_t width, int32_t height, void* context), matrix camera, matrix projection, int32_t width, int32_t height, render_layer_ layer_filter sk_default(render_layer_all), render_clear_ clear sk_default(render_clear_all), rect_t viewport sk_default(rect_t{}), tex_format_ tex_format sk_default(tex_format_rgba32), void* context sk_default(nullptr));
+SK_API void                  render_screenshot_file     (const char *file_utf8, int32_t file_quality_100, matrix camera, matrix projection, int32_t width, int32_t height, render_layer_ layer_filter sk_default(render_layer_all), render_clear_ clear sk_default(render_clear_all), rect_t viewport sk_default(rect_t{}), void (*on_saved)(const char *file_utf8, bool32_t success, void *context) sk_default(nullptr), void *context sk_default(nullptr));
 SK_API void                  render_to             (tex_t to_rendertarget, const sk_ref(matrix) camera, const sk_ref(matrix) projection, render_layer_ layer_filter sk_default(render_layer_all), render_clear_ clear sk_default(render_clear_all), rect_t viewport sk_default({}));
 SK_API void                  render_material_to    (tex_t to_rendertarget, material_t override_material, const sk_ref(matrix) camera, const sk_ref(matrix) projection, render_layer_ layer_filter sk_default(render_layer_all), render_clear_ clear sk_default(render_clear_all), rect_t viewport sk_default({}));
 SK_API void                  render_get_device     (void **device, void **context);
 SK_API render_list_t         render_get_primary_list(void);
+SK_API render_stats_t        render_get_stats      (int32_t frames_ago sk_default(0));
+SK_API int32_t               render_get_stats_history(void);
+SK_API render_stats_t        render_get_layer_stats(render_layer_ layer);
 
 ///////////////////////////////////////////
 
@@ -1744,10 +1796,17 @@ SK_API void                  render_list_release      (      render_list_t list)
 SK_API void                  render_list_clear        (      render_list_t list);
 SK_API int32_t               render_list_item_count   (const render_list_t list);
 SK_API int32_t               render_list_prev_count   (const render_list_t list);
+SK_API render_stats_t        render_list_get_stats    (const render_list_t list);
 SK_API void                  render_list_add_mesh     (      render_list_t list, mesh_t  mesh,  material_t material,          matrix world_transform, color128 color_linear, render_layer_ layer);
 SK_API void                  render_list_add_model    (      render_list_t list, model_t model,                               matrix world_transform, color128 color_linear, render_layer_ layer);
 SK_API void                  render_list_add_model_mat(      render_list_t list, model_t model, material_t material_override, matrix world_transform, color128 color_linear, render_layer_ layer);
 SK_API void                  render_list_draw_now     (      render_list_t list, tex_t to_rendertarget, matrix camera, matrix projection, color128 clear_color sk_default({ 0,0,0,0 }), render_clear_ clear sk_default(render_clear_all), rect_t viewport_pct sk_default({}), render_layer_ layer_filter sk_default(render_layer_all));
+SK_API void                  render_list_add_shard    (      render_list_t list, render_list_t shard);
+SK_API void                  render_list_remove_shard (      render_list_t list, render_list_t shard);
+SK_API render_item_id_t      render_list_persist_mesh (      render_list_t list, mesh_t  mesh,  material_t material,          matrix world_transform, color128 color_linear, render_layer_ layer);
+SK_API void                  render_list_persist_set_transform(render_list_t list, render_item_id_t item, matrix world_transform);
+SK_API void                  render_list_persist_set_color    (render_list_t list, render_item_id_t item, color128 color_linear);
+SK_API void                  render_list_persist_remove       (render_list_t list, render_item_id_t item);
 
 SK_API void                  render_list_push         (      render_list_t list);
 SK_API void                  render_list_pop          (void);
@@ -1796,14 +1855,21 @@ SK_API void         sound_set_id         (sound_t sound, const char *id);
 SK_API const char*  sound_get_id         (const sound_t sound);
 SK_API sound_t      sound_create         (const char *filename_utf8);
 SK_API sound_t      sound_create_stream  (float buffer_duration);
+SK_API sound_t      sound_create_stream_lockfree(float buffer_duration);
 SK_API sound_t      sound_create_samples (const float *in_arr_samples_at_48000s, uint64_t sample_count);
 SK_API sound_t      sound_generate       (float (*audio_generator)(float sample_time), float duration);
 SK_API void         sound_write_samples  (sound_t sound, const float *in_arr_samples,  uint64_t sample_count);
 SK_API uint64_t     sound_read_samples   (sound_t sound, float       *out_arr_samples, uint64_t sample_count);
 SK_API uint64_t     sound_unread_samples (sound_t sound);
+SK_API uint64_t     sound_stream_get_overruns (sound_t sound);
+SK_API uint64_t     sound_stream_get_underruns(sound_t sound);
 SK_API uint64_t     sound_total_samples  (sound_t sound);
 SK_API uint64_t     sound_cursor_samples (sound_t sound);
 SK_API sound_inst_t sound_play           (sound_t sound, vec3 at, float volume);
+SK_API void         sound_set_priority   (sound_t sound, int32_t priority);
+SK_API int32_t      sound_get_priority   (sound_t sound);
+SK_API void         sound_set_cache_budget(uint64_t bytes);
+SK_API uint64_t     sound_get_cache_budget(void);
 SK_API float        sound_duration       (sound_t sound);
 SK_API void         sound_addref         (sound_t sound);
 SK_API void         sound_release        (sound_t sound);
@@ -2358,6 +2424,7 @@ SK_API pose_t         world_from_perception_anchor    (void *perception_spatial_
 SK_API bool32_t       world_try_from_spatial_graph    (uint8_t spatial_graph_node_id[16], bool32_t dynamic, int64_t qpc_time, pose_t *out_pose);
 SK_API bool32_t       world_try_from_perception_anchor(void *perception_spatial_anchor,   pose_t *out_pose);
 SK_API bool32_t       world_raycast                   (ray_t ray, ray_t *out_intersection);
+SK_API int32_t        world_raycast_batch             (const ray_t *in_arr_rays, int32_t ray_count, ray_t *out_arr_intersections, bool32_t *out_arr_hit_results sk_default(nullptr));
 SK_API void           world_set_occlusion_enabled     (bool32_t enabled);
 SK_API bool32_t       world_get_occlusion_enabled     (void);
 SK_API void           world_set_raycast_enabled       (bool32_t enabled);
@@ -2429,6 +2496,10 @@ typedef enum backend_graphics_ {
 	backend_graphics_opengles_egl,
 	/*WebGL is used for rendering. This is used by default on Web.*/
 	backend_graphics_webgl,
+	/*No GPU is used at all! Draw calls and uploads are accepted and counted,
+	  but nothing is rendered. This is only available when StereoKit is built
+	  with SK_GPU_NULL, and is intended for headless CPU-side benchmarking.*/
+	backend_graphics_null,
 } backend_graphics_;
 
 typedef uint64_t openxr_handle_t;
@@ -2473,6 +2544,31 @@ SK_API void             *backend_opengl_egl_get_context        (void);
 SK_API void             *backend_opengl_egl_get_config         (void);
 SK_API void             *backend_opengl_egl_get_display        (void);
 
+/*Work counted by the null graphics backend, backend_graphics_null, since
+  StereoKit started or the last backend_null_reset_stats. Nothing reaches a
+  GPU, but this is what would have.*/
+typedef struct backend_null_stats_t {
+	/*Draw calls issued.*/
+	int64_t draw_calls;
+	/*Instances across all draw calls.*/
+	int64_t instances;
+	/*Indices across all draw calls, multiplied by their instance counts.*/
+	int64_t indices;
+	/*Bytes uploaded into buffers, at creation or from updates.*/
+	int64_t buffer_bytes;
+	/*Bytes uploaded into textures.*/
+	int64_t texture_bytes;
+	/*Buffers created.*/
+	int64_t buffers_created;
+	/*Textures created.*/
+	int64_t textures_created;
+	/*Frames presented.*/
+	int64_t frames;
+} backend_null_stats_t;
+
+SK_API backend_null_stats_t backend_null_get_stats         (void);
+SK_API void                 backend_null_reset_stats       (void);
+
 ///////////////////////////////////////////
 
 /*The log tool will write to the console with annotations for console
@@ -2506,6 +2602,31 @@ SK_API void log_unsubscribe_data(void (*log_callback)(void* context, log_ level,
 
 ///////////////////////////////////////////
 
+/*Enables or disables the profiler. This takes effect at the start of the
+  next frame, and while disabled, zones cost very little.*/
+SK_API void     profiler_set_enabled(bool32_t enabled);
+SK_API bool32_t profiler_get_enabled(void);
+/*A pre-registered zone name, from profiler_zone_name. 0 is never valid.*/
+typedef uint64_t profiler_zone_id_t;
+
+/*Begins a named timing zone on the current thread. Zones nest, and each
+  begin must be paired with a profiler_zone_end on the same thread. This
+  looks the name up each time, so for hot code, get an id from
+  profiler_zone_name once and use profiler_zone_begin_id instead.*/
+SK_API void     profiler_zone_begin (const char *name_utf8);
+/*Registers a zone name, and returns an id that can begin zones without
+  any lookups or locks. Ids are valid until StereoKit shuts down, and this
+  returns 0 if called before StereoKit is initialized.*/
+SK_API profiler_zone_id_t profiler_zone_name(const char *name_utf8);
+SK_API void     profiler_zone_begin_id(profiler_zone_id_t zone);
+SK_API void     profiler_zone_end   (void);
+/*Writes the most recent few hundred frames of profiling data out as a
+  Chrome trace JSON file, which can be opened in Perfetto or
+  chrome://tracing.*/
+SK_API bool32_t profiler_save_trace (const char *filename_utf8);
+
+///////////////////////////////////////////
+
 /*A flag for what 'type' an Asset may store.*/
 typedef enum asset_type_ {
 	/*No type, this may come from some kind of invalid Asset id.*/
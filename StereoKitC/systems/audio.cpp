@@ -1,22 +1,33 @@
 #include "audio.h"
+#include "audio_decode.h"
 #include "../asset_types/sound.h"
 
 #include "../sk_memory.h"
 #include "../sk_math.h"
+#include "../sk_math_dx.h"
 #include "../platforms/platform.h"
 
 #include "../libraries/stref.h"
+#include "../libraries/atomic_util.h"
 #include "../libraries/isac_spatial_sound.h"
 
 #include <string.h>
 #include <assert.h>
 
+using namespace DirectX;
+
 namespace sk {
 
-_sound_inst_t     au_active_sounds[8] = {};
+au_voice_t        au_voices[AU_VOICE_SLOTS] = {};
+int32_t           au_voice_end      = 0; // One past the highest slot ever used
 matrix            au_head_transform;
 const int32_t     au_mix_temp_size = 4096;
 float*            au_mix_temp;
+float*            au_mix_bus;        // Stereo float accumulator, au_mix_temp_size frames
+
+// Voices quieter than this on both ears (about -80dB) are skipped by the
+// mixer, they still advance so they end on time.
+const float       au_audible_gain   = 0.0001f;
 
 ma_context        au_context        = {};
 ma_decoder_config au_decoder_config = {};
@@ -27,6 +38,11 @@ sound_t           au_mic_sound      = {};
 char             *au_mic_name       = nullptr;
 bool              au_recording      = false;
 bool              au_paused         = false;
+bool              au_isac           = false;
+
+// Windows Sonic has a limited number of dynamic objects, so ISAC only gets
+// this many of the voices.
+const int32_t     au_isac_sources   = 8;
 
 ///////////////////////////////////////////
 
@@ -49,117 +65,206 @@ void audio_set_default_device_in(const wchar_t *device_id) {
 
 ///////////////////////////////////////////
 
-ma_uint32 read_and_mix_pcm_frames_f32(_sound_inst_t &inst, float *output, ma_uint64 frame_count) {
-	const uint64_t channel_count = 2;
+// Reads the next set of mono samples for this voice, and moves its cursor
+// forward. Returns the number of samples read, which is less than requested
+// when the voice runs out of data.
+ma_uint64 au_voice_read(au_voice_t &voice, float *out_samples, ma_uint64 sample_count) {
+	sound_t   sound = voice.sound;
+	ma_uint64 read  = 0;
+	switch (sound->type) {
+	case sound_type_decode: {
+		// Nothing is ever decoded here, it's either a copy out of the cache,
+		// or out of the decode thread's ring.
+		if (voice.pcm != nullptr) {
+			read = mini(sample_count, voice.pcm->count - voice.cursor);
+			memcpy(out_samples, voice.pcm->samples+voice.cursor, (size_t)read * sizeof(float));
+		} else {
+			read = audio_stream_read(voice.stream, out_samples, sample_count);
+		}
+	} break;
+	case sound_type_stream: {
+		// The mixer is the stream's only consumer while it plays, so it
+		// reads without ever taking a lock.
+		read = sound_stream_read_mixer(sound, out_samples, sample_count);
+	} break;
+	case sound_type_buffer: {
+		read = mini(sample_count, sound->buffer.count - voice.cursor);
+		memcpy(out_samples, sound->buffer.data+voice.cursor, (size_t)read * sizeof(float));
+	} break;
+	case sound_type_none: {
+		log_errf("Got a sound_type_none?");
+	} break;
+	}
+	voice.cursor += read;
+	return read;
+}
 
-	// The way mixing works is that we just read into a temporary buffer, 
-	// then take the contents of that buffer and mix it with the contents of
-	// the output buffer by simply adding the samples together.
-	vec3      head_pos          = input_head()->position;
-	vec3      head_right        = vec3_normalize(input_head()->orientation * vec3_right);
-	ma_uint64 frame_cap         = au_mix_temp_size / channel_count;
-	ma_uint64 total_frames_read = 0;
+///////////////////////////////////////////
 
-	while (total_frames_read < frame_count) {
-		ma_uint64 frames_remaining = frame_count - total_frames_read;
-		ma_uint64 frames_to_read   = frame_cap;
-		if (frames_to_read > frames_remaining) {
-			frames_to_read = frames_remaining;
-		}
+// Skips ahead in the voice without producing any audio, for voices that are
+// too quiet to hear.
+ma_uint64 au_voice_skip(au_voice_t &voice, ma_uint64 sample_count) {
+	if (voice.sound->type == sound_type_buffer || voice.pcm != nullptr) {
+		uint64_t  count   = voice.pcm != nullptr ? voice.pcm->count : voice.sound->buffer.count;
+		ma_uint64 skipped = mini(sample_count, count - voice.cursor);
+		voice.cursor += skipped;
+		return skipped;
+	}
+	// Decode and sound streams have to be read to move forward
+	return au_voice_read(voice, au_mix_temp, sample_count);
+}
 
-		// Grab sound samples!
-		ma_uint64 frames_read = 0;
-		switch (inst.sound->type) {
-		case sound_type_decode: {
-			if (ma_decoder_read_pcm_frames(&inst.sound->decoder, au_mix_temp, frames_to_read, &frames_read) != MA_SUCCESS) {
-				log_err("Failed to read PCM frames for mixing!");
-			}
-		} break;
-		case sound_type_stream: {
-			frames_read = sound_read_samples(inst.sound, au_mix_temp, frames_to_read);
-		} break;
-		case sound_type_buffer: {
-			frames_read = mini(frames_to_read, inst.sound->buffer.count - inst.sound->buffer.cursor);
-			memcpy(au_mix_temp, inst.sound->buffer.data+inst.sound->buffer.cursor, (size_t)frames_read * sizeof(float));
-			inst.sound->buffer.cursor += frames_read;
-		} break;
-		case sound_type_none: {
-			log_errf("Got a sound_type_none?");
-		} break;
-		}
-		if (frames_read <= 1) break;
+///////////////////////////////////////////
 
-		//// Mix the sound samples in
-
-		// Calculate the volume based on distance using the 1/d^2 law
-		vec3  dir    = head_pos - inst.position;
-		float dist2  = vec3_magnitude_sq(dir);
-		float volume = fminf(1,(1.f / dist2) * inst.volume);
-
-		// Find the direction of the sound in relation to the head
-		dir = dir / sqrtf(dist2);
-		float dot = vec3_dot(dir, head_right);
-
-		// Calculate a panning volume where a sound source directly in front
-		// will have a volume of 1 for both ears, and a sound directly to 
-		// either side will have a volume of zero opposite it
-		float channel[2] = { fminf(1,dot+1), fminf(1,2-(dot+1)) };
-
-		// Create a sample offset to simulate sound arrival time difference
-		// between left and right ears.
-		// NOTE: This needs a buffer of 10 samples before and after the
-		// relevant range, otherwise it sparkles!!
-		// The speed of sound is 343 m/s, and average head width is .15m
-		// (head_width/speed_of_sound)*48,000 samples/s = 21 audio samples wide
-		//int64_t offset[2] = { (int64_t)(10 * dot), (int64_t)(-10 * dot) };
-
-		// Mix the frames together.
-		for (ma_uint64 sample = 0; sample < frames_read; ++sample) {
-			ma_uint64 i = total_frames_read * channel_count + sample*channel_count;
-			float     s = au_mix_temp[sample] * volume;
-
-			// Right channel
-			//float     s = au_mix_temp[mini((int64_t)_countof(au_mix_temp)-1,maxi((int64_t)0,sample+offset[c]))] * volume *  channel[0];
-			output[i] = fmaxf(-1, fminf(1, output[i] + s*channel[0]));
-
-			// Left channel
-			//s = au_mix_temp[mini((int64_t)_countof(au_mix_temp)-1,maxi((int64_t)0,sample+offset[c]))] * volume *  channel[1];
-			i += 1;
-			output[i] = fmaxf(-1, fminf(1, output[i] + s*channel[1]));
-		}
+// Adds a mono block into the stereo bus, with each ear's gain ramping
+// linearly from start to end across the block so changes in volume or
+// position don't step, and zipper.
+void au_mix_mono_to_stereo(float *bus, const float *src, ma_uint64 frame_count, const float gain_start[2], const float gain_end[2]) {
+	const float step_l = (gain_end[0] - gain_start[0]) / (float)frame_count;
+	const float step_r = (gain_end[1] - gain_start[1]) / (float)frame_count;
+
+	// Four frames per loop, gain_a covers the first two frames and gain_b
+	// the other two, as LRLR.
+	XMVECTOR gain_a = XMVectorSet(gain_start[0], gain_start[1], gain_start[0] + step_l, gain_start[1] + step_r);
+	XMVECTOR gain_b = XMVectorAdd(gain_a, XMVectorSet(2*step_l, 2*step_r, 2*step_l, 2*step_r));
+	XMVECTOR step   = XMVectorSet(4*step_l, 4*step_r, 4*step_l, 4*step_r);
+
+	ma_uint64 f = 0;
+	for (; f + 4 <= frame_count; f += 4) {
+		XMVECTOR samples = XMLoadFloat4((const XMFLOAT4*)&src[f]);
+		float   *out     = &bus[f*2];
+		XMStoreFloat4((XMFLOAT4*)&out[0], XMVectorMultiplyAdd(XMVectorMergeXY(samples, samples), gain_a, XMLoadFloat4((const XMFLOAT4*)&out[0])));
+		XMStoreFloat4((XMFLOAT4*)&out[4], XMVectorMultiplyAdd(XMVectorMergeZW(samples, samples), gain_b, XMLoadFloat4((const XMFLOAT4*)&out[4])));
+		gain_a = XMVectorAdd(gain_a, step);
+		gain_b = XMVectorAdd(gain_b, step);
+	}
+	for (; f < frame_count; f++) {
+		bus[f*2  ] += src[f] * (gain_start[0] + step_l * f);
+		bus[f*2+1] += src[f] * (gain_start[1] + step_r * f);
+	}
+}
 
-		total_frames_read += frames_read;
-		if (frames_read < frames_to_read) {
-			break;  // Reached EOF.
-		}
+///////////////////////////////////////////
+
+// Clamps the bus into the device's output, once for all voices.
+void au_mix_resolve(float *output, const float *bus, ma_uint64 sample_count) {
+	const XMVECTOR lo = XMVectorReplicate(-1);
+	const XMVECTOR hi = XMVectorReplicate( 1);
+
+	ma_uint64 i = 0;
+	for (; i + 4 <= sample_count; i += 4)
+		XMStoreFloat4((XMFLOAT4*)&output[i], XMVectorClamp(XMLoadFloat4((const XMFLOAT4*)&bus[i]), lo, hi));
+	for (; i < sample_count; i++)
+		output[i] = fmaxf(-1, fminf(1, bus[i]));
+}
+
+///////////////////////////////////////////
+
+// Works out the per-ear gain for a voice from where it is relative to the
+// listener.
+void au_voice_gain(const au_voice_t &inst, vec3 head_pos, vec3 head_right, float *out_gain) {
+	// Calculate the volume based on distance using the 1/d^2 law
+	vec3  dir    = head_pos - inst.position;
+	float dist2  = fmaxf(0.0001f, vec3_magnitude_sq(dir));
+	float volume = fminf(1,(1.f / dist2) * inst.volume);
+
+	// Find the direction of the sound in relation to the head
+	dir = dir / sqrtf(dist2);
+	float dot = vec3_dot(dir, head_right);
+
+	// Calculate a panning volume where a sound source directly in front
+	// will have a volume of 1 for both ears, and a sound directly to 
+	// either side will have a volume of zero opposite it
+	out_gain[0] = volume * fminf(1,dot+1);
+	out_gain[1] = volume * fminf(1,2-(dot+1));
+
+	// Create a sample offset to simulate sound arrival time difference
+	// between left and right ears.
+	// NOTE: This needs a buffer of 10 samples before and after the
+	// relevant range, otherwise it sparkles!!
+	// The speed of sound is 343 m/s, and average head width is .15m
+	// (head_width/speed_of_sound)*48,000 samples/s = 21 audio samples wide
+	//int64_t offset[2] = { (int64_t)(10 * dot), (int64_t)(-10 * dot) };
+}
+
+///////////////////////////////////////////
+
+// Called from the audio thread before mixing a voice. Returns false if the
+// voice shouldn't be mixed, and acknowledges any stop requests.
+inline bool au_voice_begin_mix(au_voice_t &voice) {
+	int32_t state = voice.state;
+	if (state == au_voice_state_stopping) {
+		voice.state = au_voice_state_finished;
+		return false;
 	}
+	return state == au_voice_state_playing;
+}
+
+///////////////////////////////////////////
 
-	return (ma_uint32)total_frames_read;
+// Called from the audio thread after reading from a voice. Streams stay alive
+// even when they run dry, since more data may still arrive, and decode
+// streams only end once the decode thread has hit the end of the file.
+inline void au_voice_end_mix(au_voice_t &voice, ma_uint64 read, ma_uint64 requested) {
+	if (read >= requested || voice.sound->type == sound_type_stream)
+		return;
+	if (voice.stream != nullptr && !audio_stream_finished(voice.stream))
+		return;
+	voice.state = au_voice_state_finished;
 }
 
 ///////////////////////////////////////////
 
 void data_callback(ma_device*, void* output, const void*, ma_uint32 frame_count) {
-	float* output_f = (float*)output;
-
-	for (uint32_t i = 0; i < _countof(au_active_sounds); i++) {
-		if (au_active_sounds[i].sound == nullptr)
-			continue;
+	const uint64_t channel_count = 2;
+	float*         output_f      = (float*)output;
+	int32_t        end           = au_voice_end;
+	vec3           head_pos      = input_head()->position;
+	vec3           head_right    = vec3_normalize(input_head()->orientation * vec3_right);
+
+	// Every voice is summed into a float bus one block at a time, and only
+	// the final result gets clamped.
+	ma_uint64 block_cap = au_mix_temp_size;
+	for (ma_uint64 block_start = 0; block_start < frame_count; block_start += block_cap) {
+		ma_uint64 block_frames = frame_count - block_start < block_cap ? frame_count - block_start : block_cap;
+		memset(au_mix_bus, 0, (size_t)(block_frames * channel_count * sizeof(float)));
+
+		for (int32_t i = 0; i < end; i++) {
+			au_voice_t &voice = au_voices[i];
+			if (!au_voice_begin_mix(voice))
+				continue;
+
+			float gain[2];
+			au_voice_gain(voice, head_pos, head_right, gain);
+			if (!voice.gain_set) {
+				voice.gain[0]  = gain[0];
+				voice.gain[1]  = gain[1];
+				voice.gain_set = true;
+			}
 
-		ma_uint32 framesRead = read_and_mix_pcm_frames_f32(au_active_sounds[i], output_f, frame_count);
-		if (framesRead < frame_count && au_active_sounds[i].sound->type != sound_type_stream) {
-			sound_release(au_active_sounds[i].sound);
-			au_active_sounds[i].sound = nullptr;
+			ma_uint64 frames_read;
+			if (fmaxf(fmaxf(gain[0], gain[1]), fmaxf(voice.gain[0], voice.gain[1])) < au_audible_gain) {
+				frames_read = au_voice_skip(voice, block_frames);
+			} else {
+				frames_read = au_voice_read(voice, au_mix_temp, block_frames);
+				if (frames_read > 0)
+					au_mix_mono_to_stereo(au_mix_bus, au_mix_temp, frames_read, voice.gain, gain);
+			}
+			voice.gain[0] = gain[0];
+			voice.gain[1] = gain[1];
+			au_voice_end_mix(voice, frames_read, block_frames);
 		}
+
+		au_mix_resolve(&output_f[block_start * channel_count], au_mix_bus, block_frames * channel_count);
 	}
 }
 
 ///////////////////////////////////////////
 
-ma_uint64 read_data_for_isac(_sound_inst_t& inst, float* output, ma_uint64 frame_count, vec3* position, float* volume) {
+ma_uint64 read_data_for_isac(au_voice_t& inst, float* output, ma_uint64 frame_count, vec3* position, float* volume) {
 	// Set the position and volume for this object. ISAC applies this directly for us
-	*position = matrix_transform_pt(au_head_transform, inst.position);
-	*volume   = inst.volume;
+	if (position != nullptr) *position = matrix_transform_pt(au_head_transform, inst.position);
+	if (volume   != nullptr) *volume   = inst.volume;
 
 	ma_uint64 frame_cap         = au_mix_temp_size;
 	ma_uint64 total_frames_read = 0;
@@ -171,29 +276,12 @@ ma_uint64 read_data_for_isac(_sound_inst_t& inst, float* output, ma_uint64 frame
 			frames_to_read = frames_remaining;
 		}
 
-		ma_uint64 frames_read = 0;
-		switch (inst.sound->type) {
-		case sound_type_decode: {
-			if (ma_decoder_read_pcm_frames(&inst.sound->decoder, au_mix_temp, frames_to_read, &frames_read) != MA_SUCCESS) {
-				log_err("Failed to read PCM frames for ISAC!");
-			}
-		} break;
-		case sound_type_stream: {
-			frames_read = sound_read_samples(inst.sound, au_mix_temp, frames_to_read);
-		} break;
-		case sound_type_buffer: {
-			frames_read = mini(frames_to_read, inst.sound->buffer.count - inst.sound->buffer.cursor);
-			memcpy(au_mix_temp, inst.sound->buffer.data+inst.sound->buffer.cursor, (size_t)frames_read * sizeof(float));
-			inst.sound->buffer.cursor += frames_read;
-		} break;
-		case sound_type_none: {
-			log_errf("Got a sound_type_none?");
-		} break;
-		}
+		ma_uint64 frames_read = au_voice_read(inst, au_mix_temp, frames_to_read);
 		if (frames_read <= 1) break;
 
 		// Read the data into the buffer provided by ISAC
-		memcpy(&output[total_frames_read], au_mix_temp, (size_t)frames_read * sizeof(float));
+		if (output != nullptr)
+			memcpy(&output[total_frames_read], au_mix_temp, (size_t)frames_read * sizeof(float));
 
 		total_frames_read += frames_read;
 		if (frames_read < frames_to_read) {
@@ -207,20 +295,174 @@ ma_uint64 read_data_for_isac(_sound_inst_t& inst, float* output, ma_uint64 frame
 ///////////////////////////////////////////
 
 void isac_data_callback(float** sourceBuffers, uint32_t numSources, uint32_t numFrames, vec3* positions, float* volumes) {
-	// Assert on debug builds, eliminate warning on release builds
-	//UNREFERENCED_PARAMETER(numSources);
-	assert(numSources == _countof(au_active_sounds));
+	int32_t  end    = au_voice_end;
+	uint32_t source = 0;
 
-	for (uint32_t i = 0; i < _countof(au_active_sounds); i++) {
-		if (au_active_sounds[i].sound == nullptr)
+	for (int32_t i = 0; i < end; i++) {
+		au_voice_t &voice = au_voices[i];
+		if (!au_voice_begin_mix(voice))
 			continue;
 
-		ma_uint64 framesRead = read_data_for_isac(au_active_sounds[i], sourceBuffers[i], numFrames, &positions[i], &volumes[i]);
-		if (framesRead < numFrames && au_active_sounds[i].sound->type != sound_type_stream) {
-			sound_release(au_active_sounds[i].sound);
-			au_active_sounds[i].sound = nullptr;
+		// Voices past the number of ISAC objects still advance so they stay
+		// in sync and finish on time, they just aren't heard.
+		ma_uint64 frames_read = source < numSources
+			? read_data_for_isac(voice, sourceBuffers[source], numFrames, &positions[source], &volumes[source])
+			: read_data_for_isac(voice, nullptr,               numFrames, nullptr,           nullptr);
+		source += 1;
+		au_voice_end_mix(voice, frames_read, numFrames);
+	}
+}
+
+///////////////////////////////////////////
+// Voice pool                            //
+///////////////////////////////////////////
+
+// How loud a voice would be at the listener's position, used to decide which
+// voices get stolen first.
+float au_voice_audibility(vec3 head_pos, vec3 position, float volume) {
+	float dist2 = fmaxf(0.0001f, vec3_magnitude_sq(head_pos - position));
+	return volume / dist2;
+}
+
+///////////////////////////////////////////
+
+void au_voice_reclaim(au_voice_t &voice) {
+	if (voice.pcm != nullptr) {
+		audio_pcm_release(voice.pcm);
+		voice.pcm = nullptr;
+	}
+	if (voice.stream != nullptr) {
+		audio_stream_destroy(voice.stream);
+		voice.stream = nullptr;
+	}
+	if (voice.sound->last_inst._id == voice.id && &au_voices[voice.sound->last_inst._slot] == &voice)
+		voice.sound->buffer.cursor = voice.cursor;
+	// The audio thread is done with the voice, so the app can read again.
+	if (voice.sound->type == sound_type_stream)
+		sound_stream_set_playing(voice.sound, false);
+	sound_release(voice.sound);
+	voice.sound = nullptr;
+	voice.state = au_voice_state_free;
+}
+
+///////////////////////////////////////////
+
+sound_inst_t audio_voice_play(sound_t sound, vec3 at, float volume) {
+	sound_inst_t result;
+	result._id   = 0;
+	result._slot = -1;
+
+	// Streams share a single read position, so they only ever get one voice,
+	// playing again just moves it.
+	if (sound->type == sound_type_stream) {
+		for (int32_t i = 0; i < au_voice_end; i++) {
+			au_voice_t &voice = au_voices[i];
+			if (voice.sound == sound && voice.state == au_voice_state_playing) {
+				voice.position = at;
+				voice.volume   = volume;
+				result._id   = voice.id;
+				result._slot = (int16_t)i;
+				return result;
+			}
+		}
+	}
+
+	// Find a free slot, and count up the voices that are still audible
+	vec3    head_pos   = input_head()->position;
+	int32_t free_slot  = -1;
+	int32_t playing    = 0;
+	int32_t victim     = -1;
+	float   victim_aud = 0;
+	for (int32_t i = 0; i < AU_VOICE_SLOTS; i++) {
+		au_voice_t &voice = au_voices[i];
+		if (voice.state == au_voice_state_free) {
+			if (free_slot == -1) free_slot = i;
+			if (i >= au_voice_end) break;
+			continue;
+		}
+		if (voice.state != au_voice_state_playing) continue;
+		playing += 1;
+
+		// The steal candidate is the lowest priority voice, and the quietest
+		// one of those.
+		float aud = au_voice_audibility(head_pos, voice.position, voice.volume);
+		if (victim == -1
+			|| voice.priority <  au_voices[victim].priority
+			|| (voice.priority == au_voices[victim].priority && aud < victim_aud)) {
+			victim     = i;
+			victim_aud = aud;
 		}
 	}
+
+	// Every slot is waiting on the audio thread, stealing won't help here
+	if (free_slot == -1) return result;
+
+	if (playing >= AU_MAX_VOICES) {
+		// Out of voices, so only steal one if the new sound matters more
+		// than the least important voice we have.
+		if (victim == -1) return result;
+		const au_voice_t &v = au_voices[victim];
+		float aud = au_voice_audibility(head_pos, at, volume);
+		if (v.priority > sound->priority || (v.priority == sound->priority && victim_aud >= aud))
+			return result;
+		audio_voice_stop(&au_voices[victim]);
+	}
+
+	au_voice_t &voice = au_voices[free_slot];
+	voice.pcm    = nullptr;
+	voice.stream = nullptr;
+	if (sound->type == sound_type_decode) {
+		// Short clips play straight from the cache. Anything else, or clips
+		// that aren't resident yet, streams through the decode thread.
+		voice.pcm = audio_pcm_acquire(sound);
+		if (voice.pcm == nullptr) {
+			voice.stream = audio_stream_create(sound);
+			if (voice.stream == nullptr) return result;
+		}
+	}
+
+	if (sound->type == sound_type_stream)
+		sound_stream_set_playing(sound, true);
+
+	sound_addref(sound);
+	voice.sound    = sound;
+	voice.cursor   = 0;
+	voice.position = at;
+	voice.volume   = volume;
+	voice.priority = sound->priority;
+	voice.gain_set = false;
+	voice.id       = (uint16_t)(voice.id + 1);
+
+	// Everything has to be in place before the audio thread can see it
+	atomic_barrier();
+	voice.state = au_voice_state_playing;
+	if (free_slot >= au_voice_end) au_voice_end = free_slot + 1;
+
+	result._id   = voice.id;
+	result._slot = (int16_t)free_slot;
+	sound->last_inst     = result;
+	sound->buffer.cursor = 0;
+	return result;
+}
+
+///////////////////////////////////////////
+
+au_voice_t *audio_voice_get(sound_inst_t inst) {
+	if (inst._slot < 0 || inst._slot >= AU_VOICE_SLOTS) return nullptr;
+	au_voice_t *voice = &au_voices[inst._slot];
+	return voice->id == inst._id && voice->state == au_voice_state_playing
+		? voice
+		: nullptr;
+}
+
+///////////////////////////////////////////
+
+void audio_voice_stop(au_voice_t *voice) {
+	if (voice->state != au_voice_state_playing) return;
+
+	// Without a running audio thread, nothing will acknowledge the stop
+	if (au_paused && !au_isac) au_voice_reclaim(*voice);
+	else           voice->state = au_voice_state_stopping;
 }
 
 ///////////////////////////////////////////
@@ -251,7 +493,7 @@ const char *mic_device_name(int32_t index) {
 void mic_callback(ma_device*, void*, const void* input, ma_uint32 frame_count) {
 	if (input == nullptr || au_mic_sound == nullptr) return;
 
-	sound_write_samples(au_mic_sound, (float*)input, frame_count);
+	sound_stream_write(au_mic_sound, (float*)input, frame_count);
 }
 
 ///////////////////////////////////////////
@@ -348,7 +590,11 @@ bool32_t mic_is_recording() {
 ///////////////////////////////////////////
 
 bool audio_init() {
+	if (!audio_decode_init())
+		return false;
+
 	au_mix_temp = sk_malloc_t(float, au_mix_temp_size);
+	au_mix_bus  = sk_malloc_t(float, au_mix_temp_size * 2);
 	memset(au_mix_temp, 0, sizeof(float) * au_mix_temp_size);
 
 	if (ma_context_init(nullptr, 0, nullptr, &au_context) != MA_SUCCESS) {
@@ -357,9 +603,10 @@ bool audio_init() {
 
 #if defined(_MSC_VER)
 	if (au_default_device_out_id.wasapi[0] == '\0') {
-		HRESULT hr = isac_activate(_countof(au_active_sounds), isac_data_callback);
+		HRESULT hr = isac_activate(au_isac_sources, isac_data_callback);
 
 		if (SUCCEEDED(hr)) {
+			au_isac = true;
 			log_info("Using audio backend: ISAC");
 			return true;
 		} else if (hr == E_NOT_VALID_STATE) {
@@ -421,21 +668,18 @@ bool audio_init() {
 void audio_step() {
 	matrix head = pose_matrix(*input_head());
 	matrix_inverse(head, au_head_transform);
+
+	// Clean up voices the audio thread is done with. This can free memory
+	// and release assets, neither of which belongs on the audio thread.
+	for (int32_t i = 0; i < au_voice_end; i++) {
+		if (au_voices[i].state == au_voice_state_finished)
+			au_voice_reclaim(au_voices[i]);
+	}
 }
 
 ///////////////////////////////////////////
 
 void audio_shutdown() {
-	// Stop any sounds that are still playing
-	for (int32_t i = 0; i < _countof(au_active_sounds); i++) {
-		if (au_active_sounds[i].sound != nullptr) {
-			sound_inst_t inst;
-			inst._id   = au_active_sounds[i].id;
-			inst._slot = (int16_t)i;
-			sound_inst_stop(inst);
-		}
-	}
-
 	mic_stop();
 #if defined(_MSC_VER)
 	isac_destroy();
@@ -443,9 +687,18 @@ void audio_shutdown() {
 	ma_device_uninit (&au_device);
 	ma_context_uninit(&au_context);
 
+	// With the audio thread gone, any voices left can be cleaned up directly
+	for (int32_t i = 0; i < au_voice_end; i++) {
+		if (au_voices[i].state != au_voice_state_free)
+			au_voice_reclaim(au_voices[i]);
+	}
+	au_voice_end = 0;
+
 	sound_release(au_mic_sound);
 	au_mic_sound = nullptr;
+	audio_decode_shutdown();
 	sk_free(au_mix_temp);
+	sk_free(au_mix_bus);
 }
 
 ///////////////////////////////////////////
@@ -2,16 +2,42 @@
 
 #include "../stereokit.h"
 
+
 namespace sk {
 
+struct au_pcm_t;
+struct au_stream_t;
+
 #define AU_SAMPLE_RATE   48000
 #define AU_SAMPLE_FORMAT ma_format_f32
 
-struct _sound_inst_t {
-	sound_t  sound;
-	uint16_t id;
-	vec3     position;
-	float    volume;
+// How many voices can be audible at once. The pool has a few more slots than
+// this, since stolen and stopped voices hang around until audio_step can
+// clean them up off the audio thread.
+#define AU_MAX_VOICES    256
+#define AU_VOICE_SLOTS   (AU_MAX_VOICES + 64)
+
+typedef enum au_voice_state_ {
+	au_voice_state_free,
+	au_voice_state_playing,
+	au_voice_state_stopping, // Main thread wants it gone, audio thread hasn't seen it yet
+	au_voice_state_finished, // Audio thread is done with it, main thread can reclaim it
+} au_voice_state_;
+
+// One playing instance of a sound. Each voice keeps its own read position,
+// so a single sound_t can play many times over itself.
+struct au_voice_t {
+	sound_t          sound;
+	au_pcm_t        *pcm;     // Cached samples for sound_type_decode, if resident
+	au_stream_t     *stream;  // Otherwise, sound_type_decode streams from the decode thread
+	uint64_t         cursor;  // In samples, from the start of the sound
+	vec3             position;
+	float            volume;
+	int32_t          priority;
+	uint16_t         id;
+	volatile int32_t state;
+	float            gain[2];  // Per-ear gain at the end of the last block, audio thread only
+	bool32_t         gain_set;
 };
 
 bool audio_init    ();
@@ -26,6 +52,8 @@ void audio_set_default_device_in (const wchar_t *id);
 void audio_set_default_device_out(const wchar_t *id);
 #endif
 
-extern _sound_inst_t au_active_sounds[8];
+sound_inst_t audio_voice_play(sound_t sound, vec3 at, float volume);
+au_voice_t  *audio_voice_get (sound_inst_t inst);
+void         audio_voice_stop(au_voice_t *voice);
 
-} // namespace sk
\ No newline at end of file
+} // namespace sk
@@ -0,0 +1,416 @@
+#include "audio_decode.h"
+#include "audio.h"
+#include "jobs.h"
+#include "profiler.h"
+#include "../asset_types/sound.h"
+#include "../asset_types/assets.h"
+
+#include "../sk_memory.h"
+#include "../platforms/platform.h"
+#include "../libraries/array.h"
+#include "../libraries/atomic_util.h"
+#include "../libraries/ferr_thread.h"
+#include "../libraries/miniaudio.h"
+
+#include <string.h>
+
+namespace sk {
+
+///////////////////////////////////////////
+
+struct au_stream_t {
+	sound_t          sound;
+	ma_decoder       decoder;
+	ma_pcm_rb        ring;
+	float           *ring_data;
+	bool32_t         started;  // Decode thread only
+	bool32_t         has_decoder;
+	volatile int32_t ended;    // The decoder has nothing left to give
+};
+
+struct audio_decode_state_t {
+	ft_mutex_t             pcm_mtx;
+	array_t<au_pcm_t*>     pcm_entries;
+	uint64_t               pcm_bytes;
+	uint64_t               pcm_budget;
+	uint64_t               pcm_clock;
+	volatile int32_t       pcm_decoding;
+
+	ft_mutex_t             stream_mtx;
+	ft_condition_t         stream_cond;
+	ft_condition_t         fill_cond;
+	array_t<au_stream_t*>  streams;
+	au_stream_t           *filling;  // Stream the decode thread is working on outside the lock
+	bool32_t               run;
+	volatile int32_t       thread_running;
+};
+static audio_decode_state_t local = {};
+
+// Clips longer than this always stream, decoding them fully would take more
+// memory than it saves.
+const uint64_t au_pcm_max_samples    = AU_SAMPLE_RATE * 10;
+const uint64_t au_pcm_default_budget = 32 * 1024 * 1024;
+
+// Streams hold two blocks, the decode thread refills whichever one the
+// audio thread has finished with.
+const ma_uint32 au_stream_block      = AU_SAMPLE_RATE / 10;
+const int       au_stream_poll_ms    = 5;
+
+int32_t audio_decode_thread(void *);
+
+///////////////////////////////////////////
+
+bool audio_decode_init() {
+	local = {};
+	local.pcm_mtx     = ft_mutex_create();
+	local.pcm_budget  = au_pcm_default_budget;
+	local.stream_mtx  = ft_mutex_create();
+	local.stream_cond = ft_condition_create();
+	local.fill_cond   = ft_condition_create();
+	local.run         = true;
+
+	local.thread_running = true;
+	ft_thread_t thread = ft_thread_create(audio_decode_thread, nullptr);
+	ft_thread_name(thread, "StereoKit Audio Decode");
+	return true;
+}
+
+///////////////////////////////////////////
+
+void audio_decode_shutdown() {
+	ft_mutex_lock(local.stream_mtx);
+	local.run = false;
+	ft_condition_broadcast(local.stream_cond);
+	ft_mutex_unlock(local.stream_mtx);
+	while (local.thread_running)
+		ft_yield();
+
+	// Decodes still in flight would land in the cache after we've torn it
+	// down, so help them finish first.
+	while (local.pcm_decoding > 0) {
+		if (!jobs_execute_one(job_priority_low))
+			ft_yield();
+	}
+
+	for (int32_t i = 0; i < local.pcm_entries.count; i++) {
+		au_pcm_t *pcm = local.pcm_entries[i];
+		pcm->sound->pcm = nullptr;
+		sk_free(pcm->samples);
+		sk_free(pcm);
+	}
+	local.pcm_entries.free();
+	local.streams    .free();
+	ft_mutex_destroy    (&local.pcm_mtx);
+	ft_mutex_destroy    (&local.stream_mtx);
+	ft_condition_destroy(&local.stream_cond);
+	ft_condition_destroy(&local.fill_cond);
+	local = {};
+}
+
+///////////////////////////////////////////
+// PCM cache                             //
+///////////////////////////////////////////
+
+// Must be called with pcm_mtx held. Drops idle entries, oldest first, until
+// there's room for the requested size. Returns false if it can't fit.
+bool au_pcm_make_room(uint64_t bytes) {
+	if (bytes > local.pcm_budget) return false;
+
+	while (local.pcm_bytes + bytes > local.pcm_budget) {
+		int32_t oldest = -1;
+		for (int32_t i = 0; i < local.pcm_entries.count; i++) {
+			au_pcm_t *pcm = local.pcm_entries[i];
+			if (pcm->voices > 0) continue;
+			if (oldest == -1 || pcm->last_used < local.pcm_entries[oldest]->last_used)
+				oldest = i;
+		}
+		if (oldest == -1) return false;
+
+		au_pcm_t *pcm = local.pcm_entries[oldest];
+		pcm->sound->pcm = nullptr;
+		local.pcm_bytes -= pcm->count * sizeof(float);
+		local.pcm_entries.remove(oldest);
+		sk_free(pcm->samples);
+		sk_free(pcm);
+	}
+	return true;
+}
+
+///////////////////////////////////////////
+
+bool32_t au_pcm_decode_action(asset_task_t *, asset_header_t *asset, void *) {
+	sound_t  sound  = (sound_t)asset;
+	au_pcm_t *entry = nullptr;
+
+	ma_decoder        decoder;
+	ma_decoder_config config = ma_decoder_config_init(AU_SAMPLE_FORMAT, 1, AU_SAMPLE_RATE);
+	if (ma_decoder_init_memory(sound->file_data, sound->file_size, &config, &decoder) == MA_SUCCESS) {
+		ma_uint64 length = 0;
+		ma_decoder_get_length_in_pcm_frames(&decoder, &length);
+
+		if (length > 0 && length <= au_pcm_max_samples) {
+			entry  = sk_malloc_t(au_pcm_t, 1);
+			*entry = {};
+			entry->sound   = sound;
+			entry->samples = sk_malloc_t(float, (size_t)length);
+			ma_uint64 read = 0;
+			ma_decoder_read_pcm_frames(&decoder, entry->samples, length, &read);
+			entry->count = read;
+		}
+		ma_decoder_uninit(&decoder);
+	}
+
+	ft_mutex_lock(local.pcm_mtx);
+	if (entry == nullptr) {
+		// Too long, or not something we can decode, so don't try again.
+		sound->pcm_uncacheable = true;
+	} else if (entry->count == 0 || !au_pcm_make_room(entry->count * sizeof(float))) {
+		sk_free(entry->samples);
+		sk_free(entry);
+	} else {
+		entry->last_used = local.pcm_clock;
+		local.pcm_bytes += entry->count * sizeof(float);
+		local.pcm_entries.add(entry);
+		sound->pcm = entry;
+	}
+	sound->pcm_pending = false;
+	ft_mutex_unlock(local.pcm_mtx);
+
+	atomic_decrement(&local.pcm_decoding);
+	return true;
+}
+
+///////////////////////////////////////////
+
+void audio_pcm_request(sound_t sound) {
+	// Sounds made before the audio system is up, like the default ones, get
+	// requested again on their first play.
+	if (local.pcm_budget == 0 || sound->type != sound_type_decode) return;
+
+	ft_mutex_lock(local.pcm_mtx);
+	bool queue = sound->pcm == nullptr && !sound->pcm_pending && !sound->pcm_uncacheable;
+	if (queue) sound->pcm_pending = true;
+	ft_mutex_unlock(local.pcm_mtx);
+	if (!queue) return;
+
+	static const asset_load_action_t actions[] = {
+		asset_load_action_t {au_pcm_decode_action, asset_thread_asset},
+	};
+	asset_task_t task = {};
+	task.asset        = &sound->header;
+	task.actions      = (asset_load_action_t *)actions;
+	task.action_count = _countof(actions);
+	task.priority     = 10;
+	task.sort         = asset_sort(task.priority, (int32_t)(sound->file_size / 1024));
+
+	atomic_increment(&local.pcm_decoding);
+	assets_add_task(task);
+}
+
+///////////////////////////////////////////
+
+au_pcm_t *audio_pcm_acquire(sound_t sound) {
+	if (local.pcm_mtx == nullptr) return nullptr;
+
+	ft_mutex_lock(local.pcm_mtx);
+	au_pcm_t *result = sound->pcm;
+	if (result != nullptr) {
+		local.pcm_clock  += 1;
+		result->last_used = local.pcm_clock;
+		result->voices   += 1;
+	}
+	ft_mutex_unlock(local.pcm_mtx);
+
+	// It may have been evicted, so bring it back for next time.
+	if (result == nullptr)
+		audio_pcm_request(sound);
+	return result;
+}
+
+///////////////////////////////////////////
+
+void audio_pcm_release(au_pcm_t *pcm) {
+	ft_mutex_lock(local.pcm_mtx);
+	pcm->voices -= 1;
+	ft_mutex_unlock(local.pcm_mtx);
+}
+
+///////////////////////////////////////////
+
+void audio_pcm_remove(sound_t sound) {
+	// Sounds can outlive the audio system, in which case the cache has
+	// already been cleared.
+	if (local.pcm_mtx == nullptr) return;
+
+	ft_mutex_lock(local.pcm_mtx);
+	au_pcm_t *pcm = sound->pcm;
+	if (pcm != nullptr) {
+		local.pcm_bytes -= pcm->count * sizeof(float);
+		local.pcm_entries.remove(local.pcm_entries.index_of(pcm));
+		sk_free(pcm->samples);
+		sk_free(pcm);
+		sound->pcm = nullptr;
+	}
+	ft_mutex_unlock(local.pcm_mtx);
+}
+
+///////////////////////////////////////////
+
+void audio_pcm_set_budget(uint64_t bytes) {
+	if (local.pcm_mtx == nullptr) return;
+
+	ft_mutex_lock(local.pcm_mtx);
+	local.pcm_budget = bytes;
+	au_pcm_make_room(0);
+	ft_mutex_unlock(local.pcm_mtx);
+}
+
+///////////////////////////////////////////
+
+uint64_t audio_pcm_get_budget() {
+	return local.pcm_budget;
+}
+
+///////////////////////////////////////////
+// Streaming decode                      //
+///////////////////////////////////////////
+
+au_stream_t *audio_stream_create(sound_t sound) {
+	au_stream_t *result = sk_malloc_t(au_stream_t, 1);
+	*result = {};
+	result->sound     = sound;
+	result->ring_data = sk_malloc_t(float, au_stream_block * 2);
+	if (ma_pcm_rb_init(AU_SAMPLE_FORMAT, 1, au_stream_block * 2, result->ring_data, nullptr, &result->ring) != MA_SUCCESS) {
+		log_err("Failed to create a decode stream ring buffer!");
+		sk_free(result->ring_data);
+		sk_free(result);
+		return nullptr;
+	}
+
+	ft_mutex_lock(local.stream_mtx);
+	local.streams.add(result);
+	ft_condition_signal(local.stream_cond);
+	ft_mutex_unlock(local.stream_mtx);
+	return result;
+}
+
+///////////////////////////////////////////
+
+void audio_stream_destroy(au_stream_t *stream) {
+	// Once it's out of the list, the decode thread won't pick it up again,
+	// but it may be partway through filling it right now.
+	ft_mutex_lock(local.stream_mtx);
+	int32_t at = local.streams.index_of(stream);
+	if (at != -1) local.streams.remove(at);
+	while (local.filling == stream)
+		ft_condition_wait(local.fill_cond, local.stream_mtx);
+	ft_mutex_unlock(local.stream_mtx);
+
+	if (stream->has_decoder) ma_decoder_uninit(&stream->decoder);
+	ma_pcm_rb_uninit(&stream->ring);
+	sk_free(stream->ring_data);
+	sk_free(stream);
+}
+
+///////////////////////////////////////////
+
+uint64_t audio_stream_read(au_stream_t *stream, float *out_samples, uint64_t sample_count) {
+	ma_uint32 available = ma_pcm_rb_available_read(&stream->ring);
+	ma_uint32 count     = sample_count < available ? (ma_uint32)sample_count : available;
+
+	ma_uint32 read = 0;
+	while (read < count) {
+		ma_uint32 readable  = count - read;
+		void     *read_from = nullptr;
+		if (ma_pcm_rb_acquire_read(&stream->ring, &readable, &read_from) != MA_SUCCESS) break;
+		memcpy(out_samples + read, read_from, readable * sizeof(float));
+		ma_result res = ma_pcm_rb_commit_read(&stream->ring, readable);
+		if (res != MA_SUCCESS && res != MA_AT_END) break;
+		read += readable;
+	}
+	return read;
+}
+
+///////////////////////////////////////////
+
+bool audio_stream_finished(au_stream_t *stream) {
+	return stream->ended && ma_pcm_rb_available_read(&stream->ring) == 0;
+}
+
+///////////////////////////////////////////
+
+// Decode thread, tops the stream's ring back up one whole block at a time.
+void au_stream_fill(au_stream_t *stream) {
+	if (!stream->started) {
+		stream->started = true;
+		ma_decoder_config config = ma_decoder_config_init(AU_SAMPLE_FORMAT, 1, AU_SAMPLE_RATE);
+		if (ma_decoder_init_memory(stream->sound->file_data, stream->sound->file_size, &config, &stream->decoder) != MA_SUCCESS) {
+			log_err("Failed to create a decoder for a streaming sound!");
+			stream->ended = true;
+			return;
+		}
+		stream->has_decoder = true;
+	}
+
+	while (!stream->ended && ma_pcm_rb_available_write(&stream->ring) >= au_stream_block) {
+		ma_uint32 frames   = au_stream_block;
+		void     *write_to = nullptr;
+		if (ma_pcm_rb_acquire_write(&stream->ring, &frames, &write_to) != MA_SUCCESS) break;
+
+		ma_uint64 decoded = 0;
+		ma_decoder_read_pcm_frames(&stream->decoder, write_to, frames, &decoded);
+		ma_pcm_rb_commit_write(&stream->ring, (ma_uint32)decoded);
+		if (decoded < frames) {
+			atomic_barrier();
+			stream->ended = true;
+		}
+	}
+}
+
+///////////////////////////////////////////
+
+int32_t audio_decode_thread(void *) {
+	profiler_thread_name("Audio Decode");
+	array_t<au_stream_t*> snapshot = {};
+	while (true) {
+		ft_mutex_lock(local.stream_mtx);
+		while (local.run && local.streams.count == 0)
+			ft_condition_wait(local.stream_cond, local.stream_mtx);
+		if (!local.run) {
+			ft_mutex_unlock(local.stream_mtx);
+			break;
+		}
+		snapshot.clear();
+		for (int32_t i = 0; i < local.streams.count; i++)
+			snapshot.add(local.streams[i]);
+		ft_mutex_unlock(local.stream_mtx);
+
+		// Decoding happens outside the lock, so creating and destroying
+		// streams never waits on it. Streams are claimed one at a time, and
+		// destroy waits only if it's the one being filled.
+		{
+			profiler_zone("Audio Decode Streams");
+			for (int32_t i = 0; i < snapshot.count; i++) {
+				ft_mutex_lock(local.stream_mtx);
+				bool alive = local.streams.index_of(snapshot[i]) != -1;
+				if (alive) local.filling = snapshot[i];
+				ft_mutex_unlock(local.stream_mtx);
+				if (!alive) continue;
+
+				au_stream_fill(snapshot[i]);
+
+				ft_mutex_lock(local.stream_mtx);
+				local.filling = nullptr;
+				ft_condition_broadcast(local.fill_cond);
+				ft_mutex_unlock(local.stream_mtx);
+			}
+		}
+
+		platform_sleep(au_stream_poll_ms);
+	}
+	snapshot.free();
+	local.thread_running = false;
+	return 0;
+}
+
+} // namespace sk
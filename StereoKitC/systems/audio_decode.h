@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../stereokit.h"
+
+namespace sk {
+
+// A fully decoded copy of a short sound_type_decode clip. Entries live in a
+// size limited cache, and the least recently played ones get evicted once
+// no voice is using them.
+struct au_pcm_t {
+	sound_t  sound;
+	float   *samples;
+	uint64_t count;
+	uint64_t last_used;
+	int32_t  voices;
+};
+
+struct au_stream_t;
+
+bool        audio_decode_init        ();
+void        audio_decode_shutdown    ();
+
+// Main thread. Queues up a background decode of the sound into the cache if
+// it's short enough to be worth it.
+void        audio_pcm_request        (sound_t sound);
+// Main thread. Returns the cached PCM for a sound with a voice reference
+// added, or nullptr if it isn't resident.
+au_pcm_t   *audio_pcm_acquire        (sound_t sound);
+void        audio_pcm_release        (au_pcm_t *pcm);
+void        audio_pcm_remove         (sound_t sound);
+void        audio_pcm_set_budget     (uint64_t bytes);
+uint64_t    audio_pcm_get_budget     ();
+
+// Streams decode on the decode thread into a small ring, and the audio
+// thread only ever copies out of it. Create and destroy on the main thread.
+au_stream_t*audio_stream_create      (sound_t sound);
+void        audio_stream_destroy     (au_stream_t *stream);
+uint64_t    audio_stream_read        (au_stream_t *stream, float *out_samples, uint64_t sample_count);
+bool        audio_stream_finished    (au_stream_t *stream);
+
+} // namespace sk
@@ -5,23 +5,13 @@ Based on my existing ray tracing code, but also heavily inspired by
 Jacco Bikker's excellent BVH series starting with
 https://jacco.ompf2.com/2022/04/13/how-to-build-a-bvh-part-1-basics/
 
+Construction uses binned SAH split selection, and builds large subtrees
+in parallel on the job system.
+
 Possible optimizations:
-- Use surface area heuristic for determining when to stop
-  partitioning, instead of the fixed max leaf size currently used
-- Add multiple split plane candidates, particularly binned SAH
 - Use a custom float3 value to get rid of vec3 usage in boundingbox, 
   so vec3_field() isn't needed anymore
 - SIMD operations for certain computations
-- Multi-threaded construction
-- Currently, the split step during recursive construction simply gives up 
-  when it encounters a bunch of triangles for which none of the 3 split
-  axes provide any way to split the triangles into two groups (i.e. all 
-  triangles found to be on the left and/or all on the right). In those cases
-  currently a leaf node holding all those triangles is created. But an 
-  option could be to simply divide the triangles into two groups randomly
-  and recurse into the two groups. This will still provide a speedup, as
-  bboxes can be tested for each group and discarded early, instead of always
-  having to test each triangle separately.
 
 June, 2022
 Paul Melis, SURF (paul.melis@surf.nl)
@@ -40,10 +30,9 @@ Paul Melis, SURF (paul.melis@surf.nl)
 #include "../sk_math.h"
 #include "../asset_types/mesh.h"
 #include "../libraries/sokol_time.h"
+#include "../libraries/atomic_util.h"
 
-//#define VERBOSE_BUILD
 //#define VERBOSE_INTERSECTION
-//#define VERBOSE_STATS
 
 namespace sk {
 
@@ -112,22 +101,32 @@ mesh_bvh_statistics(const mesh_bvh_t *bvh, bvh_stats_t *stats, int acc_leaf_size
 // which are specified as a sub-sequence of sorted_triangles, 
 // i.e. sorted_triangles[first..first+count-1]
 static void
-bound_triangles(boundingbox& bbox, const uint32_t *sorted_triangles, const vec3 *triangle_vertices, int first, int count)
+bound_triangles(boundingbox& bbox, const uint32_t *sorted_triangles, const mesh_collision_t *collision_data, int first, int count)
 {
     bbox_clear(bbox);
 
     for (int t = first; t < first+count; t++)
     {
-        const vec3 *p = &triangle_vertices[3*sorted_triangles[t]];
-        bbox_update(bbox, p[0]);
-        bbox_update(bbox, p[1]);
-        bbox_update(bbox, p[2]);
+        const uint32_t i = 3*sorted_triangles[t];
+        bbox_update(bbox, mesh_collision_pt(collision_data, i+0));
+        bbox_update(bbox, mesh_collision_pt(collision_data, i+1));
+        bbox_update(bbox, mesh_collision_pt(collision_data, i+2));
     }
 
     // Safety margin
     bbox_grow(bbox, C_EPSILON);
 }
 
+// Same as above, but for the triangle centroids
+static void
+bound_centroids(boundingbox& bbox, const uint32_t *sorted_triangles, const vec3 *triangle_centroids, int first, int count)
+{
+    bbox_clear(bbox);
+
+    for (int t = first; t < first+count; t++)
+        bbox_update(bbox, triangle_centroids[sorted_triangles[t]]);
+}
+
 // Convenience method for indexing a vec3 by coordinate index
 inline float
 vec3_field(vec3 v, int index)
@@ -145,218 +144,344 @@ vec3_field(vec3 v, int index)
     }
 }
 
-// Recursively subdivide the triangles in the current leaf node into two groups, 
-// by determining a split plane based on the current bound, 
-// and sorting the triangles into "left-of" and "right-of".
-static void
-mesh_bvh_build_recursive(int current_node_index, 
-    bvh_node_t *nodes, uint32_t *next_node_index,
-    uint32_t *sorted_triangles,
-    int acceptable_leaf_size, 
-    const vec3* triangle_vertices, const vec3* triangle_centroids, 
-    const mesh_collision_t *collision_data)
+// Grow bbox to include the box spanned by min and max. Unlike bbox_update,
+// this one is inlined, as it sits in the innermost binning loop.
+inline void
+bbox_merge(boundingbox& bbox, vec3 min, vec3 max)
 {
-    vec3        bbox_size, bbox_center;
-    int         i, j, t;
-    short       sorted_dimensions[3];
-    short       split_axis;
-    float       split_value;
-
-    bvh_node_t& node = nodes[current_node_index];
-
-#ifdef VERBOSE_BUILD
-    printf("build_recursive(): current_node_index = %d\n", current_node_index);
-    printf("... leaf_first = %d, num_triangles = %d\n", node.leaf_first, node.num_triangles);
-    for (i = node.leaf_first; i < node.leaf_first+node.num_triangles; i++)
-        printf("[%d] %d  ", i, sorted_triangles[i]);
-    printf("\n");
-#endif
+    bbox.bounds[0] = vec3{ fminf(bbox.bounds[0].x, min.x), fminf(bbox.bounds[0].y, min.y), fminf(bbox.bounds[0].z, min.z) };
+    bbox.bounds[1] = vec3{ fmaxf(bbox.bounds[1].x, max.x), fmaxf(bbox.bounds[1].y, max.y), fmaxf(bbox.bounds[1].z, max.z) };
+}
 
-    if (node.num_triangles <= (uint32_t)acceptable_leaf_size)
-    {
-#ifdef VERBOSE_BUILD
-        printf("Creating a leaf node of %d triangles\n", node.num_triangles);
-#endif
+// Construction uses a binned surface area heuristic: triangles are sorted
+// into BVH_BIN_COUNT bins along each axis by centroid, and the split plane
+// with the lowest estimated traversal cost between two bins wins.
 
-        return;
-    }
+const int      BVH_BIN_COUNT = 16;
 
-    //
-    // Split the triangles into two groups, using a split plane based
-    // on largest bbox side
-    //
-    
-    boundingbox& bbox = node.bbox;
+// Subtrees at least this large are handed to the job system, smaller ones
+// aren't worth the scheduling overhead.
+const uint32_t BVH_PARALLEL_SUBTREE = 4096;
 
-#ifdef VERBOSE_BUILD
-    printf("... bounding box:\n");
-    printf("... (min) %.6f, %.6f, %.6f\n", bbox_min(bbox).x, bbox_min(bbox).y, bbox_min(bbox).z);
-    printf("... (max) %.6f, %.6f, %.6f\n", bbox_max(bbox).x, bbox_max(bbox).y, bbox_max(bbox).z);
-#endif
+// Nodes at least this large bin their triangles in parallel chunks of
+// BVH_BIN_CHUNK, which mostly helps the first few levels of big meshes.
+const uint32_t BVH_PARALLEL_BIN = 65536;
+const int32_t  BVH_BIN_CHUNK    = 16384;
+
+struct bvh_bin_t
+{
+    boundingbox bbox;      // Bounds of the triangles in this bin
+    boundingbox centroids; // Bounds of their centroids
+    uint32_t    count;
+};
+
+typedef bvh_bin_t bvh_bins_t[3][BVH_BIN_COUNT];
+
+// Shared by every job working on one BVH
+struct bvh_build_t
+{
+    bvh_node_t             *nodes;
+    uint32_t               *sorted_triangles;
+    const mesh_collision_t *collision_data;
+    const vec3             *triangle_centroids;
+    int                     acc_leaf_size;
+    job_priority_           priority;
+    job_counter_t           counter;
+    volatile int32_t        next_pair; // Children are always allocated in pairs
+};
+
+struct bvh_subtree_job_t
+{
+    bvh_build_t *build;
+    uint32_t     node_index;
+    boundingbox  centroids;
+};
+
+struct bvh_bin_job_t
+{
+    const bvh_build_t *build;
+    boundingbox        centroids;
+    uint32_t           first;
+    bvh_bins_t        *chunk_bins;
+};
 
-    bbox_size = bbox.bounds[1] - bbox.bounds[0];
-    bbox_center = 0.5f * (bbox.bounds[0] + bbox.bounds[1]);
+static void bvh_build_node(bvh_build_t *build, uint32_t node_index, boundingbox centroids);
 
-    // Sort bbox sides by size in descending order
+inline int
+bvh_bin_index(float centroid, float min, float scale)
+{
+    int bin = (int)((centroid - min) * scale);
+    return bin < 0 ? 0 : (bin >= BVH_BIN_COUNT ? BVH_BIN_COUNT-1 : bin);
+}
 
-    sorted_dimensions[0] = 0;
-    sorted_dimensions[1] = 1;
-    sorted_dimensions[2] = 2;
+inline void
+bvh_bin_scale(const boundingbox& centroids, float *out_scale)
+{
+    const vec3 extent = bbox_size(centroids);
+    for (int a = 0; a < 3; a++)
+    {
+        float e = vec3_field(extent, a);
+        out_scale[a] = e > C_EPSILON ? BVH_BIN_COUNT / e : 0.0f;
+    }
+}
 
-    // Good old bubble sort :)
-    for (i = 0; i < 2; i++)
+static void
+bvh_bins_clear(bvh_bins_t bins)
+{
+    for (int a = 0; a < 3; a++)
     {
-        for (j = i+1; j < 3; j++)
+        for (int b = 0; b < BVH_BIN_COUNT; b++)
         {
-            if (vec3_field(bbox_size, sorted_dimensions[i])
-                <
-                vec3_field(bbox_size, sorted_dimensions[j]))
-            {
-                t = sorted_dimensions[i];
-                sorted_dimensions[i] = sorted_dimensions[j];
-                sorted_dimensions[j] = (short)t;
-            }
+            bbox_clear(bins[a][b].bbox);
+            bbox_clear(bins[a][b].centroids);
+            bins[a][b].count = 0;
         }
     }
+}
 
-    // Iterate over the three split dimensions in descending order of
-    // bbox size on that dimension. When the triangles are unsplitable
-    // (or we can't split in a favorable way) continue to the next dimension.
-    // Create a leaf with all triangles in case none of the dimensions is a 
-    // good split candidate.
+// Sort sorted_triangles[first..first+count-1] into bins on all three axes in
+// a single pass.
+static void
+bvh_bin_triangles(const bvh_build_t *build, const boundingbox& centroids, uint32_t first, uint32_t count, bvh_bins_t bins)
+{
+    float scale[3];
+    bvh_bin_scale(centroids, scale);
+    const vec3 cmin = bbox_min(centroids);
 
-    uint32_t l, r;
-    boundingbox left_bbox, right_bbox;
+    bvh_bins_clear(bins);
 
-    for (int d = 0; d < 3; d++)
+    for (uint32_t t = first; t < first+count; t++)
     {
-        // Partition the triangles on the chosen split axis, with the
-        // split plane at the center of the bbox
+        const uint32_t tri = build->sorted_triangles[t];
+        const vec3     c   = build->triangle_centroids[tri];
+        const vec3     p[3] = {
+            mesh_collision_pt(build->collision_data, 3*tri+0),
+            mesh_collision_pt(build->collision_data, 3*tri+1),
+            mesh_collision_pt(build->collision_data, 3*tri+2) };
+
+        const vec3 tri_min = { fminf(p[0].x, fminf(p[1].x, p[2].x)), fminf(p[0].y, fminf(p[1].y, p[2].y)), fminf(p[0].z, fminf(p[1].z, p[2].z)) };
+        const vec3 tri_max = { fmaxf(p[0].x, fmaxf(p[1].x, p[2].x)), fmaxf(p[0].y, fmaxf(p[1].y, p[2].y)), fmaxf(p[0].z, fmaxf(p[1].z, p[2].z)) };
+
+        bvh_bin_t *bin;
+        bin = &bins[0][bvh_bin_index(c.x, cmin.x, scale[0])];
+        bbox_merge(bin->bbox, tri_min, tri_max); bbox_merge(bin->centroids, c, c); bin->count++;
+        bin = &bins[1][bvh_bin_index(c.y, cmin.y, scale[1])];
+        bbox_merge(bin->bbox, tri_min, tri_max); bbox_merge(bin->centroids, c, c); bin->count++;
+        bin = &bins[2][bvh_bin_index(c.z, cmin.z, scale[2])];
+        bbox_merge(bin->bbox, tri_min, tri_max); bbox_merge(bin->centroids, c, c); bin->count++;
+    }
+}
+
+static void
+bvh_bin_chunk(int32_t start, int32_t end, void *data)
+{
+    bvh_bin_job_t *job = (bvh_bin_job_t *)data;
+    bvh_bin_triangles(job->build, job->centroids, job->first + start, end - start, job->chunk_bins[start / BVH_BIN_CHUNK]);
+}
+
+static void
+bvh_bin_add(bvh_bin_t& dest, const bvh_bin_t& src)
+{
+    if (src.count == 0)
+        return;
+    bbox_merge(dest.bbox,      bbox_min(src.bbox),      bbox_max(src.bbox));
+    bbox_merge(dest.centroids, bbox_min(src.centroids), bbox_max(src.centroids));
+    dest.count += src.count;
+}
 
-        split_axis = sorted_dimensions[d];
-        split_value = vec3_field(bbox_center, split_axis);
+static void
+bvh_subtree_job(void *data)
+{
+    bvh_subtree_job_t *job = (bvh_subtree_job_t *)data;
+    bvh_build_node(job->build, job->node_index, job->centroids);
+    sk_free(job);
+}
+
+// Subdivide the triangles in the given leaf node into two groups, and keep
+// going until the leaves are small enough, or splitting stops paying off.
+// Large child subtrees are built by other workers, the smaller side is
+// recursed into directly, and the larger side is handled by looping.
+static void
+bvh_build_node(bvh_build_t *build, uint32_t node_index, boundingbox centroids)
+{
+    bvh_bins_t bins;
 
-#ifdef VERBOSE_BUILD
-        printf("Splitting on axis %d, value %.6f\n", split_axis, split_value);
+    while (true)
+    {
+        bvh_node_t& node  = build->nodes[node_index];
+        const uint32_t first = node.leaf_first;
+        const uint32_t count = node.num_triangles;
 
-        for (l = node.leaf_first; l < node.leaf_first+node.num_triangles; l++)
+        if (count <= 2)
+            return;
+
+        // Bin the triangles, splitting the work up for large nodes
+        if (count >= BVH_PARALLEL_BIN && jobs_worker_count() > 0)
         {
-            const vec3&p = triangle_centroids[sorted_triangles[l]];
-            printf("[%d] tri %d, %6f, %6f, %6f\n", l, sorted_triangles[l], p.x, p.y, p.z);
+            const int32_t  chunk_count = (int32_t)((count + BVH_BIN_CHUNK - 1) / BVH_BIN_CHUNK);
+            bvh_bin_job_t  job         = { build, centroids, first, sk_malloc_t(bvh_bins_t, chunk_count) };
+            jobs_parallel_for((int32_t)count, BVH_BIN_CHUNK, bvh_bin_chunk, &job);
+
+            bvh_bins_clear(bins);
+            for (int32_t i = 0; i < chunk_count; i++)
+                for (int a = 0; a < 3; a++)
+                    for (int b = 0; b < BVH_BIN_COUNT; b++)
+                        bvh_bin_add(bins[a][b], job.chunk_bins[i][a][b]);
+            sk_free(job.chunk_bins);
         }
-#endif
+        else
+        {
+            bvh_bin_triangles(build, centroids, first, count, bins);
+        }
+
+        // Sweep the split planes between bins on each axis, and keep the one
+        // with the lowest SAH cost.
+        int   best_axis = -1;
+        int   best_bin  = 0;
+        float best_cost = FLT_MAX;
+        for (int a = 0; a < 3; a++)
+        {
+            float       right_cost[BVH_BIN_COUNT];
+            boundingbox acc;
+            uint32_t    acc_count = 0;
 
-        l = node.leaf_first;
-        r = l + node.num_triangles - 1;
-        while (l <= r)
-        {            
-            if (vec3_field(triangle_centroids[sorted_triangles[l]], split_axis) < split_value)
-                l++;
-            else
+            bbox_clear(acc);
+            for (int b = BVH_BIN_COUNT-1; b > 0; b--)
             {
-                uint32_t temp = sorted_triangles[l];
-                sorted_triangles[l] = sorted_triangles[r];
-                sorted_triangles[r--] = temp;
+                if (bins[a][b].count > 0)
+                    bbox_merge(acc, bbox_min(bins[a][b].bbox), bbox_max(bins[a][b].bbox));
+                acc_count    += bins[a][b].count;
+                right_cost[b] = acc_count > 0 ? acc_count * bbox_surface_area(acc) : 0.0f;
             }
-        }        
-
-        const int num_triangles_left = l - node.leaf_first;
-        const int num_triangles_right = node.num_triangles - num_triangles_left;
 
-#ifdef VERBOSE_BUILD
-        printf("%d left, %d right\n", num_triangles_left, num_triangles_right);
-#endif
+            bbox_clear(acc);
+            acc_count = 0;
+            for (int b = 1; b < BVH_BIN_COUNT; b++)
+            {
+                if (bins[a][b-1].count > 0)
+                    bbox_merge(acc, bbox_min(bins[a][b-1].bbox), bbox_max(bins[a][b-1].bbox));
+                acc_count += bins[a][b-1].count;
+                if (acc_count == 0 || acc_count == count)
+                    continue;
 
-        if (num_triangles_left == 0 || num_triangles_right == 0)
-        {
-            // All triangles in one of the half, discontinue this attempt
-#ifdef VERBOSE_BUILD
-            printf("Skipping dimension %d, all triangles on one side\n");
-#endif
-            continue;
+                float cost = acc_count * bbox_surface_area(acc) + right_cost[b];
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_axis = a;
+                    best_bin  = b;
+                }
+            }
         }
 
-        // Triangles are now split into two groups, determine bboxes for each.    
+        uint32_t    split;
+        boundingbox left_bbox,      right_bbox;
+        boundingbox left_centroids, right_centroids;
 
-        bound_triangles(left_bbox, sorted_triangles, triangle_vertices, node.leaf_first, num_triangles_left);
-        bound_triangles(right_bbox, sorted_triangles, triangle_vertices, l, num_triangles_right);
-
-#ifdef VERBOSE_BUILD
-        printf("left bbox:  %.6f, %.6f, %.6f .. %.6f, %.6f, %.6f\n",
-            left_bbox.bounds[0].x, left_bbox.bounds[0].y, left_bbox.bounds[0].z,
-            left_bbox.bounds[1].x, left_bbox.bounds[1].y, left_bbox.bounds[1].z);
-        printf("right bbox: %.6f, %.6f, %.6f .. %.6f, %.6f, %.6f\n",
-            right_bbox.bounds[0].x, right_bbox.bounds[0].y, right_bbox.bounds[0].z,
-            right_bbox.bounds[1].x, right_bbox.bounds[1].y, right_bbox.bounds[1].z);
-#endif
+        if (best_axis == -1)
+        {
+            // All centroids landed in one bin, so there's no plane to split
+            // on. Small groups become a leaf, but big ones are still divided
+            // down the middle, the child bboxes at least let rays skip half
+            // the triangles at a time.
+            if (count <= (uint32_t)build->acc_leaf_size)
+                return;
+
+            split = first + count/2;
+            bound_triangles(left_bbox,       build->sorted_triangles, build->collision_data,     first, split - first);
+            bound_triangles(right_bbox,      build->sorted_triangles, build->collision_data,     split, first + count - split);
+            bound_centroids(left_centroids,  build->sorted_triangles, build->triangle_centroids, first, split - first);
+            bound_centroids(right_centroids, build->sorted_triangles, build->triangle_centroids, split, first + count - split);
+        }
+        else
+        {
+            // Stop here if a leaf is cheaper to trace than the split, with a
+            // traversal step costing about as much as one triangle test.
+            const float leaf_cost  = count * bbox_surface_area(node.bbox);
+            const float split_cost = bbox_surface_area(node.bbox) + best_cost;
+            if (count <= (uint32_t)build->acc_leaf_size && split_cost >= leaf_cost)
+                return;
+
+            // Partition the triangles on the winning plane
+            float scale[3];
+            bvh_bin_scale(centroids, scale);
+            const float cmin  = vec3_field(bbox_min(centroids), best_axis);
+            uint32_t   *tris  = build->sorted_triangles;
+            uint32_t    l     = first;
+            uint32_t    r     = first + count;
+            while (l < r)
+            {
+                if (bvh_bin_index(vec3_field(build->triangle_centroids[tris[l]], best_axis), cmin, scale[best_axis]) < best_bin)
+                    l++;
+                else
+                {
+                    r--;
+                    uint32_t temp = tris[l];
+                    tris[l] = tris[r];
+                    tris[r] = temp;
+                }
+            }
+            split = l;
+
+            // Child bounds come straight out of the bins
+            bvh_bin_t left = {}, right = {};
+            bbox_clear(left .bbox); bbox_clear(left .centroids);
+            bbox_clear(right.bbox); bbox_clear(right.centroids);
+            for (int b = 0; b < BVH_BIN_COUNT; b++)
+                bvh_bin_add(b < best_bin ? left : right, bins[best_axis][b]);
+            left_bbox       = left .bbox; bbox_grow(left_bbox,  C_EPSILON);
+            right_bbox      = right.bbox; bbox_grow(right_bbox, C_EPSILON);
+            left_centroids  = left .centroids;
+            right_centroids = right.centroids;
+        }
 
-        // Create two child nodes and recurse
-        
-        const uint32_t left_child_index = *next_node_index;
+        // Create two child nodes
+        const uint32_t left_child_index  = 2 * (uint32_t)atomic_increment(&build->next_pair) - 1;
         const uint32_t right_child_index = left_child_index + 1;
-        *next_node_index += 2;
 
-        bvh_node_t& left_node = nodes[left_child_index];
-        left_node.bbox = left_bbox;
-        left_node.leaf_first = node.leaf_first;
-        left_node.num_triangles = num_triangles_left;
+        bvh_node_t& left_node = build->nodes[left_child_index];
+        left_node.bbox          = left_bbox;
+        left_node.leaf_first    = first;
+        left_node.num_triangles = split - first;
 
-        bvh_node_t& right_node = nodes[right_child_index];
-        right_node.bbox = right_bbox;
-        right_node.leaf_first = l;
-        right_node.num_triangles = num_triangles_right;
+        bvh_node_t& right_node = build->nodes[right_child_index];
+        right_node.bbox          = right_bbox;
+        right_node.leaf_first    = split;
+        right_node.num_triangles = first + count - split;
 
         // Turn original leaf node into an inner node
-        node.leaf_first = left_child_index;
+        node.leaf_first    = left_child_index;
         node.num_triangles = 0;
-        
-        // XXX Could check for leaf size here and only recurse when needed, instead of
-        // doing the check in build_recursive()
-        mesh_bvh_build_recursive(left_child_index, nodes, next_node_index, sorted_triangles, acceptable_leaf_size, 
-            triangle_vertices, triangle_centroids, collision_data);
-        mesh_bvh_build_recursive(right_child_index, nodes, next_node_index, sorted_triangles, acceptable_leaf_size, 
-            triangle_vertices, triangle_centroids, collision_data);
 
-        return;
-    }
+        const bool     left_larger = left_node.num_triangles >= right_node.num_triangles;
+        const uint32_t small_index = left_larger ? right_child_index : left_child_index;
+        const uint32_t large_index = left_larger ? left_child_index  : right_child_index;
+        boundingbox    small_cents = left_larger ? right_centroids   : left_centroids;
+        boundingbox    large_cents = left_larger ? left_centroids    : right_centroids;
 
-    // Split dimensions exhausted, forced to create a leaf
-
-#ifdef VERBOSE_BUILD
-    // XXX warn
-    printf("Split options exhausted, creating a leaf of %d triangles\n", node.num_triangles);
-#endif
+        if (build->nodes[small_index].num_triangles >= BVH_PARALLEL_SUBTREE && jobs_worker_count() > 0)
+        {
+            bvh_subtree_job_t *job = sk_malloc_t(bvh_subtree_job_t, 1);
+            job->build      = build;
+            job->node_index = small_index;
+            job->centroids  = small_cents;
+            jobs_add(bvh_subtree_job, job, build->priority, &build->counter);
+        }
+        else
+        {
+            bvh_build_node(build, small_index, small_cents);
+        }
 
-#if 0
-    // Save forced leafs to .obj files, for debugging
-    char s[256];
-    static int next_forced_leaf = 0;
-    sprintf(s, "forced_leaf%04d.obj", next_forced_leaf++);
-    printf("-> Writing %s\n", s);
-    FILE *f = fopen(s, "wt");
-    // XXX yuck, saves ALL scene vertices, not just the ones used by the triangles
-    for (i = 0; i < the_mesh->vert_count; i++)
-        fprintf(f, "v %g %g %g\n", the_mesh->verts[i].pos.x, the_mesh->verts[i].pos.y, the_mesh->verts[i].pos.z);
-    // Note: 0-based indices converted to 1-based
-    for (t = node.leaf_first; t < node.leaf_first+node.num_triangles; t++)
-    {
-        const uint32_t &tri = sorted_triangles[t];
-        fprintf(f, "f %d %d %d\n", 1+the_mesh->inds[3*tri+0], 1+the_mesh->inds[3*tri+1], 1+the_mesh->inds[3*tri+2]);
+        node_index = large_index;
+        centroids  = large_cents;
     }
-    fclose(f);
-#endif
 }
 
 // Build a BVH over the triangles in the given mesh.
 mesh_bvh_t*
-mesh_bvh_create(const mesh_t mesh, int acc_leaf_size, bool show_stats)
+mesh_bvh_create(const mesh_t mesh, int acc_leaf_size, bool show_stats, job_priority_ priority)
 {
-    // XXX refuse if num triangles is zero?
-#if defined(VERBOSE_STATS)
-    const double t0 = time_get_raw();
-#endif
-
-    mesh_bvh_t *bvh = sk_malloc_zero_t(mesh_bvh_t, 1);
+    const uint64_t t0 = stm_now();
 
     // A restriction during BVH construction is that we don't want to touch the
     // underlying vertex and index arrays in the passed mesh. So we need to keep some local
@@ -372,115 +497,80 @@ mesh_bvh_create(const mesh_t mesh, int acc_leaf_size, bool show_stats)
     // large meshes on memory-constrained devices it could be. Plus it would come
     // on top of the array mentioned above.
     //
-    // Instead, we leverage the existing mesh collision data, which provides
-    // an array of triangle vertices, to precompute triangle centroids, which
+    // Instead, we leverage the existing mesh collision data, which indexes
+    // the mesh's triangle vertices, to precompute triangle centroids, which
     // are then used during BVH construction. Whenever a bounding box of a 
     // group of triangles is needed this is computed on-the-fly.
 
-    bvh->collision_data = mesh_get_collision_data(mesh);
-    if (bvh->collision_data == nullptr)
+    const mesh_collision_t *collision_data = mesh_get_collision_data(mesh);
+    if (collision_data == nullptr)
     {
-        log_err("mesh_bvh_t::build(): no mesh collision data available");
+        log_err("mesh_bvh_create: no mesh collision data available");
         return nullptr;
     }
 
+    const uint32_t num_triangles = collision_data->ind_count / 3;
+    if (num_triangles == 0)
+        return nullptr;
+
+    mesh_bvh_t *bvh = sk_malloc_zero_t(mesh_bvh_t, 1);
+    bvh->the_mesh       = mesh;
+    bvh->collision_data = collision_data;
+
     // Compute triangle centroids, used during construction to partition
     // triangles in two groups
 
-    const uint32_t num_triangles = mesh->ind_count / 3;
-
-    const vec3* triangle_vertices = bvh->collision_data->pts;
     vec3* triangle_centroids = sk_malloc_t(vec3, num_triangles);
     
     for (uint32_t t = 0; t < num_triangles; t++) {
         triangle_centroids[t] = 0.33333f * (
-            triangle_vertices[3*t+0] + triangle_vertices[3*t+1] + triangle_vertices[3*t+2]
+            mesh_collision_pt(collision_data, 3*t+0) + mesh_collision_pt(collision_data, 3*t+1) + mesh_collision_pt(collision_data, 3*t+2)
         );
     }
 
-#ifdef VERBOSE_BUILD
-    const vert_t* vertices = mesh->verts;
-    const vind_t* indices  = mesh->inds;
-
-    printf("%d triangles:\n", num_triangles);
-    for (int t = 0; t < num_triangles; t++)
-    {
-        printf("[tri %d] %d %d %d\n", t, indices[3*t+0], indices[3*t+1], indices[3*t+2]);
-        for (int i = 0; i < 3; i++)
-            printf("... %.6f %.6f %.6f\n", vertices[indices[3*t+i]].pos.x, vertices[indices[3*t+i]].pos.y, vertices[indices[3*t+i]].pos.z);
-        printf("... centroid %.6f, %.6f, %.6f\n", triangle_centroids[t].x, triangle_centroids[t].y, triangle_centroids[t].z);
-    }
-#endif
-
     // List of triangle indices, which will get reordered during construction
     uint32_t *sorted_triangles = bvh->sorted_triangles = sk_malloc_t(uint32_t, num_triangles);
     for (uint32_t i = 0; i < num_triangles; i++)
         sorted_triangles[i] = i;
 
-    // Compute mesh bounding box (could reuse what's in mesh_t, but not sure it's accurate)
-
-    boundingbox mesh_bbox;
-    bound_triangles(mesh_bbox, sorted_triangles, triangle_vertices, 0, num_triangles-1);
-
-#ifdef VERBOSE_BUILD
-    printf("bvh_build():\n");
-    printf("... mesh of %d triangles\n", num_triangles);
-    printf("... bounding box:\n");
-    printf("... (min) %.6f, %.6f, %.6f\n", bbox_min(mesh_bbox).x, bbox_min(mesh_bbox).y, bbox_min(mesh_bbox).z);
-    printf("... (max) %.6f, %.6f, %.6f\n", bbox_max(mesh_bbox).x, bbox_max(mesh_bbox).y, bbox_max(mesh_bbox).z);
-    printf("... acceptable leaf size %d\n", acc_leaf_size);
-#endif
-
-    bbox_grow(mesh_bbox, C_EPSILON);
-    bvh->the_mesh = mesh;
-
-    // We pre-allocate an array of BVH nodes, enough to always fit. 
-    // XXX After construction is done, and the actual
-    // number of nodes needed is known we should trim
-    // the array.
-
-    bvh_node_t *nodes = bvh->nodes = sk_malloc_t(bvh_node_t, num_triangles*2);
+    // A binary tree with at least one triangle per leaf never needs more than
+    // 2n-1 nodes, the array is trimmed once the real count is known.
+    bvh_node_t *nodes = sk_malloc_t(bvh_node_t, num_triangles*2);
 
     // Bootstrap with a single leaf node holding all triangles
-    
     bvh_node_t& root_node = nodes[0];
-    root_node.leaf_first = 0;
+    root_node.leaf_first    = 0;
     root_node.num_triangles = num_triangles;
-    root_node.bbox = mesh_bbox;
-
-    // XXX could return value from build function, instead of using a variable
-    uint32_t next_node_index = 1;
+    bound_triangles(root_node.bbox, sorted_triangles, collision_data, 0, num_triangles);
 
-    // Build the BVH
+    boundingbox root_centroids;
+    bound_centroids(root_centroids, sorted_triangles, triangle_centroids, 0, num_triangles);
 
-    mesh_bvh_build_recursive(0, nodes, &next_node_index, sorted_triangles,
-        acc_leaf_size, triangle_vertices, triangle_centroids, bvh->collision_data);
+    // Build the BVH, the calling thread takes the root and then helps out
+    // with the subtrees other workers haven't gotten to.
+    bvh_build_t build = {};
+    build.nodes              = nodes;
+    build.sorted_triangles   = sorted_triangles;
+    build.collision_data     = collision_data;
+    build.triangle_centroids = triangle_centroids;
+    build.acc_leaf_size      = acc_leaf_size;
+    build.priority           = priority;
 
-#if defined(VERBOSE_STATS)
-    const double t1 = time_get_raw();
+    bvh_build_node(&build, 0, root_centroids);
+    jobs_wait(&build.counter, priority);
 
-    // XXX use log function
-    printf("BVH construction done in %.1fms\n", 1000*(t1-t0));
+    const uint32_t node_count = 1 + 2 * (uint32_t)build.next_pair;
+    bvh->nodes = sk_realloc_t(bvh_node_t, nodes, node_count);
 
-    // Done!
+    sk_free(triangle_centroids);
 
     if (show_stats)
     {
-        printf("BVH statistics:\n");
-        printf("... %d triangles\n", bvh->the_mesh->ind_count/3);
         bvh_stats_t stats;
         mesh_bvh_statistics(bvh, &stats, acc_leaf_size);
-        printf("... depth %d\n", stats.depth);
-        printf("... %d leaf nodes, %d inner nodes\n",
-            stats.num_leafs, stats.num_inner_nodes);
-        printf("... maximum leaf size %d\n", stats.max_leaf_size);
-        printf("... %d forced leafs (%.1f%%)\n", stats.num_forced_leafs, 100.0f * stats.num_forced_leafs / stats.num_leafs);
+        log_diagf("BVH built for %u triangles in %.1fms: depth %d, %u leaf nodes, %u inner nodes, max leaf size %u, %u forced leafs",
+            num_triangles, stm_ms(stm_since(t0)), stats.depth, stats.num_leafs, stats.num_inner_nodes, stats.max_leaf_size, stats.num_forced_leafs);
     }
-#endif
-
-    // Clean up
-
-    free(triangle_centroids);
 
     return bvh;
 }
@@ -488,9 +578,9 @@ mesh_bvh_create(const mesh_t mesh, int acc_leaf_size, bool show_stats)
 void
 mesh_bvh_destroy(mesh_bvh_t *bvh)
 {
-    free(bvh->nodes);
-    free(bvh->sorted_triangles);
-    *bvh = {};
+    sk_free(bvh->nodes);
+    sk_free(bvh->sorted_triangles);
+    sk_free(bvh);
 }
 
 // Find closest triangle intersection for the given model-space ray
@@ -620,7 +710,7 @@ mesh_bvh_intersect(const mesh_bvh_t *bvh, ray_t model_space_ray, ray_t *out_pt,
             for (uint32_t t = node.leaf_first; t < node.leaf_first+node.num_triangles; t++)
             {
                 uint32_t triangle = sorted_triangles[t];
-                const plane_t& plane = collision_data->planes[triangle];
+                const plane_t  plane = mesh_collision_plane(collision_data, triangle);
 
                 // Inline version of plane_ray_intersect(), as we need the t value
                 // XXX use cull_mode value based on dot denom
@@ -653,9 +743,10 @@ mesh_bvh_intersect(const mesh_bvh_t *bvh, ray_t model_space_ray, ray_t *out_pt,
                 // https://blackpawn.com/texts/pointinpoly/default.html
 
                 // Compute vectors
-                vec3 v0 = collision_data->pts[3*triangle+1] - collision_data->pts[3*triangle+0];
-                vec3 v1 = collision_data->pts[3*triangle+2] - collision_data->pts[3*triangle+0];
-                vec3 v2 = pt - collision_data->pts[3*triangle+0];
+                vec3 p0 = mesh_collision_pt(collision_data, 3*triangle+0);
+                vec3 v0 = mesh_collision_pt(collision_data, 3*triangle+1) - p0;
+                vec3 v1 = mesh_collision_pt(collision_data, 3*triangle+2) - p0;
+                vec3 v2 = pt - p0;
 
                 // Compute dot products
                 float dot00 = vec3_dot(v0, v0);
@@ -681,7 +772,7 @@ mesh_bvh_intersect(const mesh_bvh_t *bvh, ray_t model_space_ray, ray_t *out_pt,
                         if (out_start_inds != nullptr) {
                             *out_start_inds = 3*triangle;
                         }
-                        *out_pt = {pt, collision_data->planes[triangle].normal};
+                        *out_pt = {pt, plane.normal};
                     }
                 }
             }
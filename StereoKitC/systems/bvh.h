@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../stereokit.h"
+#include "jobs.h"
 
 namespace sk {
 
@@ -24,7 +25,9 @@ struct mesh_bvh_t
     uint32_t            *sorted_triangles;    
 };
 
-mesh_bvh_t* mesh_bvh_create(const mesh_t mesh, int acc_leaf_size=16, bool show_stats=true);
+// Subtrees of large meshes are built in parallel as jobs of the given
+// priority, the calling thread helps with them until the BVH is done.
+mesh_bvh_t* mesh_bvh_create(const mesh_t mesh, int acc_leaf_size=16, bool show_stats=false, job_priority_ priority=job_priority_high);
 void        mesh_bvh_destroy(mesh_bvh_t* bvh);
 bool        mesh_bvh_intersect(const mesh_bvh_t *bvh, ray_t model_space_ray, ray_t *out_pt, uint32_t* out_start_inds, cull_ cull_mode);
 void        mesh_bvh_statistics(const mesh_bvh_t *bvh, bvh_stats_t *stats, int acc_leaf_size=16);
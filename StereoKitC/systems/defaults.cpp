@@ -29,6 +29,8 @@ shader_t     sk_default_shader_pbr;
 shader_t     sk_default_shader_pbr_clip;
 shader_t     sk_default_shader_unlit;
 shader_t     sk_default_shader_unlit_clip;
+shader_t     sk_default_shader_pbr_skin;
+shader_t     sk_default_shader_unlit_skin;
 shader_t     sk_default_shader_lightmap;
 shader_t     sk_default_shader_font;
 shader_t     sk_default_shader_equirect;
@@ -195,6 +197,8 @@ bool defaults_init() {
 	SHADER_DECODE(sks_shader_builtin_lines_hlsl_zip      ); sk_default_shader_lines       = shader_create_mem(data, size);
 	SHADER_DECODE(sks_shader_builtin_pbr_hlsl_zip        ); sk_default_shader_pbr         = shader_create_mem(data, size);
 	SHADER_DECODE(sks_shader_builtin_pbr_clip_hlsl_zip   ); sk_default_shader_pbr_clip    = shader_create_mem(data, size);
+	SHADER_DECODE(sks_shader_builtin_pbr_skin_hlsl_zip   ); sk_default_shader_pbr_skin    = shader_create_mem(data, size);
+	SHADER_DECODE(sks_shader_builtin_unlit_skin_hlsl_zip ); sk_default_shader_unlit_skin  = shader_create_mem(data, size);
 	sk_free(data);
 #undef SHADER_DECODE
 	
@@ -242,6 +246,12 @@ bool defaults_init() {
 	shader_set_id(sk_default_shader_sky,         default_id_shader_sky);
 	shader_set_id(sk_default_shader_lines,       default_id_shader_lines);
 
+	// The skinning shaders need structured buffers, which not every platform
+	// has. They're optional, and skinned models fall back to the CPU without
+	// them.
+	if (sk_default_shader_pbr_skin  ) shader_set_id(sk_default_shader_pbr_skin,   "default/shader_pbr_skin");
+	if (sk_default_shader_unlit_skin) shader_set_id(sk_default_shader_unlit_skin, "default/shader_unlit_skin");
+
 	// Materials
 	sk_default_material             = material_create(sk_default_shader);
 	sk_default_material_pbr         = material_create(sk_default_shader_pbr);
@@ -375,6 +385,8 @@ void defaults_shutdown() {
 	shader_release  (sk_default_shader_lines);
 	shader_release  (sk_default_shader_pbr);
 	shader_release  (sk_default_shader_pbr_clip);
+	shader_release  (sk_default_shader_pbr_skin);
+	shader_release  (sk_default_shader_unlit_skin);
 	mesh_release    (sk_default_cube);
 	mesh_release    (sk_default_sphere);
 	mesh_release    (sk_default_quad);
@@ -22,6 +22,8 @@ extern shader_t     sk_default_shader;
 extern shader_t     sk_default_shader_blit;
 extern shader_t     sk_default_shader_pbr;
 extern shader_t     sk_default_shader_unlit;
+extern shader_t     sk_default_shader_pbr_skin;
+extern shader_t     sk_default_shader_unlit_skin;
 extern shader_t     sk_default_shader_lightmap;
 extern shader_t     sk_default_shader_font;
 extern shader_t     sk_default_shader_equirect;
@@ -0,0 +1,370 @@
+#include "jobs.h"
+#include "profiler.h"
+
+#include "../stereokit.h"
+#include "../sk_memory.h"
+#include "../platforms/platform.h"
+#include "../libraries/ferr_thread.h"
+#include "../libraries/atomic_util.h"
+
+#if defined(SK_OS_WINDOWS) || defined(SK_OS_WINDOWS_UWP)
+	#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+	#include <unistd.h>
+#endif
+
+#include <string.h>
+#include <stdio.h>
+
+namespace sk {
+
+///////////////////////////////////////////
+
+struct job_t {
+	job_func_t     func;
+	void          *data;
+	job_counter_t *counter;
+};
+
+// A small ring buffer deque. The owning worker pushes and pops at the tail,
+// everyone else steals from the head, so the owner stays on the most cache
+// friendly work while thieves take the oldest.
+struct job_queue_t {
+	ft_mutex_t       mtx;
+	job_t           *items;
+	int32_t          capacity;
+	int32_t          head;
+	volatile int32_t count;
+};
+
+struct job_worker_t {
+	job_queue_t lanes[job_priority_max];
+	ft_id_t     id;
+	int32_t     index;
+	uint32_t    steal_seed;
+	// Written by the worker as it exits, read by jobs_shutdown.
+	volatile bool32_t running;
+};
+
+struct jobs_state_t {
+	job_worker_t    *workers;
+	int32_t          worker_count;
+	job_queue_t      shared[job_priority_max]; // Jobs from non-worker threads
+	ft_mutex_t       sleep_mtx;
+	ft_condition_t   sleep_cond;
+	volatile int32_t pending;
+	volatile int32_t sleeping;
+	volatile bool32_t run;
+};
+static jobs_state_t local = {};
+
+static thread_local int32_t jobs_local_worker = -1;
+
+int32_t jobs_worker_thread(void *worker);
+
+///////////////////////////////////////////
+// Queue                                 //
+///////////////////////////////////////////
+
+void job_queue_init(job_queue_t *queue) {
+	*queue = {};
+	queue->mtx      = ft_mutex_create();
+	queue->capacity = 64;
+	queue->items    = sk_malloc_t(job_t, queue->capacity);
+}
+
+///////////////////////////////////////////
+
+void job_queue_free(job_queue_t *queue) {
+	ft_mutex_destroy(&queue->mtx);
+	sk_free(queue->items);
+	*queue = {};
+}
+
+///////////////////////////////////////////
+
+void job_queue_push(job_queue_t *queue, const job_t &job) {
+	ft_mutex_lock(queue->mtx);
+	if (queue->count == queue->capacity) {
+		// Unroll the ring into a buffer twice the size
+		job_t *items = sk_malloc_t(job_t, queue->capacity * 2);
+		for (int32_t i = 0; i < queue->count; i++)
+			items[i] = queue->items[(queue->head + i) & (queue->capacity - 1)];
+		sk_free(queue->items);
+		queue->items     = items;
+		queue->capacity *= 2;
+		queue->head      = 0;
+	}
+	queue->items[(queue->head + queue->count) & (queue->capacity - 1)] = job;
+	queue->count += 1;
+	ft_mutex_unlock(queue->mtx);
+}
+
+///////////////////////////////////////////
+
+bool job_queue_pop_back(job_queue_t *queue, job_t *out_job) {
+	if (queue->count == 0) return false;
+
+	bool result = false;
+	ft_mutex_lock(queue->mtx);
+	if (queue->count > 0) {
+		queue->count -= 1;
+		*out_job = queue->items[(queue->head + queue->count) & (queue->capacity - 1)];
+		result   = true;
+	}
+	ft_mutex_unlock(queue->mtx);
+	return result;
+}
+
+///////////////////////////////////////////
+
+bool job_queue_pop_front(job_queue_t *queue, job_t *out_job) {
+	if (queue->count == 0) return false;
+
+	bool result = false;
+	ft_mutex_lock(queue->mtx);
+	if (queue->count > 0) {
+		*out_job     = queue->items[queue->head];
+		queue->head  = (queue->head + 1) & (queue->capacity - 1);
+		queue->count -= 1;
+		result       = true;
+	}
+	ft_mutex_unlock(queue->mtx);
+	return result;
+}
+
+///////////////////////////////////////////
+// Scheduler                             //
+///////////////////////////////////////////
+
+int32_t jobs_hardware_threads() {
+#if defined(SK_OS_WINDOWS) || defined(SK_OS_WINDOWS_UWP)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int32_t)info.dwNumberOfProcessors;
+#elif defined(__EMSCRIPTEN__)
+	return 1;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int32_t)count : 1;
+#endif
+}
+
+///////////////////////////////////////////
+
+bool jobs_init() {
+	local = {};
+	local.run        = true;
+	local.sleep_mtx  = ft_mutex_create();
+	local.sleep_cond = ft_condition_create();
+	for (int32_t p = 0; p < job_priority_max; p++)
+		job_queue_init(&local.shared[p]);
+
+	// One worker per core, leaving a core for the main thread. Web builds
+	// don't get threads, and run jobs from the main thread instead.
+#if !defined(__EMSCRIPTEN__)
+	int32_t count = jobs_hardware_threads() - 1;
+	local.worker_count = count < 1 ? 1 : (count > 32 ? 32 : count);
+#endif
+	local.workers = local.worker_count > 0
+		? sk_malloc_zero_t(job_worker_t, local.worker_count)
+		: nullptr;
+	for (int32_t i = 0; i < local.worker_count; i++) {
+		job_worker_t *worker = &local.workers[i];
+		for (int32_t p = 0; p < job_priority_max; p++)
+			job_queue_init(&worker->lanes[p]);
+		worker->index      = i;
+		worker->steal_seed = (uint32_t)i * 2654435761u + 1;
+		worker->running    = true;
+	}
+	for (int32_t i = 0; i < local.worker_count; i++) {
+		ft_thread_create(jobs_worker_thread, &local.workers[i]);
+	}
+
+	log_diagf("Job system started with <~grn>%d<~clr> workers.", local.worker_count);
+	return true;
+}
+
+///////////////////////////////////////////
+
+void jobs_shutdown() {
+	ft_mutex_lock(local.sleep_mtx);
+	local.run = false;
+	ft_condition_broadcast(local.sleep_cond);
+	ft_mutex_unlock(local.sleep_mtx);
+
+	for (int32_t i = 0; i < local.worker_count; i++) {
+		while (local.workers[i].running)
+			ft_yield();
+	}
+	// Make sure everything the workers wrote before exiting is visible here.
+	atomic_barrier();
+	// Anything still queued without a worker to take it gets run here.
+	while (jobs_execute_one(job_priority_low));
+
+	for (int32_t i = 0; i < local.worker_count; i++) {
+		for (int32_t p = 0; p < job_priority_max; p++)
+			job_queue_free(&local.workers[i].lanes[p]);
+	}
+	for (int32_t p = 0; p < job_priority_max; p++)
+		job_queue_free(&local.shared[p]);
+	sk_free(local.workers);
+	ft_mutex_destroy    (&local.sleep_mtx);
+	ft_condition_destroy(&local.sleep_cond);
+	local = {};
+}
+
+///////////////////////////////////////////
+
+void jobs_add(job_func_t func, void *data, job_priority_ priority, job_counter_t *counter) {
+	if (counter) atomic_increment(&counter->remaining);
+
+	job_t job = { func, data, counter };
+	int32_t self = jobs_local_worker;
+	job_queue_push(self >= 0
+		? &local.workers[self].lanes[priority]
+		: &local.shared[priority], job);
+
+	// pending is bumped with a full barrier before sleeping is read, and
+	// workers do the reverse, so one side always sees the other.
+	atomic_increment(&local.pending);
+	if (local.sleeping > 0) {
+		ft_mutex_lock(local.sleep_mtx);
+		ft_condition_signal(local.sleep_cond);
+		ft_mutex_unlock(local.sleep_mtx);
+	}
+}
+
+///////////////////////////////////////////
+
+bool jobs_take(job_priority_ lowest_priority, job_t *out_job) {
+	int32_t self = jobs_local_worker;
+	for (int32_t p = 0; p <= lowest_priority; p++) {
+		if (self >= 0 && job_queue_pop_back(&local.workers[self].lanes[p], out_job)) return true;
+		if (job_queue_pop_front(&local.shared[p], out_job)) return true;
+
+		// Steal from the other workers, starting somewhere random so
+		// thieves don't all pile onto the same victim.
+		if (local.worker_count == 0) continue;
+		uint32_t start = 0;
+		if (self >= 0) {
+			uint32_t *seed = &local.workers[self].steal_seed;
+			*seed ^= *seed << 13; *seed ^= *seed >> 17; *seed ^= *seed << 5;
+			start  = *seed;
+		}
+		for (int32_t i = 0; i < local.worker_count; i++) {
+			int32_t victim = (int32_t)((start + i) % (uint32_t)local.worker_count);
+			if (victim == self) continue;
+			if (job_queue_pop_front(&local.workers[victim].lanes[p], out_job)) return true;
+		}
+	}
+	return false;
+}
+
+///////////////////////////////////////////
+
+bool jobs_execute_one(job_priority_ lowest_priority) {
+	job_t job;
+	if (!jobs_take(lowest_priority, &job))
+		return false;
+	atomic_decrement(&local.pending);
+
+	profiler_scope_t zone("Job");
+	job.func(job.data);
+	if (job.counter) atomic_decrement(&job.counter->remaining);
+	return true;
+}
+
+///////////////////////////////////////////
+
+void jobs_wait(job_counter_t *counter, job_priority_ help_priority) {
+	// Help out while waiting, but only with work at or above help_priority,
+	// picking up a long asset load here would stall whoever is waiting.
+	while (counter->remaining > 0) {
+		if (!jobs_execute_one(help_priority))
+			ft_yield();
+	}
+	atomic_barrier();
+}
+
+///////////////////////////////////////////
+
+struct jobs_range_t {
+	void  (*func)(int32_t start, int32_t end, void *data);
+	void   *data;
+	int32_t start;
+	int32_t end;
+};
+
+void jobs_parallel_for(int32_t count, int32_t batch_size, void (*func)(int32_t start, int32_t end, void *data), void *data) {
+	if (count <= 0) return;
+	if (batch_size < 1) batch_size = 1;
+
+	int32_t batch_count = (count + batch_size - 1) / batch_size;
+	if (local.worker_count == 0 || batch_count == 1) {
+		func(0, count, data);
+		return;
+	}
+
+	jobs_range_t  *ranges  = sk_malloc_t(jobs_range_t, batch_count);
+	job_counter_t  counter = {};
+	for (int32_t i = 0; i < batch_count; i++) {
+		ranges[i].func  = func;
+		ranges[i].data  = data;
+		ranges[i].start = i * batch_size;
+		ranges[i].end   = i == batch_count - 1 ? count : (i + 1) * batch_size;
+		jobs_add([](void *range_data) {
+			jobs_range_t *range = (jobs_range_t *)range_data;
+			range->func(range->start, range->end, range->data);
+		}, &ranges[i], job_priority_high, &counter);
+	}
+	jobs_wait(&counter);
+	sk_free(ranges);
+}
+
+///////////////////////////////////////////
+
+int32_t jobs_worker_count() {
+	return local.worker_count;
+}
+
+///////////////////////////////////////////
+
+bool jobs_is_worker() {
+	return jobs_local_worker >= 0;
+}
+
+///////////////////////////////////////////
+
+int32_t jobs_worker_thread(void *worker_ptr) {
+	job_worker_t *worker = (job_worker_t *)worker_ptr;
+	worker->id        = ft_id_current();
+	jobs_local_worker = worker->index;
+
+	char name[32];
+	snprintf(name, sizeof(name), "Job Worker %d", worker->index);
+	profiler_thread_name(name);
+
+	while (local.run) {
+		if (jobs_execute_one(job_priority_low))
+			continue;
+
+		ft_mutex_lock(local.sleep_mtx);
+		atomic_increment(&local.sleeping);
+		while (local.run && local.pending == 0)
+			ft_condition_wait(local.sleep_cond, local.sleep_mtx);
+		atomic_decrement(&local.sleeping);
+		ft_mutex_unlock(local.sleep_mtx);
+	}
+
+	jobs_local_worker = -1;
+	// Publish this worker's writes before shutdown can see it as stopped.
+	atomic_barrier();
+	worker->running   = false;
+	return 0;
+}
+
+} // namespace sk
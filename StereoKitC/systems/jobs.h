@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace sk {
+
+// Lanes are always drained in this order, so anything the current frame is
+// blocked on should go in high, and long running loads should go in low.
+typedef enum job_priority_ {
+	job_priority_high,
+	job_priority_normal,
+	job_priority_low,
+	job_priority_max,
+} job_priority_;
+
+// Tracks a group of jobs so they can be waited on. Zero initialize it, and
+// keep it alive until jobs_wait returns.
+struct job_counter_t {
+	volatile int32_t remaining;
+};
+
+typedef void (*job_func_t)(void *data);
+
+bool    jobs_init        ();
+void    jobs_shutdown    ();
+
+void    jobs_add         (job_func_t func, void *data, job_priority_ priority, job_counter_t *counter = nullptr);
+void    jobs_wait        (job_counter_t *counter, job_priority_ help_priority = job_priority_high);
+void    jobs_parallel_for(int32_t count, int32_t batch_size, void (*func)(int32_t start, int32_t end, void *data), void *data);
+bool    jobs_execute_one (job_priority_ lowest_priority);
+int32_t jobs_worker_count();
+bool    jobs_is_worker   ();
+
+} // namespace sk
@@ -2,6 +2,7 @@
 #include "../stereokit.h"
 #include "../_stereokit.h"
 #include "../libraries/array.h"
+#include "profiler.h"
 
 #if !defined(SK_PHYSICS_PASSTHROUGH)
 #pragma warning(push)
@@ -92,6 +93,7 @@ void physics_step() {
 	}
 
 	// Sim physics!
+	profiler_scope_t sim_zone("Physics Simulate");
 	while (physics_sim_time < time_total()) {
 		physics_world->update((reactphysics3d::decimal)physics_step_time);
 		physics_sim_time += physics_step_time;
@@ -0,0 +1,385 @@
+#include "profiler.h"
+
+#include "../stereokit.h"
+#include "../sk_memory.h"
+#include "../log.h"
+#include "../libraries/array.h"
+#include "../libraries/atomic_util.h"
+#include "../libraries/ferr_hash.h"
+#include "../libraries/ferr_thread.h"
+#include "../libraries/sokol_time.h"
+#include "../libraries/stref.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+namespace sk {
+
+///////////////////////////////////////////
+
+// Must be a power of two, event indices wrap with a mask.
+#define PROFILER_EVENT_CAPACITY (1 << 15)
+#define PROFILER_STACK_DEPTH    64
+#define PROFILER_FRAME_HISTORY  300
+// Names are never removed, so the table is allocated once, and can be read
+// without a lock.
+#define PROFILER_NAME_MAX       4096
+
+struct profiler_event_t {
+	const char *name;
+	uint64_t    start;
+	uint64_t    end;
+	int32_t     depth;
+};
+
+// Only the owning thread ever writes to one of these. Exporting reads the
+// ring while it may still be written to, so the oldest events of a busy
+// thread can occasionally come out torn, which is fine for a profiler.
+struct profiler_thread_t {
+	int32_t           id;
+	char              name[64];
+	profiler_event_t *events;
+	volatile uint32_t event_count;
+	const char       *stack_names [PROFILER_STACK_DEPTH];
+	uint64_t          stack_starts[PROFILER_STACK_DEPTH];
+	int32_t           depth;
+};
+
+struct profiler_name_t {
+	uint64_t hash;
+	int32_t  index;
+};
+
+struct profiler_state_t {
+	bool                         initialized;
+	ft_mutex_t                   mtx;
+	array_t<profiler_thread_t *> threads;
+	array_t<profiler_name_t>     names;      // Sorted by hash, for finding a name's index
+	char                       **name_table; // Append only, indexed by zone id
+	volatile int32_t             name_count;
+	uint64_t                     frame_starts[PROFILER_FRAME_HISTORY];
+	uint32_t                     frame_count;
+};
+static profiler_state_t local = {};
+
+// These live outside of local so they survive a shutdown and re-init.
+static bool     profiler_requested  = false;
+static uint32_t profiler_generation = 0;
+
+volatile bool profiler_recording = false;
+
+// Thread buffers are tagged with the profiler generation they were created
+// in, so a thread that outlives an sk_shutdown doesn't use a freed buffer.
+static thread_local profiler_thread_t *profiler_local_thread     = nullptr;
+static thread_local uint32_t           profiler_local_generation = 0;
+static thread_local char               profiler_local_name[64]   = {};
+
+///////////////////////////////////////////
+
+void profiler_init() {
+	local = {};
+	local.mtx         = ft_mutex_create();
+	local.name_table  = sk_malloc_zero_t(char *, PROFILER_NAME_MAX);
+	local.initialized = true;
+	profiler_generation += 1;
+}
+
+///////////////////////////////////////////
+
+void profiler_shutdown() {
+	profiler_recording = false;
+	if (!local.initialized) return;
+
+	for (int32_t i = 0; i < local.threads.count; i++) {
+		sk_free(local.threads[i]->events);
+		sk_free(local.threads[i]);
+	}
+	for (int32_t i = 0; i < local.name_count; i++) {
+		sk_free(local.name_table[i]);
+	}
+	sk_free(local.name_table);
+	local.threads.free();
+	local.names  .free();
+	ft_mutex_destroy(&local.mtx);
+	local = {};
+}
+
+///////////////////////////////////////////
+
+profiler_thread_t *profiler_thread_current() {
+	return profiler_local_generation == profiler_generation
+		? profiler_local_thread
+		: nullptr;
+}
+
+///////////////////////////////////////////
+
+profiler_thread_t *profiler_thread_get() {
+	profiler_thread_t *thread = profiler_thread_current();
+	if (thread != nullptr || !local.initialized) return thread;
+
+	thread = sk_malloc_zero_t(profiler_thread_t, 1);
+	thread->events = sk_malloc_t(profiler_event_t, PROFILER_EVENT_CAPACITY);
+
+	ft_mutex_lock(local.mtx);
+	thread->id = local.threads.count;
+	if (profiler_local_name[0] != '\0') memcpy(thread->name, profiler_local_name, sizeof(thread->name));
+	else                                snprintf(thread->name, sizeof(thread->name), "Thread %d", thread->id);
+	local.threads.add(thread);
+	ft_mutex_unlock(local.mtx);
+
+	profiler_local_thread     = thread;
+	profiler_local_generation = profiler_generation;
+	return thread;
+}
+
+///////////////////////////////////////////
+
+void profiler_thread_name(const char *name) {
+	snprintf(profiler_local_name, sizeof(profiler_local_name), "%s", name);
+
+	profiler_thread_t *thread = profiler_thread_current();
+	if (thread == nullptr) return;
+	ft_mutex_lock(local.mtx);
+	memcpy(thread->name, profiler_local_name, sizeof(thread->name));
+	ft_mutex_unlock(local.mtx);
+}
+
+///////////////////////////////////////////
+
+void profiler_frame_begin() {
+	bool recording = local.initialized && profiler_requested;
+	if (recording && !profiler_recording) {
+		// Starting fresh, anything left from a previous recording session
+		// falls before the first frame and won't be exported.
+		local.frame_count = 0;
+		profiler_thread_name("Main");
+	}
+	profiler_recording = recording;
+	if (!recording) return;
+
+	local.frame_starts[local.frame_count % PROFILER_FRAME_HISTORY] = stm_now();
+	local.frame_count += 1;
+}
+
+///////////////////////////////////////////
+
+bool profiler_zone_push_now(const char *name) {
+	profiler_thread_t *thread = profiler_thread_get();
+	if (thread == nullptr) return false;
+
+	// Zones past the stack limit still count towards depth so pops stay
+	// balanced, they just don't get recorded.
+	if (thread->depth < PROFILER_STACK_DEPTH) {
+		thread->stack_names [thread->depth] = name;
+		thread->stack_starts[thread->depth] = stm_now();
+	}
+	thread->depth += 1;
+	return true;
+}
+
+///////////////////////////////////////////
+
+void profiler_zone_pop() {
+	profiler_thread_t *thread = profiler_thread_current();
+	if (thread == nullptr || thread->depth <= 0) return;
+
+	thread->depth -= 1;
+	if (thread->depth >= PROFILER_STACK_DEPTH || !profiler_recording) return;
+
+	uint32_t          index = thread->event_count;
+	profiler_event_t *evt   = &thread->events[index & (PROFILER_EVENT_CAPACITY - 1)];
+	evt->name  = thread->stack_names [thread->depth];
+	evt->start = thread->stack_starts[thread->depth];
+	evt->end   = stm_now();
+	evt->depth = thread->depth;
+	// Publish the event only after it's completely written.
+	atomic_barrier();
+	thread->event_count = index + 1;
+}
+
+///////////////////////////////////////////
+
+// Returns the name's index in the name table, or -1 if the table is full.
+int32_t profiler_intern(const char *name) {
+	uint64_t hash = hash_fnv64_string(name);
+
+	ft_mutex_lock(local.mtx);
+	int32_t result = -1;
+	int32_t idx    = local.names.binary_search(&profiler_name_t::hash, hash);
+	if (idx >= 0) {
+		result = local.names[idx].index;
+	} else if (local.name_count < PROFILER_NAME_MAX) {
+		result = local.name_count;
+		local.name_table[result] = string_copy(name);
+		local.names.insert(~idx, profiler_name_t{ hash, result });
+		// Lock-free readers check the count first, so the name has to be
+		// in place before it goes up.
+		atomic_barrier();
+		local.name_count = result + 1;
+	} else {
+		log_warn("profiler: Too many unique zone names, extra zones will be unnamed.");
+	}
+	ft_mutex_unlock(local.mtx);
+	return result;
+}
+
+///////////////////////////////////////////
+
+const char *profiler_name_get(int32_t index) {
+	return index >= 0 ? local.name_table[index] : "Unnamed";
+}
+
+///////////////////////////////////////////
+
+// Once a thread has an open zone, everything nested inside it is tracked,
+// even if recording stops partway, so begin/end pairs from the public API
+// can't get mismatched.
+bool profiler_zone_should_begin() {
+	if (!local.initialized) return false;
+	if (profiler_recording) return true;
+	profiler_thread_t *thread = profiler_thread_current();
+	return thread != nullptr && thread->depth > 0;
+}
+
+///////////////////////////////////////////
+
+void profiler_set_enabled(bool32_t enabled) {
+	profiler_requested = enabled != 0;
+}
+
+///////////////////////////////////////////
+
+bool32_t profiler_get_enabled() {
+	return profiler_requested;
+}
+
+///////////////////////////////////////////
+
+void profiler_zone_begin(const char *name) {
+	if (!profiler_zone_should_begin()) return;
+
+	// Public API names may be temporary, like marshalled C# strings, so they
+	// get interned into a table that lives as long as the profiler.
+	profiler_zone_push_now(profiler_name_get(profiler_intern(name)));
+}
+
+///////////////////////////////////////////
+
+// Ids are the profiler generation in the high bits, and the name index + 1
+// in the low bits, so ids from before a shutdown are ignored.
+profiler_zone_id_t profiler_zone_name(const char *name) {
+	if (!local.initialized) return 0;
+	int32_t index = profiler_intern(name);
+	if (index < 0) return 0;
+	return ((uint64_t)profiler_generation << 32) | (uint64_t)(index + 1);
+}
+
+///////////////////////////////////////////
+
+void profiler_zone_begin_id(profiler_zone_id_t zone) {
+	if (!profiler_zone_should_begin()) return;
+
+	// Invalid ids still push a zone, since the caller will still end it.
+	int32_t index = (int32_t)(zone & 0xFFFFFFFF) - 1;
+	if ((uint32_t)(zone >> 32) != profiler_generation || index >= local.name_count)
+		index = -1;
+	atomic_barrier();
+	profiler_zone_push_now(profiler_name_get(index));
+}
+
+///////////////////////////////////////////
+
+void profiler_zone_end() {
+	profiler_zone_pop();
+}
+
+///////////////////////////////////////////
+
+void profiler_appendf(array_t<char> *text, const char *format, ...) {
+	char    buffer[256];
+	va_list args;
+	va_start(args, format);
+	int32_t length = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if (length < 0) return;
+	if (length >= (int32_t)sizeof(buffer)) length = sizeof(buffer) - 1;
+	text->add_range(buffer, length);
+}
+
+///////////////////////////////////////////
+
+void profiler_append_string(array_t<char> *text, const char *str) {
+	text->add('"');
+	for (const char *c = str; *c != '\0'; c++) {
+		if      (*c == '"' || *c == '\\') { text->add('\\'); text->add(*c); }
+		else if ((unsigned char)*c < 0x20) profiler_appendf(text, "\\u%04x", (unsigned char)*c);
+		else                               text->add(*c);
+	}
+	text->add('"');
+}
+
+///////////////////////////////////////////
+
+bool32_t profiler_save_trace(const char *filename) {
+	if (!local.initialized) {
+		log_err("profiler_save_trace: StereoKit must be initialized first!");
+		return false;
+	}
+	if (local.frame_count == 0) {
+		log_warn("profiler_save_trace: No frames have been recorded, is the profiler enabled?");
+		return false;
+	}
+
+	uint32_t frame_total = local.frame_count;
+	uint32_t frames      = frame_total < PROFILER_FRAME_HISTORY ? frame_total : PROFILER_FRAME_HISTORY;
+	uint32_t frame_first = frame_total - frames;
+	uint64_t origin      = local.frame_starts[frame_first % PROFILER_FRAME_HISTORY];
+
+	// Chrome's trace event format, which Perfetto and chrome://tracing can
+	// both open. Timestamps are in microseconds from the oldest frame.
+	array_t<char> json = {};
+	profiler_appendf(&json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	profiler_appendf(&json, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"StereoKit\"}}");
+
+	for (uint32_t f = frame_first; f < frame_total; f++) {
+		double ts = stm_us(local.frame_starts[f % PROFILER_FRAME_HISTORY] - origin);
+		profiler_appendf(&json, ",\n{\"name\":\"Frame %u\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}", f, ts);
+	}
+
+	ft_mutex_lock(local.mtx);
+	for (int32_t t = 0; t < local.threads.count; t++) {
+		profiler_thread_t *thread = local.threads[t];
+
+		profiler_appendf(&json, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", thread->id);
+		profiler_append_string(&json, thread->name);
+		profiler_appendf(&json, "}}");
+
+		uint32_t count = thread->event_count;
+		atomic_barrier();
+		uint32_t available = count < PROFILER_EVENT_CAPACITY ? count : PROFILER_EVENT_CAPACITY;
+		for (uint32_t i = count - available; i != count; i++) {
+			profiler_event_t evt = thread->events[i & (PROFILER_EVENT_CAPACITY - 1)];
+			if (evt.start < origin || evt.end < evt.start) continue;
+
+			profiler_appendf(&json, ",\n{\"name\":");
+			profiler_append_string(&json, evt.name);
+			profiler_appendf(&json, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				thread->id, stm_us(evt.start - origin), stm_us(evt.end - evt.start));
+		}
+	}
+	ft_mutex_unlock(local.mtx);
+
+	profiler_appendf(&json, "\n]}\n");
+	json.add('\0');
+
+	bool32_t result = platform_write_file_text(filename, json.data);
+	if (result) log_diagf("Saved %u frames of profiling data to %s", frames, filename);
+	else        log_errf ("profiler_save_trace: Failed to write %s", filename);
+	json.free();
+	return result;
+}
+
+} // namespace sk
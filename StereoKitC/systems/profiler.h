@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace sk {
+
+// Nested timing zones recorded per thread into fixed size rings, alongside
+// the start times of the last few hundred frames. Nothing is recorded or
+// allocated until profiler_set_enabled is called, and enabling only takes
+// effect at the next frame boundary.
+
+extern volatile bool profiler_recording;
+
+void profiler_init         ();
+void profiler_shutdown     ();
+// Main thread, once at the start of every frame.
+void profiler_frame_begin  ();
+// Gives the calling thread a readable name in exported traces.
+void profiler_thread_name  (const char *name);
+
+// Zone names are not copied, and must outlive the profiler! String literals
+// are what this is meant for.
+bool profiler_zone_push_now(const char *name);
+void profiler_zone_pop     ();
+inline bool profiler_zone_push(const char *name) { return profiler_recording && profiler_zone_push_now(name); }
+
+struct profiler_scope_t {
+	bool active;
+	profiler_scope_t (const char *name) { active = profiler_zone_push(name); }
+	~profiler_scope_t()                 { if (active) profiler_zone_pop(); }
+};
+
+#define _profiler_concat2(a, b) a##b
+#define _profiler_concat(a, b) _profiler_concat2(a, b)
+// Times the rest of the current scope as a zone with the given name.
+#define profiler_zone(name) profiler_scope_t _profiler_concat(_profiler_zone_, __LINE__)(name)
+
+} // namespace sk
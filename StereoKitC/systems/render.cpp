@@ -6,11 +6,16 @@
 
 #include "render.h"
 #include "render_.h"
+#include "render_gpu_timer.h"
+#include "render_readback.h"
+#include "jobs.h"
 #include "world.h"
+#include "profiler.h"
 #include "defaults.h"
 #include "../_stereokit.h"
 #include "../device.h"
 #include "../libraries/stref.h"
+#include "../libraries/atomic_util.h"
 #include "../sk_math_dx.h"
 #include "../sk_memory.h"
 #include "../spherical_harmonics.h"
@@ -38,11 +43,16 @@ namespace sk {
 
 ///////////////////////////////////////////
 
-
 struct render_transform_buffer_t {
 	XMMATRIX world;
 	color128 color;
 };
+// Matches transform_buffer in stereokit.hlsli, where each draw's instances
+// start in the frame's instance buffer.
+struct render_inst_base_t {
+	uint32_t base;
+	uint32_t pad[3];
+};
 struct render_global_buffer_t {
 	XMMATRIX view[2];
 	XMMATRIX proj[2];
@@ -63,9 +73,32 @@ struct render_blit_data_t {
 	float pixel_width;
 	float pixel_height;
 };
-struct render_inst_buffer {
-	int32_t      max;
+struct render_inst_buffer_t {
 	skg_buffer_t buffer;
+	int32_t      capacity;
+};
+struct render_inst_ring_t {
+	array_t<render_inst_buffer_t> buffers;
+	int32_t                       next;
+	int32_t                       used;
+};
+struct render_inst_run_t {
+	material_t material;
+	mesh_t     mesh;
+	int32_t    mesh_inds;
+	int32_t    start;
+	int32_t    count;
+};
+struct screenshot_ctx_t {
+	char*            filename;
+	int32_t          quality;
+	void           (*on_saved)(const char* file_utf8, bool32_t success, void* context);
+	void*            context;
+	color32*         buffer;
+	int32_t          width;
+	int32_t          height;
+	bool32_t         success;
+	volatile int32_t done;
 };
 struct render_screenshot_t {
 	void        (*render_on_screenshot_callback)(color32* color_buffer, int32_t width, int32_t height, void* context);
@@ -78,6 +111,17 @@ struct render_screenshot_t {
 	render_layer_ layer_filter;
 	render_clear_ clear;
 	tex_format_   tex_format;
+	// If set, this screenshot gets encoded and saved to file, instead of
+	// going to render_on_screenshot_callback.
+	screenshot_ctx_t *save;
+};
+struct render_capture_target_t {
+	tex_t         surface;
+	tex_t         resolve;
+	int32_t       width;
+	int32_t       height;
+	tex_format_   format;
+	uint64_t      last_used;
 };
 struct render_viewpoint_t {
 	tex_t         rendertarget;
@@ -91,23 +135,19 @@ struct render_viewpoint_t {
 
 ///////////////////////////////////////////
 
-typedef enum inst_pool_size_ {
-	inst_pool_size_1,
-	inst_pool_size_8,
-	inst_pool_size_32,
-	inst_pool_size_128,
-	inst_pool_size_512,
-	inst_pool_size_819,
-	inst_pool_size_max,
-} inst_pool_size_;
-const int32_t inst_pool_sizes[] = { 1,8,32,128,512,819 };
+// Frames of render_stats_t kept around for render_get_stats
+#define render_stats_history_max 120
 
 struct render_state_t {
 	bool32_t                initialized;
 
+	// Every instance an execute draws is collected up front, and uploaded
+	// into a single structured buffer. Each run then only needs its base
+	// offset, which goes into a tiny constant buffer.
 	array_t<render_transform_buffer_t> instance_list;
-	array_t<skg_buffer_t>              instance_pool     [inst_pool_size_max];
-	int32_t                            instance_pool_used[inst_pool_size_max];
+	array_t<render_inst_run_t>         instance_runs;
+	render_inst_ring_t                 instance_ring;
+	render_inst_ring_t                 instance_base_ring;
 
 	material_buffer_t       shader_globals;
 	skg_buffer_t            shader_blit;
@@ -141,6 +181,9 @@ struct render_state_t {
 
 	array_t<render_screenshot_t> screenshot_list;
 	array_t<render_viewpoint_t>  viewpoint_list;
+	array_t<render_capture_target_t> capture_pool;
+	array_t<screenshot_ctx_t *>  save_list;
+	job_counter_t                save_counter;
 
 	mesh_t                  sky_mesh;
 	material_t              sky_mat;
@@ -154,29 +197,63 @@ struct render_state_t {
 
 	array_t<render_list_t>  list_stack;
 	render_list_t           list_active;
+
+	XMVECTOR                cull_planes[2][6];
+	int32_t                 cull_view_count;
+
+	render_stats_t          stats_frame;
+	render_stats_t          stats_history[render_stats_history_max];
+	int32_t                 stats_history_count;
+	render_stats_t          stats_layers      [16];
+	render_stats_t          stats_layers_frame[16];
+	volatile int64_t        upload_tex_bytes;
+	volatile int64_t        upload_mesh_bytes;
 };
 static render_state_t local = {};
 
-const int32_t    render_instance_max     = 819;
+// Instance buffers start at this size, and grow by doubling.
+const int32_t    render_instance_min     = 1024;
+// Capture targets that go unused for this many frames get released. These
+// can be big, but periodic captures shouldn't have to recreate them.
+const uint64_t   render_capture_keep     = 300;
 const int32_t    render_skytex_register  = 11;
 const skg_bind_t render_list_global_bind = { 1,  skg_stage_vertex | skg_stage_pixel, skg_register_constant };
-const skg_bind_t render_list_inst_bind   = { 2,  skg_stage_vertex | skg_stage_pixel, skg_register_constant };
+const skg_bind_t render_list_inst_base_bind = { 2,  skg_stage_vertex | skg_stage_pixel, skg_register_constant };
+const skg_bind_t render_list_inst_bind   = { 14, skg_stage_vertex | skg_stage_pixel, skg_register_resource };
 const skg_bind_t render_list_blit_bind   = { 3,  skg_stage_vertex | skg_stage_pixel, skg_register_constant };
+const skg_bind_t render_skin_weight_bind = { 12, skg_stage_vertex,                   skg_register_resource };
+const skg_bind_t render_skin_bone_bind   = { 13, skg_stage_vertex,                   skg_register_resource };
 
 ///////////////////////////////////////////
 
 void          render_set_material     (material_t material);
-skg_buffer_t *render_fill_inst_buffer (const array_t<render_transform_buffer_t>* list, int32_t* ref_offset, int32_t* out_count);
+skg_buffer_t *render_ring_take        (render_inst_ring_t *ring, int32_t capacity, skg_buffer_type_ type, uint32_t stride, const char *name);
 void          render_reset_buffer_pool();
-void          render_save_to_file     (color32* color_buffer, int width, int height, void* context);
+void          render_screenshot_ready (void* data, int32_t width, int32_t height, void* context);
+void          render_save_check       ();
+
+void          render_frustum_planes   (const XMMATRIX &view_proj, XMVECTOR *out_planes);
+bool          render_frustum_visible  (const render_item_t *item);
 
 void          render_list_prep        (render_list_t list);
+void          render_list_merge_shards(render_list_t list);
+render_item_t*render_list_next        (render_list_t list, int32_t *ref_queue_idx, int32_t *ref_persist_idx);
+bool          render_list_is_empty    (render_list_t list);
 void          render_list_add         (const render_item_t *item);
 void          render_list_add_to      (render_list_t list, const render_item_t *item);
+bool          render_list_persist_stale  (render_list_t list, int32_t head);
+void          render_list_persist_refresh(render_list_t list, int32_t head);
+
+void          render_list_sort        (render_list_t list);
 
-void          radix_sort7             (render_item_t *a, size_t count);
+void          render_stats_frame_end  ();
+void          render_stats_add        (render_stats_t *to, const render_stats_t &a, const render_stats_t &b);
+
+void          radix_sort7             (render_sort_key_t *a, size_t count);
 void          radix_sort_clean        ();
 void          radix_sort_init         ();
+render_sort_key_t *radix_keys         (size_t count);
+render_item_t     *radix_items        (size_t count);
 
 ///////////////////////////////////////////
 
@@ -208,7 +285,7 @@ bool render_init() {
 	skg_buffer_name(&local.shader_blit, "sk/render/blit_buffer");
 #endif
 	
-	local.instance_list.resize(render_instance_max);
+	local.instance_list.resize(render_instance_min);
 
 	// Setup a default camera
 	render_set_clip(local.clip_planes.x, local.clip_planes.y);
@@ -226,6 +303,8 @@ bool render_init() {
 		vert_t{ {-1,-1,1}, {0,0,1}, {0,1}, {255,255,255,255} }, };
 	mesh_set_data(local.sky_mesh, verts, _countof(verts), inds, _countof(inds));
 	mesh_set_id  (local.sky_mesh, "sk/render/skybox_mesh");
+	// The sky shader places these verts directly in clip space
+	local.sky_mesh->unbounded = true;
 
 	// Create a default skybox material
 	shader_t shader_sky = shader_find(default_id_shader_sky);
@@ -250,6 +329,8 @@ bool render_init() {
 
 	radix_sort_init();
 	hierarchy_init();
+	render_gpu_timer_init();
+	render_readback_init();
 
 	render_update_projection();
 
@@ -259,6 +340,23 @@ bool render_init() {
 ///////////////////////////////////////////
 
 void render_shutdown() {
+	// Let any in-flight screenshots finish up and get saved
+	render_readback_shutdown();
+	jobs_wait(&local.save_counter, job_priority_low);
+	render_save_check();
+	local.save_list.free();
+	for (int32_t i = 0; i < local.screenshot_list.count; i++) {
+		if (local.screenshot_list[i].save == nullptr) continue;
+		sk_free(local.screenshot_list[i].save->filename);
+		sk_free(local.screenshot_list[i].save);
+	}
+
+	for (int32_t i = 0; i < local.capture_pool.count; i++) {
+		tex_release(local.capture_pool[i].surface);
+		tex_release(local.capture_pool[i].resolve);
+	}
+	local.capture_pool.free();
+
 	render_list_pop();
 	render_list_release(local.list_active);
 	render_list_release(local.list_primary);
@@ -266,6 +364,7 @@ void render_shutdown() {
 	local.screenshot_list.free();
 	local.viewpoint_list .free();
 	local.instance_list  .free();
+	local.instance_runs  .free();
 
 	for (int32_t i = 0; i < _countof(local.global_textures); i++) {
 		tex_release(local.global_textures[i]);
@@ -278,16 +377,18 @@ void render_shutdown() {
 	mesh_release           (local.blit_quad);
 	material_buffer_release(local.shader_globals);
 
-	for (int32_t pool_idx = 0; pool_idx < inst_pool_size_max; pool_idx++) {
-		array_t<skg_buffer_t>* pool = &local.instance_pool[pool_idx];
-		for (int32_t i = 0; i < pool->count; i++) {
-			skg_buffer_destroy(&pool->get(i));
+	render_inst_ring_t *rings[] = { &local.instance_ring, &local.instance_base_ring };
+	for (int32_t r = 0; r < _countof(rings); r++) {
+		for (int32_t i = 0; i < rings[r]->buffers.count; i++) {
+			skg_buffer_destroy(&rings[r]->buffers[i].buffer);
 		}
-		pool->free();
+		rings[r]->buffers.free();
 	}
 
 	skg_buffer_destroy(&local.shader_blit);
 
+	render_gpu_timer_shutdown();
+
 	local = {};
 
 	radix_sort_clean();
@@ -297,6 +398,7 @@ void render_shutdown() {
 ///////////////////////////////////////////
 
 void render_step() {
+	render_stats_frame_end();
 	render_reset_buffer_pool();
 
 	hierarchy_step();
@@ -314,6 +416,9 @@ inline uint64_t render_sort_id(material_t material, mesh_t mesh) {
 inline uint64_t render_sort_id_from_queue(int32_t queue_position) {
 	return (uint64_t)(queue_position) << 32;
 }
+inline int32_t render_item_inds(const render_item_t *item) {
+	return item->mesh_inds < 0 ? item->mesh->ind_draw : item->mesh_inds;
+}
 
 ///////////////////////////////////////////
 
@@ -492,6 +597,91 @@ render_list_t render_get_primary_list() {
 
 ///////////////////////////////////////////
 
+render_stats_t render_get_stats(int32_t frames_ago) {
+	int32_t available = local.stats_history_count < render_stats_history_max
+		? local.stats_history_count
+		: render_stats_history_max;
+	if (frames_ago < 0 || frames_ago >= available) {
+		render_stats_t result = {};
+		result.gpu_ms = -1;
+		return result;
+	}
+	return local.stats_history[(local.stats_history_count - 1 - frames_ago) % render_stats_history_max];
+}
+
+///////////////////////////////////////////
+
+int32_t render_get_stats_history() {
+	return local.stats_history_count < render_stats_history_max
+		? local.stats_history_count
+		: render_stats_history_max;
+}
+
+///////////////////////////////////////////
+
+render_stats_t render_get_layer_stats(render_layer_ layer) {
+	render_stats_t result = {};
+	uint32_t       bits   = (uint32_t)layer;
+	for (int32_t i = 0; i < _countof(local.stats_layers) && bits != 0; i++, bits >>= 1) {
+		if (bits & 1) render_stats_add(&result, local.stats_layers[i], {});
+	}
+	result.gpu_ms = -1;
+	return result;
+}
+
+///////////////////////////////////////////
+
+void render_stats_add_tex_upload(int64_t bytes) {
+	atomic_add64(&local.upload_tex_bytes, bytes);
+}
+
+///////////////////////////////////////////
+
+void render_stats_add_mesh_upload(int64_t bytes) {
+	atomic_add64(&local.upload_mesh_bytes, bytes);
+}
+
+///////////////////////////////////////////
+
+void render_stats_add(render_stats_t *to, const render_stats_t &a, const render_stats_t &b) {
+	to->instance_bytes += a.instance_bytes - b.instance_bytes;
+	to->texture_bytes  += a.texture_bytes  - b.texture_bytes;
+	to->mesh_bytes     += a.mesh_bytes     - b.mesh_bytes;
+	to->items_queued   += a.items_queued   - b.items_queued;
+	to->items_culled   += a.items_culled   - b.items_culled;
+	to->items_sorted   += a.items_sorted   - b.items_sorted;
+	to->sort_reused    += a.sort_reused    - b.sort_reused;
+	to->sort_radix     += a.sort_radix     - b.sort_radix;
+	to->draw_calls     += a.draw_calls     - b.draw_calls;
+	to->draw_instances += a.draw_instances - b.draw_instances;
+	to->swaps_mesh     += a.swaps_mesh     - b.swaps_mesh;
+	to->swaps_material += a.swaps_material - b.swaps_material;
+}
+
+///////////////////////////////////////////
+
+void render_stats_frame_end() {
+	// Uploads can come from any thread, so only take away what we've read,
+	// anything that lands in between will go to the next frame.
+	int64_t tex_bytes  = local.upload_tex_bytes;
+	int64_t mesh_bytes = local.upload_mesh_bytes;
+	atomic_add64(&local.upload_tex_bytes,  -tex_bytes);
+	atomic_add64(&local.upload_mesh_bytes, -mesh_bytes);
+
+	local.stats_frame.texture_bytes = tex_bytes;
+	local.stats_frame.mesh_bytes    = mesh_bytes;
+	local.stats_frame.gpu_ms        = render_gpu_timer_frame_end();
+
+	local.stats_history[local.stats_history_count % render_stats_history_max] = local.stats_frame;
+	local.stats_history_count += 1;
+	local.stats_frame = {};
+
+	memcpy(local.stats_layers, local.stats_layers_frame, sizeof(local.stats_layers));
+	memset(local.stats_layers_frame, 0, sizeof(local.stats_layers_frame));
+}
+
+///////////////////////////////////////////
+
 void render_set_cam_root(const matrix &cam_root) {
 	local.camera_root       = cam_root;
 	local.camera_root_final = local.sim_head * cam_root * local.sim_origin;
@@ -781,7 +971,10 @@ void render_draw_queue(render_list_t list, const matrix *views, const matrix *pr
 		local.global_buffer.proj    [i] = XMMatrixTranspose(projection_f);
 		local.global_buffer.proj_inv[i] = XMMatrixTranspose(proj_inv);
 		local.global_buffer.viewproj[i] = XMMatrixTranspose(view_f * projection_f);
+
+		render_frustum_planes(view_f * projection_f, local.cull_planes[i]);
 	}
+	local.cull_view_count = view_count;
 
 	// Copy in the other global shader variables
 	memcpy(local.global_buffer.lighting, local.lighting, sizeof(vec4) * 9);
@@ -825,16 +1018,67 @@ void render_draw_queue(render_list_t list, const matrix *views, const matrix *pr
 	skg_event_end();
 	skg_event_begin("Execute Render List");
 
+	// Lists may be drawn several times a frame, so the frame's stats only
+	// get what this particular draw added.
+	render_stats_t before = list->stats;
+	render_gpu_timer_begin();
 	render_list_execute(list, filter, view_count, 0, INT_MAX);
+	render_gpu_timer_end();
+	render_stats_add(&local.stats_frame, list->stats, before);
 
 	skg_event_end();
 }
 
 ///////////////////////////////////////////
 
+render_capture_target_t *render_capture_target_get(int32_t width, int32_t height, tex_format_ format) {
+	render_capture_target_t *target = nullptr;
+	for (int32_t i = 0; i < local.capture_pool.count; i++) {
+		render_capture_target_t *t = &local.capture_pool[i];
+		if (t->width == width && t->height == height && t->format == format) {
+			target = t;
+			break;
+		}
+	}
+
+	// Readbacks copy out of the resolve texture as soon as they're
+	// requested, so one target per size and format is all we need.
+	if (target == nullptr) {
+		render_capture_target_t new_target = {};
+		new_target.surface = tex_create_rendertarget(width, height, 8, format, tex_format_depthstencil);
+		new_target.resolve = tex_create_rendertarget(width, height, 1, format, tex_format_none);
+		new_target.width   = width;
+		new_target.height  = height;
+		new_target.format  = format;
+		local.capture_pool.add(new_target);
+		target = &local.capture_pool.last();
+	}
+	target->last_used = time_frame();
+	return target;
+}
+
+///////////////////////////////////////////
+
+void render_capture_pool_trim() {
+	uint64_t frame = time_frame();
+	for (int32_t i = local.capture_pool.count - 1; i >= 0; i--) {
+		if (frame - local.capture_pool[i].last_used < render_capture_keep) continue;
+		tex_release(local.capture_pool[i].surface);
+		tex_release(local.capture_pool[i].resolve);
+		local.capture_pool.remove(i);
+	}
+}
+
+///////////////////////////////////////////
+
 // The screenshots are produced in FIFO order, meaning the
 // order of screenshot requests by users is preserved.
 void render_check_screenshots() {
+	// Results from previous frames' screenshots
+	render_readback_update();
+	render_save_check();
+	render_capture_pool_trim();
+
 	if (local.screenshot_list.count == 0) return;
 
 	skg_tex_t *old_target = skg_tex_target_get();
@@ -843,13 +1087,9 @@ void render_check_screenshots() {
 		int32_t  w = local.screenshot_list[i].width;
 		int32_t  h = local.screenshot_list[i].height;
 
-		// Create the screenshot surface
-		size_t   size   = sizeof(color32) * w * h;
-		color32 *buffer = (color32*)sk_malloc(size);
-		
 		// Setup to render the screenshot
-		tex_t render_capture_surface = tex_create_rendertarget(w, h, 8, local.screenshot_list[i].tex_format, tex_format_depthstencil);
-		skg_tex_target_bind(&render_capture_surface->tex, -1, 0);
+		render_capture_target_t *target = render_capture_target_get(w, h, local.screenshot_list[i].tex_format);
+		skg_tex_target_bind(&target->surface->tex, -1, 0);
 
 		// Set up the viewport if we've got one!
 		if (local.screenshot_list[i].viewport.w != 0) {
@@ -877,27 +1117,12 @@ void render_check_screenshots() {
 		render_draw_queue(local.list_primary, &local.screenshot_list[i].camera, &local.screenshot_list[i].projection, 0, 1, local.screenshot_list[i].layer_filter);
 		skg_tex_target_bind(nullptr, -1, 0);
 
-		tex_t resolve_tex = tex_create_rendertarget(w, h, 1, local.screenshot_list[i].tex_format, tex_format_none);
-		skg_tex_copy_to(&render_capture_surface->tex, -1, &resolve_tex->tex, -1);
-		tex_get_data(resolve_tex, buffer, size);
-#if defined(SKG_OPENGL)
-		int32_t line_size = skg_tex_fmt_pitch(resolve_tex->tex.format, resolve_tex->tex.width);
-		void* tmp = sk_malloc(line_size);
-		for (int32_t y = 0; y < resolve_tex->tex.height / 2; y++) {
-			void* top_line = ((uint8_t*)buffer) + line_size * y;
-			void* bot_line = ((uint8_t*)buffer) + line_size * ((resolve_tex->tex.height - 1) - y);
-			memcpy(tmp,      top_line, line_size);
-			memcpy(top_line, bot_line, line_size);
-			memcpy(bot_line, tmp,      line_size);
-		}
-		sk_free(tmp);
-#endif
-		tex_release(resolve_tex);
-		tex_release(render_capture_surface);
-
-		// Notify that the color data is ready!
-		local.screenshot_list[i].render_on_screenshot_callback(buffer, w, h, local.screenshot_list[i].context);
-		sk_free(buffer);
+		// Resolve, and queue up a read of the results. The color data will
+		// show up in render_screenshot_ready once the GPU gets to it.
+		skg_tex_copy_to(&target->surface->tex, -1, &target->resolve->tex, -1);
+		render_screenshot_t *shot = sk_malloc_t(render_screenshot_t, 1);
+		*shot = local.screenshot_list[i];
+		render_readback_request(target->resolve, render_screenshot_ready, shot);
 		skg_event_end();
 	}
 	local.screenshot_list.clear();
@@ -947,7 +1172,6 @@ void render_check_viewpoints() {
 ///////////////////////////////////////////
 
 void render_clear() {
-	//log_infof("draws: %d, instances: %d, material: %d, shader: %d, texture %d, mesh %d", render_stats.draw_calls, render_stats.draw_instances, render_stats.swaps_material, render_stats.swaps_shader, render_stats.swaps_texture, render_stats.swaps_mesh);
 	render_list_clear(local.list_primary);
 
 	local.last_material = nullptr;
@@ -1008,32 +1232,76 @@ void render_screenshot(const char* file_utf8, vec3 from_viewpt, vec3 at, int32_t
 
 ///////////////////////////////////////////
 
-struct screenshot_ctx_t {
-	char*   filename;
-	int32_t quality;
-};
-
-void render_save_to_file(color32* color_buffer, int width, int height, void* context) {
-	screenshot_ctx_t *ctx = (screenshot_ctx_t*)context;
+void render_save_job(void* data) {
+	profiler_zone("Screenshot Encode");
+	screenshot_ctx_t *ctx = (screenshot_ctx_t*)data;
 	if (string_endswith(ctx->filename, ".png", false)) {
-		stbi_write_png(ctx->filename, width, height, 4, color_buffer, 0);
+		ctx->success = stbi_write_png(ctx->filename, ctx->width, ctx->height, 4, ctx->buffer, 0) != 0;
 	} else {
-		stbi_write_jpg(ctx->filename, width, height, 4, color_buffer, ctx->quality);
+		ctx->success = stbi_write_jpg(ctx->filename, ctx->width, ctx->height, 4, ctx->buffer, ctx->quality) != 0;
+	}
+	sk_free(ctx->buffer);
+	ctx->buffer = nullptr;
+
+	// Make sure the results are visible before the main thread sees done
+	atomic_barrier();
+	ctx->done = 1;
+}
+
+///////////////////////////////////////////
+
+void render_screenshot_ready(void* data, int32_t width, int32_t height, void* context) {
+	render_screenshot_t *shot = (render_screenshot_t*)context;
+	if (shot->save != nullptr) {
+		// Encoding takes far longer than a frame, so it happens on a worker
+		// thread, render_save_check lets the app know when it's done.
+		shot->save->buffer = (color32*)data;
+		shot->save->width  = width;
+		shot->save->height = height;
+		local.save_list.add(shot->save);
+		jobs_add(render_save_job, shot->save, job_priority_low, &local.save_counter);
+	} else {
+		shot->render_on_screenshot_callback((color32*)data, width, height, shot->context);
+		sk_free(data);
+	}
+	sk_free(shot);
+}
+
+///////////////////////////////////////////
+
+void render_save_check() {
+	// Saves are reported in the order they were requested, so a slow one
+	// will hold up the ones behind it.
+	while (local.save_list.count > 0 && local.save_list[0]->done) {
+		screenshot_ctx_t *ctx = local.save_list[0];
+		local.save_list.remove(0);
+
+		if (!ctx->success) log_warnf("Failed to save screenshot to %s", ctx->filename);
+		if (ctx->on_saved) ctx->on_saved(ctx->filename, ctx->success, ctx->context);
+		sk_free(ctx->filename);
+		sk_free(ctx);
 	}
-	sk_free(ctx->filename);
-	sk_free(ctx);
 }
 
 ///////////////////////////////////////////
 
 void render_screenshot_pose(const char* file_utf8, int32_t file_quality_100, pose_t viewpoint, int32_t width, int32_t height, float fov_degrees) {
-	screenshot_ctx_t *ctx = sk_malloc_t(screenshot_ctx_t, 1);
+	matrix camera = pose_matrix(viewpoint);
+	matrix proj   = matrix_perspective(fov_degrees, (float)width / height, local.clip_planes.x, local.clip_planes.y);
+	render_screenshot_file(file_utf8, file_quality_100, camera, proj, width, height, render_layer_all, render_clear_all, rect_t{}, nullptr, nullptr);
+}
+
+///////////////////////////////////////////
+
+void render_screenshot_file(const char* file_utf8, int32_t file_quality_100, matrix camera, matrix projection, int32_t width, int32_t height, render_layer_ layer_filter, render_clear_ clear, rect_t viewport, void (*on_saved)(const char* file_utf8, bool32_t success, void* context), void* context) {
+	screenshot_ctx_t *ctx = sk_malloc_zero_t(screenshot_ctx_t, 1);
 	ctx->filename = string_copy(file_utf8);
 	ctx->quality  = file_quality_100;
+	ctx->on_saved = on_saved;
+	ctx->context  = context;
 
-	matrix view = matrix_invert(pose_matrix(viewpoint));
-	matrix proj = matrix_perspective(fov_degrees, (float)width / height, local.clip_planes.x, local.clip_planes.y);
-	local.screenshot_list.add(render_screenshot_t{ render_save_to_file, ctx, view, proj, rect_t{}, width, height, render_layer_all, render_clear_all, tex_format_rgba32 });
+	matrix inv_cam = matrix_invert(camera);
+	local.screenshot_list.add(render_screenshot_t{ nullptr, nullptr, inv_cam, projection, viewport, width, height, layer_filter, clear, tex_format_rgba32, ctx });
 }
 
 ///////////////////////////////////////////
@@ -1108,63 +1376,106 @@ void render_set_material(material_t material) {
 
 ///////////////////////////////////////////
 
-inst_pool_size_ inst_pool_from_size(int32_t size) {
-	if      (size <= inst_pool_sizes[inst_pool_size_1  ]) return inst_pool_size_1;
-	else if (size <= inst_pool_sizes[inst_pool_size_8  ]) return inst_pool_size_8;
-	else if (size <= inst_pool_sizes[inst_pool_size_32 ]) return inst_pool_size_32;
-	else if (size <= inst_pool_sizes[inst_pool_size_128]) return inst_pool_size_128;
-	else if (size <= inst_pool_sizes[inst_pool_size_512]) return inst_pool_size_512;
-	else if (size <= inst_pool_sizes[inst_pool_size_819]) return inst_pool_size_819;
-	else { log_err("Bad pool size"); return inst_pool_size_1; }
-}
-
-///////////////////////////////////////////
-
 void render_reset_buffer_pool() {
-	for (int32_t i = 0; i < inst_pool_size_max; i++) {
-		int32_t buffer_id = local.instance_pool_used[i] = 0;
-	}
+	// Each ring keeps going from wherever last frame stopped, so the buffers
+	// we fill next are the ones the GPU has had the longest to finish with.
+	local.instance_ring     .used = 0;
+	local.instance_base_ring.used = 0;
 }
 
 ///////////////////////////////////////////
 
-skg_buffer_t *render_fill_inst_buffer(const array_t<render_transform_buffer_t>* list, int32_t* ref_offset, int32_t* out_count) {
-	// Find a buffer that can contain this list! Or the biggest one
-	int32_t size  = list->count - *ref_offset;
-	int32_t start = *ref_offset;
+skg_buffer_t *render_ring_take(render_inst_ring_t *ring, int32_t capacity, skg_buffer_type_ type, uint32_t stride, const char *name) {
+	// If every buffer in the ring has already been used this frame, grow the
+	// ring at the current position. This settles at the frame's high-water
+	// mark.
+	if (ring->used >= ring->buffers.count) {
+		ring->buffers.insert(ring->next, render_inst_buffer_t{});
+	}
 
-	// Check if it fits, if it doesn't, then set up data so we only fill what we have! 
-	if (size > render_instance_max) {
-		*ref_offset += render_instance_max;
-		*out_count   = render_instance_max;
-	} else {
-		// this means we've gotten through the whole list :)
-		*ref_offset = 0;
-		*out_count  = size;
-	}
-
-	// Get the appropriate pool for this size
-	inst_pool_size_        pool_idx  = inst_pool_from_size(*out_count);
-	array_t<skg_buffer_t>* pool      = &local.instance_pool     [pool_idx];
-	int32_t*               pool_used = &local.instance_pool_used[pool_idx];
-	// If our pool for this size is empty, add a new buffer
-	if (*pool_used >= pool->count) {
-		skg_buffer_t new_buffer = skg_buffer_create(nullptr, inst_pool_sizes[pool_idx], sizeof(render_transform_buffer_t), skg_buffer_type_constant, skg_use_dynamic);
+	// Buffers that are too small for this upload get replaced with one that
+	// fits, with room to spare so this doesn't happen every frame.
+	render_inst_buffer_t *slot = &ring->buffers[ring->next];
+	if (slot->capacity < capacity) {
+		int32_t new_capacity = type == skg_buffer_type_constant ? 1 : render_instance_min;
+		if (new_capacity < slot->capacity) new_capacity = slot->capacity;
+		while (new_capacity < capacity) new_capacity *= 2;
+
+		if (skg_buffer_is_valid(&slot->buffer))
+			skg_buffer_destroy(&slot->buffer);
+		skg_use_ use = type == skg_buffer_type_constant
+			? skg_use_dynamic
+			: (skg_use_)(skg_use_dynamic | skg_use_compute_read);
+		slot->buffer   = skg_buffer_create(nullptr, new_capacity, stride, type, use);
+		slot->capacity = new_capacity;
 #if !defined(SKG_OPENGL) && (defined(_DEBUG) || defined(SK_GPU_LABELS))
-		char name[64];
-		snprintf(name, sizeof(name), "sk/render/instance_pool_%d_%d", inst_pool_sizes[pool_idx], *pool_used);
-		skg_buffer_name(&new_buffer, name);
+		char label[64];
+		snprintf(label, sizeof(label), "sk/render/%s_%d_%d", name, new_capacity, ring->next);
+		skg_buffer_name(&slot->buffer, label);
+#else
+		(void)name;
 #endif
-		pool->add(new_buffer);
 	}
 
-	// Fetch the buffer at the top of the pool
-	skg_buffer_t* buffer = &pool->get(*pool_used);
-	*pool_used += 1;
-
-	// Copy data into the buffer, and return it!
-	skg_buffer_set_contents(buffer, &list->data[start], sizeof(render_transform_buffer_t) * *out_count);
-	return buffer;
+	ring->next  = (ring->next + 1) % ring->buffers.count;
+	ring->used += 1;
+	return &slot->buffer;
+}
+
+///////////////////////////////////////////
+// Frustum culling                       //
+///////////////////////////////////////////
+
+void render_frustum_planes(const XMMATRIX &view_proj, XMVECTOR *out_planes) {
+	// Gribb/Hartmann plane extraction. DirectXMath uses row vectors, so the
+	// clip space equations live in the columns of the view-projection matrix.
+	// These planes aren't normalized, which is fine since we only care about
+	// the sign of the distance.
+	XMMATRIX cols = XMMatrixTranspose(view_proj);
+	out_planes[0] = XMVectorAdd     (cols.r[3], cols.r[0]); // Left
+	out_planes[1] = XMVectorSubtract(cols.r[3], cols.r[0]); // Right
+	out_planes[2] = XMVectorAdd     (cols.r[3], cols.r[1]); // Bottom
+	out_planes[3] = XMVectorSubtract(cols.r[3], cols.r[1]); // Top
+	out_planes[4] = XMVectorAdd     (cols.r[3], cols.r[2]); // Near, -w<=z is a conservative superset of 0<=z
+	out_planes[5] = XMVectorSubtract(cols.r[3], cols.r[2]); // Far
+}
+
+///////////////////////////////////////////
+
+bool render_frustum_visible(const render_item_t *item) {
+	if (local.cull_view_count <= 0) return true;
+
+	// Meshes with no bounds information, or with shaders that move verts
+	// around, can't be culled safely.
+	const mesh_t mesh = item->mesh;
+	if (mesh->unbounded ||
+		(mesh->bounds.dimensions.x == 0 && mesh->bounds.dimensions.y == 0 && mesh->bounds.dimensions.z == 0))
+		return true;
+
+	// Bring the bounds into world space as an oriented box: a center point,
+	// and three half-extent axes.
+	XMVECTOR half   = XMVectorScale(math_vec3_to_fast(mesh->bounds.dimensions), 0.5f);
+	XMVECTOR center = XMVector3Transform(math_vec3_to_fast(mesh->bounds.center), item->transform);
+	XMVECTOR axis_x = XMVectorMultiply  (item->transform.r[0], XMVectorSplatX(half));
+	XMVECTOR axis_y = XMVectorMultiply  (item->transform.r[1], XMVectorSplatY(half));
+	XMVECTOR axis_z = XMVectorMultiply  (item->transform.r[2], XMVectorSplatZ(half));
+
+	// For stereo, the item is visible if it's inside the union of all the
+	// view frusta, so any single view accepting it is enough.
+	for (int32_t v = 0; v < local.cull_view_count; v++) {
+		const XMVECTOR *planes = local.cull_planes[v];
+		bool            inside = true;
+		for (int32_t p = 0; p < 6; p++) {
+			float dist   = XMVectorGetX(XMVector3Dot(planes[p], center)) + XMVectorGetW(planes[p]);
+			float radius =
+				fabsf(XMVectorGetX(XMVector3Dot(planes[p], axis_x))) +
+				fabsf(XMVectorGetX(XMVector3Dot(planes[p], axis_y))) +
+				fabsf(XMVectorGetX(XMVector3Dot(planes[p], axis_z)));
+			if (dist + radius < 0) { inside = false; break; }
+		}
+		if (inside) return true;
+	}
+	return false;
 }
 
 ///////////////////////////////////////////
@@ -1254,7 +1565,22 @@ void render_list_release(render_list_t list) {
 void render_list_destroy(render_list_t list) {
 	if (list == nullptr) return;
 	render_list_clear(list);
-	list->queue.free();
+	for (int32_t i = 0; i < list->shards.count; i++) {
+		list->shards[i]->shard_parent = nullptr;
+		render_list_release(list->shards[i]);
+	}
+	list->shards    .free();
+	list->queue     .free();
+	list->sort_order.free();
+
+	for (int32_t i = 0; i < list->persist.count; i++) {
+		if (!list->persist[i].used) continue;
+		assets_releaseref(&list->persist[i].item.material->header);
+		assets_releaseref(&list->persist[i].item.mesh    ->header);
+	}
+	list->persist      .free();
+	list->persist_free .free();
+	list->persist_order.free();
 	*list = {};
 }
 
@@ -1295,30 +1621,80 @@ void render_list_add_to(render_list_t list, const render_item_t *item) {
 
 ///////////////////////////////////////////
 
-inline void render_list_execute_run(_render_list_t *list, material_t material, const skg_mesh_t *mesh, int32_t mesh_inds, uint32_t view_count) {
+inline void render_stats_layer_culled(uint16_t layers) {
+	for (int32_t i = 0; layers != 0; i++, layers >>= 1) {
+		if (layers & 1) local.stats_layers_frame[i].items_culled++;
+	}
+}
+inline void render_stats_layer_drawn(uint16_t layers) {
+	for (int32_t i = 0; layers != 0; i++, layers >>= 1) {
+		if (layers & 1) local.stats_layers_frame[i].draw_instances++;
+	}
+}
+
+///////////////////////////////////////////
+
+inline void render_list_end_run(material_t material, mesh_t mesh, int32_t mesh_inds, int32_t start) {
+	local.instance_runs.add(render_inst_run_t{ material, mesh, mesh_inds, start, local.instance_list.count - start });
+}
+
+///////////////////////////////////////////
+
+inline void render_list_execute_run(_render_list_t *list, const render_inst_run_t *run, uint32_t view_count) {
+	material_t material = run->material;
+	mesh_t     mesh     = run->mesh;
 	render_set_material(material);
-	skg_mesh_bind      (mesh);
 	list->stats.swaps_mesh++;
 
-	// Collect and draw instances
-	int32_t offsets = 0, inst_count = 0;
-	do {
-		skg_buffer_t *instances = render_fill_inst_buffer(&local.instance_list, &offsets, &inst_count);
-		skg_buffer_bind(instances, render_list_inst_bind);
+	// GPU skinned meshes draw the source mesh's current buffers, and pull
+	// their weights and bone palette by vertex id
+	if (mesh->skin_source != nullptr) {
+		skg_mesh_bind  (&mesh->skin_source->gpu_mesh);
+		skg_buffer_bind(&mesh->skin_source->skin_weight_buffer, render_skin_weight_bind);
+		skg_buffer_bind(&mesh->skin_bone_buffer,                render_skin_bone_bind);
+	} else {
+		skg_mesh_bind  (&mesh->gpu_mesh);
+	}
+
+	// The run's instances are already on the GPU, it just needs to know
+	// where they start.
+	render_inst_base_t base   = { (uint32_t)run->start };
+	skg_buffer_t      *buffer = render_ring_take(&local.instance_base_ring, 1, skg_buffer_type_constant, sizeof(render_inst_base_t), "instance_base");
+	skg_buffer_set_contents(buffer, &base, sizeof(base));
+	skg_buffer_bind        (buffer, render_list_inst_base_bind);
 
-		skg_draw(0, 0, mesh_inds, inst_count * view_count);
-		list->stats.draw_calls     += 1;
-		list->stats.draw_instances += inst_count;
+	skg_draw(0, 0, run->mesh_inds, run->count * view_count);
+	list->stats.draw_calls     += 1;
+	list->stats.draw_instances += run->count;
+}
+
+///////////////////////////////////////////
+
+void render_list_execute_runs(_render_list_t *list, uint32_t view_count) {
+	if (local.instance_runs.count > 0) {
+		// One upload for every instance this execute draws
+		int32_t       count     = local.instance_list.count;
+		skg_buffer_t *instances = render_ring_take(&local.instance_ring, count, skg_buffer_type_compute, sizeof(render_transform_buffer_t), "instances");
+		skg_buffer_set_contents(instances, local.instance_list.data, sizeof(render_transform_buffer_t) * count);
+		skg_buffer_bind        (instances, render_list_inst_bind);
+		list->stats.instance_bytes += (int64_t)count * sizeof(render_transform_buffer_t);
 
-	} while (offsets != 0);
+		for (int32_t i = 0; i < local.instance_runs.count; i++) {
+			render_list_execute_run(list, &local.instance_runs[i], view_count);
+		}
+	}
+	local.instance_list.clear();
+	local.instance_runs.clear();
 }
 
 ///////////////////////////////////////////
 
 void render_list_execute(render_list_t list, render_layer_ filter, uint32_t view_count, int32_t queue_start, int32_t queue_end) {
+	profiler_zone("Render Execute");
 	list->state = render_list_state_rendering;
+	render_list_merge_shards(list);
 
-	if (list->queue.count == 0) {
+	if (render_list_is_empty(list)) {
 		list->state = render_list_state_rendered;
 		return;
 	}
@@ -1326,14 +1702,23 @@ void render_list_execute(render_list_t list, render_layer_ filter, uint32_t view
 	uint64_t sort_id_start = render_sort_id_from_queue(queue_start);
 	uint64_t sort_id_end   = render_sort_id_from_queue(queue_end);
 
-	render_item_t *run_start = nullptr;
-	for (int32_t i = 0; i < list->queue.count; i++) {
-		render_item_t *item = &list->queue[i];
+	render_item_t *run_start   = nullptr;
+	int32_t        run_first   = 0;
+	render_item_t *item        = nullptr;
+	int32_t        queue_idx   = 0;
+	int32_t        persist_idx = 0;
+	while ((item = render_list_next(list, &queue_idx, &persist_idx)) != nullptr) {
 		
 		// Skip this item if it's filtered out
 		if ((item->layer & filter) == 0 || item->sort_id < sort_id_start) continue;
 		// End early if we're past the end of the desired queue range
 		if (item->sort_id >= sort_id_end) break;
+		// Skip this item if no view can see it
+		if (!render_frustum_visible(item)) {
+			list->stats.items_culled++;
+			render_stats_layer_culled(item->layer);
+			continue;
+		}
 
 		// If it's the first in the run, record the material/mesh
 		if (run_start == nullptr) {
@@ -1341,23 +1726,24 @@ void render_list_execute(render_list_t list, render_layer_ filter, uint32_t view
 		}
 		// If the material/mesh changed
 		else if (run_start->material != item->material || run_start->mesh != item->mesh) {
-			// Render the run that just ended
-			render_list_execute_run(list, run_start->material, &run_start->mesh->gpu_mesh, run_start->mesh_inds, view_count);
-			local.instance_list.clear();
+			// Queue up the run that just ended
+			render_list_end_run(run_start->material, run_start->mesh, render_item_inds(run_start), run_first);
 			// Start the next run
 			run_start = item;
+			run_first = local.instance_list.count;
 		}
 
 		// Add the current item to the run of instances
 		XMMATRIX transpose = XMMatrixTranspose(item->transform);
 		local.instance_list.add(render_transform_buffer_t{ transpose, item->color });
+		render_stats_layer_drawn(item->layer);
 	}
-	// Render the last remaining run, which won't be triggered by the loop's
-	// conditions
-	if (local.instance_list.count > 0) {
-		render_list_execute_run(list, run_start->material, &run_start->mesh->gpu_mesh, run_start->mesh_inds, view_count);
-		local.instance_list.clear();
+	// Queue the last remaining run, which won't be triggered by the loop's
+	// conditions, then draw them all
+	if (local.instance_list.count > run_first) {
+		render_list_end_run(run_start->material, run_start->mesh, render_item_inds(run_start), run_first);
 	}
+	render_list_execute_runs(list, view_count);
 
 	list->state = render_list_state_rendered;
 
@@ -1369,9 +1755,11 @@ void render_list_execute(render_list_t list, render_layer_ filter, uint32_t view
 ///////////////////////////////////////////
 
 void render_list_execute_material(render_list_t list, render_layer_ filter, uint32_t view_count, int32_t queue_start, int32_t queue_end, material_t override_material) {
+	profiler_zone("Render Execute");
 	list->state = render_list_state_rendering;
+	render_list_merge_shards(list);
 
-	if (list->queue.count == 0) {
+	if (render_list_is_empty(list)) {
 		list->state = render_list_state_rendered;
 		return;
 	}
@@ -1382,14 +1770,23 @@ void render_list_execute_material(render_list_t list, render_layer_ filter, uint
 	uint64_t sort_id_start = render_sort_id_from_queue(queue_start);
 	uint64_t sort_id_end   = render_sort_id_from_queue(queue_end);
 
-	render_item_t *run_start = nullptr;
-	for (int32_t i = 0; i < list->queue.count; i++) {
-		render_item_t *item = &list->queue[i];
+	render_item_t *run_start   = nullptr;
+	int32_t        run_first   = 0;
+	render_item_t *item        = nullptr;
+	int32_t        queue_idx   = 0;
+	int32_t        persist_idx = 0;
+	while ((item = render_list_next(list, &queue_idx, &persist_idx)) != nullptr) {
 
 		// Skip this item if it's filtered out
 		if ((item->layer & filter) == 0 || item->sort_id < sort_id_start) continue;
 		// End early if we're past the end of the desired queue range
 		if (item->sort_id >= sort_id_end) break;
+		// Skip this item if no view can see it
+		if (!render_frustum_visible(item)) {
+			list->stats.items_culled++;
+			render_stats_layer_culled(item->layer);
+			continue;
+		}
 
 		// If it's the first in the run, record the material/mesh
 		if (run_start == nullptr) {
@@ -1397,23 +1794,24 @@ void render_list_execute_material(render_list_t list, render_layer_ filter, uint
 		}
 		// If the mesh changed
 		else if (run_start->mesh != item->mesh) {
-			// Render the run that just ended
-			render_list_execute_run(list, override_material, &run_start->mesh->gpu_mesh, run_start->mesh_inds, view_count);
-			local.instance_list.clear();
+			// Queue up the run that just ended
+			render_list_end_run(override_material, run_start->mesh, render_item_inds(run_start), run_first);
 			// Start the next run
 			run_start = item;
+			run_first = local.instance_list.count;
 		}
 
 		// Add the current item to the run of instances
 		XMMATRIX transpose = XMMatrixTranspose(item->transform);
 		local.instance_list.add(render_transform_buffer_t{ transpose, item->color });
+		render_stats_layer_drawn(item->layer);
 	}
-	// Render the last remaining run, which won't be triggered by the loop's
-	// conditions
-	if (local.instance_list.count > 0) {
-		render_list_execute_run(list, override_material, &run_start->mesh->gpu_mesh, run_start->mesh_inds, view_count);
-		local.instance_list.clear();
+	// Queue the last remaining run, which won't be triggered by the loop's
+	// conditions, then draw them all
+	if (local.instance_list.count > run_first) {
+		render_list_end_run(override_material, run_start->mesh, render_item_inds(run_start), run_first);
 	}
+	render_list_execute_runs(list, view_count);
 
 	list->state = render_list_state_rendered;
 }
@@ -1422,9 +1820,34 @@ void render_list_execute_material(render_list_t list, render_layer_ filter, uint
 
 void render_list_prep(render_list_t list) {
 	if (list->prepped) return;
+	profiler_zone("Render Prep");
 
 	// Sort the render queue
-	radix_sort7(&list->queue[0], list->queue.count);
+	render_list_sort(list);
+
+	// Persistent items keep the sort key and chain their material had when
+	// they were added, so rebuild any chains whose materials have changed.
+	if (list->persist_material_changes != material_sort_changes) {
+		list->persist_material_changes = material_sort_changes;
+		for (int32_t i = 0; i < list->persist.count; i++) {
+			if (list->persist[i].head && render_list_persist_stale(list, i)) {
+				render_list_persist_refresh(list, i);
+				list->persist_dirty = true;
+			}
+		}
+	}
+
+	// Persistent items only need sorting when the set of items changes
+	if (list->persist_dirty) {
+		list->persist_order.clear();
+		for (int32_t i = 0; i < list->persist.count; i++) {
+			if (list->persist[i].used)
+				list->persist_order.add(render_persist_order_t{ list->persist[i].item.sort_id, i });
+		}
+		list->persist_order.sort([](const render_persist_order_t &a, const render_persist_order_t &b) {
+			return (int32_t)((a.sort_id > b.sort_id) - (a.sort_id < b.sort_id)); });
+		list->persist_dirty = false;
+	}
 
 	// Make sure the material buffers are all up-to-date
 	material_t curr = nullptr;
@@ -1433,12 +1856,160 @@ void render_list_prep(render_list_t list) {
 		curr = list->queue[i].material;
 		material_check_dirty(curr);
 	}
+	for (int32_t i = 0; i < list->persist_order.count; i++) {
+		material_t mat = list->persist[list->persist_order[i].index].item.material;
+		if (curr == mat) continue;
+		curr = mat;
+		material_check_dirty(curr);
+	}
 
+	list->stats.items_queued = list->queue.count + list->persist_order.count;
 	list->prepped = true;
 }
 
 ///////////////////////////////////////////
 
+void render_list_sort(render_list_t list) {
+	int32_t        count = list->queue.count;
+	render_item_t *items = list->queue.data;
+	if (count <= 1) return;
+	profiler_zone("Render Sort");
+
+	if (list->sort_order.capacity < count)
+		list->sort_order.resize(count);
+	uint32_t *order = list->sort_order.data;
+
+	// If the list got the same number of items as last time, last time's
+	// order is very likely to still be sorted. Any order that checks out as
+	// sorted is a valid result, so this just needs one verification pass.
+	bool sorted = false;
+	if (list->sort_order.count == count && list->prev_count == count) {
+		sorted = true;
+		for (int32_t i = 1; i < count; i++) {
+			if (items[order[i-1]].sort_id > items[order[i]].sort_id) { sorted = false; break; }
+		}
+		if (sorted) list->stats.sort_reused++;
+	}
+
+	if (!sorted) {
+		// Build sort keys, and see how far from sorted the queue is
+		render_sort_key_t *keys     = radix_keys(count);
+		int32_t            descents = 0;
+		keys[0] = render_sort_key_t{ items[0].sort_id, 0 };
+		for (int32_t i = 1; i < count; i++) {
+			keys[i] = render_sort_key_t{ items[i].sort_id, (uint32_t)i };
+			if (keys[i-1].sort_id > keys[i].sort_id) descents++;
+		}
+
+		// Already in order, nothing to move around
+		if (descents == 0) {
+			for (int32_t i = 0; i < count; i++) order[i] = (uint32_t)i;
+			list->sort_order.count = count;
+			return;
+		}
+
+		// A handful of out of place items is cheaper to fix with an insertion
+		// sort than with a full set of radix passes. If it turns out to be
+		// worse than it looked, we bail out to radix, which is happy to take
+		// the partially sorted keys.
+		bool done = false;
+		if (descents <= count / 32) {
+			int64_t budget = (int64_t)count * 2;
+			int32_t i      = 1;
+			for (; i < count && budget > 0; i++) {
+				render_sort_key_t curr = keys[i];
+				int32_t           j    = i - 1;
+				while (j >= 0 && keys[j].sort_id > curr.sort_id) {
+					keys[j+1] = keys[j];
+					j--;
+				}
+				keys[j+1] = curr;
+				budget -= (i - 1) - j;
+			}
+			done = i == count;
+		}
+		if (!done) {
+			radix_sort7(keys, count);
+			list->stats.sort_radix++;
+		}
+		list->stats.items_sorted += count;
+
+		for (int32_t i = 0; i < count; i++) order[i] = keys[i].index;
+	}
+	list->sort_order.count = count;
+
+	// Move the items into their sorted positions
+	render_item_t *sorted_items = radix_items(count);
+	for (int32_t i = 0; i < count; i++)
+		sorted_items[i] = items[order[i]];
+	memcpy(items, sorted_items, sizeof(render_item_t) * count);
+}
+
+///////////////////////////////////////////
+
+bool render_list_is_empty(render_list_t list) {
+	return list->queue.count == 0 && list->persist.count == list->persist_free.count;
+}
+
+///////////////////////////////////////////
+
+render_item_t *render_list_next(render_list_t list, int32_t *ref_queue_idx, int32_t *ref_persist_idx) {
+	// The frame's queue and the persistent items are both sorted, so we can
+	// walk them together like the merge step of a merge sort.
+	bool has_queue   = *ref_queue_idx   < list->queue.count;
+	bool has_persist = *ref_persist_idx < list->persist_order.count;
+	if (has_queue && (!has_persist || list->queue[*ref_queue_idx].sort_id <= list->persist_order[*ref_persist_idx].sort_id)) {
+		*ref_queue_idx += 1;
+		return &list->queue[*ref_queue_idx - 1];
+	} else if (has_persist) {
+		*ref_persist_idx += 1;
+		return &list->persist[list->persist_order[*ref_persist_idx - 1].index].item;
+	}
+	return nullptr;
+}
+
+///////////////////////////////////////////
+
+void render_list_merge_shards(render_list_t list) {
+	// This is a plain move of items from shard to list, so the references
+	// the shard took when the item was added now belong to the list. This
+	// must only happen once the threads filling the shards are done.
+	for (int32_t i = 0; i < list->shards.count; i++) {
+		render_list_t shard = list->shards[i];
+		if (shard->queue.count == 0) continue;
+
+		list->queue.add_range(shard->queue.data, shard->queue.count);
+		shard->prev_count = shard->queue.count;
+		shard->queue.clear();
+		list->prepped = false;
+	}
+}
+
+///////////////////////////////////////////
+
+void render_list_add_shard(render_list_t list, render_list_t shard) {
+	if (shard == list || shard->shard_parent != nullptr) {
+		log_err("render_list_add_shard: a shard can only belong to one other list.");
+		return;
+	}
+	render_list_addref(shard);
+	shard->shard_parent = list;
+	list->shards.add(shard);
+}
+
+///////////////////////////////////////////
+
+void render_list_remove_shard(render_list_t list, render_list_t shard) {
+	int32_t idx = list->shards.index_of(shard);
+	if (idx < 0) return;
+
+	list->shards.remove(idx);
+	shard->shard_parent = nullptr;
+	render_list_release(shard);
+}
+
+///////////////////////////////////////////
+
 void render_list_clear(render_list_t list) {
 	list->prev_count = list->queue.count;
 	for (int32_t i = 0; i < list->queue.count; i++) {
@@ -1446,8 +2017,14 @@ void render_list_clear(render_list_t list) {
 		assets_releaseref(&list->queue[i].mesh    ->header);
 	}
 	list->queue.clear();
-	list->stats   = {};
-	list->prepped = false;
+	// Anything that didn't get merged this frame is dropped along with the
+	// rest of the queue.
+	for (int32_t i = 0; i < list->shards.count; i++) {
+		render_list_clear(list->shards[i]);
+	}
+	list->stats_prev = list->stats;
+	list->stats      = {};
+	list->prepped    = false;
 	list->state   = render_list_state_empty;
 }
 
@@ -1465,14 +2042,24 @@ int32_t render_list_prev_count(render_list_t list) {
 
 ///////////////////////////////////////////
 
+render_stats_t render_list_get_stats(render_list_t list) {
+	render_stats_t result = list->stats_prev;
+	result.gpu_ms = -1;
+	return result;
+}
+
+///////////////////////////////////////////
+
 void render_list_add_mesh(render_list_t list, mesh_t mesh, material_t material, matrix transform, color128 color_linear, render_layer_ layer) {
 	render_item_t item;
 	item.mesh      = mesh;
 	item.mesh_inds = mesh->ind_draw;
 	item.color     = color_linear;
 	item.layer     = (uint16_t)layer;
-	if (hierarchy_use_top()) matrix_mul         (transform, hierarchy_top(), item.transform);
-	else                     math_matrix_to_fast(transform, &item.transform);
+	// Shards are filled from other threads, the hierarchy stack belongs to
+	// the main thread.
+	if (list->shard_parent == nullptr && hierarchy_use_top()) matrix_mul         (transform, hierarchy_top(), item.transform);
+	else                                                      math_matrix_to_fast(transform, &item.transform);
 
 	material_t curr = material;
 	while (curr != nullptr) {
@@ -1485,6 +2072,169 @@ void render_list_add_mesh(render_list_t list, mesh_t mesh, material_t material,
 
 ///////////////////////////////////////////
 
+// Persistent ids are the slot in the low bits, and the slot's generation in
+// the high bits, leaving the sign bit clear so -1 stays invalid.
+#define RENDER_PERSIST_SLOT_BITS 20
+#define RENDER_PERSIST_SLOT_MASK ((1 << RENDER_PERSIST_SLOT_BITS) - 1)
+#define RENDER_PERSIST_GEN_MASK  ((1 << (31 - RENDER_PERSIST_SLOT_BITS)) - 1)
+
+inline render_item_id_t render_persist_make_id   (int32_t slot, uint16_t generation) { return ((generation & RENDER_PERSIST_GEN_MASK) << RENDER_PERSIST_SLOT_BITS) | slot; }
+inline int32_t          render_persist_id_slot   (render_item_id_t id)               { return id & RENDER_PERSIST_SLOT_MASK; }
+inline uint16_t         render_persist_id_gen    (render_item_id_t id)               { return (uint16_t)((id >> RENDER_PERSIST_SLOT_BITS) & RENDER_PERSIST_GEN_MASK); }
+
+///////////////////////////////////////////
+
+// Each material in the chain gets its own slot, linked after prev. Returns
+// the first slot used, or -1 if there was no room.
+static int32_t render_list_persist_add_chain(render_list_t list, render_item_t item, material_t material, int32_t prev) {
+	int32_t first = -1;
+	for (material_t curr = material; curr != nullptr; curr = curr->chain) {
+		int32_t slot;
+		if (list->persist_free.count > 0) {
+			slot = list->persist_free[list->persist_free.count - 1];
+			list->persist_free.pop();
+		} else {
+			if (list->persist.count > RENDER_PERSIST_SLOT_MASK) {
+				log_err("render_list_persist_mesh: Too many persistent items in this render list!");
+				break;
+			}
+			slot = list->persist.add({});
+		}
+
+		item.material = curr;
+		item.sort_id  = render_sort_id(curr, item.mesh);
+		assets_addref(&item.material->header);
+		assets_addref(&item.mesh    ->header);
+		render_persist_t *persist = &list->persist[slot];
+		persist->item                = item;
+		persist->material_generation = curr->sort_generation;
+		persist->next                = -1;
+		persist->used                = true;
+		persist->head                = prev == -1;
+
+		if (prev != -1)  list->persist[prev].next = slot;
+		if (first == -1) first = slot;
+		prev = slot;
+	}
+	return first;
+}
+
+///////////////////////////////////////////
+
+// Frees a slot and every slot chained after it.
+static void render_list_persist_free_chain(render_list_t list, int32_t i) {
+	while (i != -1) {
+		render_persist_t *slot = &list->persist[i];
+		assets_releaseref(&slot->item.material->header);
+		assets_releaseref(&slot->item.mesh    ->header);
+		slot->used        = false;
+		slot->head        = false;
+		slot->generation += 1;
+		list->persist_free.add(i);
+		i = slot->next;
+	}
+}
+
+///////////////////////////////////////////
+
+// True if a material in this chain has changed its sort key, or the head
+// material's chain no longer matches the slots.
+bool render_list_persist_stale(render_list_t list, int32_t head) {
+	material_t curr = list->persist[head].item.material;
+	int32_t    i    = head;
+	while (i != -1 && curr != nullptr) {
+		const render_persist_t *slot = &list->persist[i];
+		if (slot->item.material != curr || slot->material_generation != curr->sort_generation)
+			return true;
+		curr = curr->chain;
+		i    = slot->next;
+	}
+	return i != -1 || curr != nullptr;
+}
+
+///////////////////////////////////////////
+
+// Re-derives the head's sort key, and rebuilds the rest of its chain from
+// the material's current chain. The head slot stays put, so ids are still
+// valid afterwards.
+void render_list_persist_refresh(render_list_t list, int32_t head) {
+	render_persist_t *slot = &list->persist[head];
+	render_list_persist_free_chain(list, slot->next);
+	slot->next                = -1;
+	slot->item.sort_id        = render_sort_id(slot->item.material, slot->item.mesh);
+	slot->material_generation = slot->item.material->sort_generation;
+
+	render_item_t item = slot->item;
+	render_list_persist_add_chain(list, item, item.material->chain, head);
+}
+
+///////////////////////////////////////////
+
+render_item_id_t render_list_persist_mesh(render_list_t list, mesh_t mesh, material_t material, matrix transform, color128 color_linear, render_layer_ layer) {
+	render_item_t item;
+	item.mesh      = mesh;
+	item.mesh_inds = -1; // The mesh's draw count may change while this is in the list
+	item.color     = color_linear;
+	item.layer     = (uint16_t)layer;
+	if (list->shard_parent == nullptr && hierarchy_use_top()) matrix_mul         (transform, hierarchy_top(), item.transform);
+	else                                                      math_matrix_to_fast(transform, &item.transform);
+
+	// The first slot in the chain is the id we give back
+	int32_t head = render_list_persist_add_chain(list, item, material, -1);
+
+	list->persist_dirty = true;
+	list->prepped       = false;
+	return head == -1 ? -1 : render_persist_make_id(head, list->persist[head].generation);
+}
+
+///////////////////////////////////////////
+
+static bool render_list_persist_valid(render_list_t list, render_item_id_t item, const char *fn_name) {
+	int32_t slot = render_persist_id_slot(item);
+	if (item < 0 || slot >= list->persist.count
+		|| !list->persist[slot].used
+		|| !list->persist[slot].head
+		|| (list->persist[slot].generation & RENDER_PERSIST_GEN_MASK) != render_persist_id_gen(item)) {
+		log_errf("%s: %d is not a valid persistent item id.", fn_name, item);
+		return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////
+
+void render_list_persist_set_transform(render_list_t list, render_item_id_t item, matrix transform) {
+	if (!render_list_persist_valid(list, item, "render_list_persist_set_transform")) return;
+
+	XMMATRIX fast;
+	if (list->shard_parent == nullptr && hierarchy_use_top()) matrix_mul         (transform, hierarchy_top(), fast);
+	else                                                      math_matrix_to_fast(transform, &fast);
+
+	for (int32_t i = render_persist_id_slot(item); i != -1; i = list->persist[i].next)
+		list->persist[i].item.transform = fast;
+}
+
+///////////////////////////////////////////
+
+void render_list_persist_set_color(render_list_t list, render_item_id_t item, color128 color_linear) {
+	if (!render_list_persist_valid(list, item, "render_list_persist_set_color")) return;
+
+	for (int32_t i = render_persist_id_slot(item); i != -1; i = list->persist[i].next)
+		list->persist[i].item.color = color_linear;
+}
+
+///////////////////////////////////////////
+
+void render_list_persist_remove(render_list_t list, render_item_id_t item) {
+	if (!render_list_persist_valid(list, item, "render_list_persist_remove")) return;
+
+	render_list_persist_free_chain(list, render_persist_id_slot(item));
+	list->persist_dirty = true;
+	list->prepped       = false;
+}
+
+///////////////////////////////////////////
+
 void render_list_add_model(render_list_t list, model_t model, matrix transform, color128 color_linear, render_layer_ layer) {
 	render_list_add_model_mat(list, model, nullptr, transform, color_linear, layer);
 }
@@ -1493,10 +2243,14 @@ void render_list_add_model(render_list_t list, model_t model, matrix transform,
 
 void render_list_add_model_mat(render_list_t list, model_t model, material_t material_override, matrix transform, color128 color_linear, render_layer_ layer) {
 	XMMATRIX root;
-	if (hierarchy_use_top()) matrix_mul         (transform, hierarchy_top(), root);
-	else                     math_matrix_to_fast(transform, &root);
-
-	anim_update_model(model);
+	if (list->shard_parent == nullptr && hierarchy_use_top()) matrix_mul         (transform, hierarchy_top(), root);
+	else                                                      math_matrix_to_fast(transform, &root);
+
+	// Shards are filled from worker threads, and animation writes to the
+	// shared model, so only the main list steps it. Models added to shards
+	// draw with whatever pose model_step_anim last gave them.
+	bool is_shard = list->shard_parent != nullptr;
+	if (!is_shard) anim_update_model(model);
 	for (int32_t i = 0; i < model->visuals.count; i++) {
 		const model_visual_t *vis = &model->visuals[i];
 		if (vis->visible == false || vis->mesh == nullptr || vis->material == nullptr) continue;
@@ -1517,7 +2271,7 @@ void render_list_add_model_mat(render_list_t list, model_t model, material_t mat
 		}
 	}
 
-	if (model->transforms_changed && model->anim_data.skeletons.count > 0) {
+	if (!is_shard && model->transforms_changed && model->anim_data.skeletons.count > 0) {
 		model->transforms_changed = false;
 		anim_update_skin(model);
 	}
@@ -1568,24 +2322,53 @@ const uint64_t RADIX_MASK   = RADIX_SIZE - 1;
 using freq_array_type = size_t [RADIX_LEVELS][RADIX_SIZE];
 
 // Since this sort is specifically for the render queue, we'll reserve a
-// chunk of memory that sticks around, and resizes if it's too small.
-render_item_t *radix_queue_area = nullptr;
-size_t         radix_queue_size = 0;
+// chunk of memory that sticks around, and resizes if it's too small. Sorting
+// happens on small keys rather than the full render items, and the items are
+// then moved once into their final order.
+render_sort_key_t *radix_key_area  = nullptr;
+render_sort_key_t *radix_key_swap  = nullptr;
+size_t             radix_key_size  = 0;
+render_item_t     *radix_item_area = nullptr;
+size_t             radix_item_size = 0;
 
 void radix_sort_init() {
-	radix_queue_area = nullptr;
-	radix_queue_size = 0;
+	radix_key_area  = nullptr;
+	radix_key_swap  = nullptr;
+	radix_key_size  = 0;
+	radix_item_area = nullptr;
+	radix_item_size = 0;
 }
 
 void radix_sort_clean() {
-	sk_free(radix_queue_area);
-	radix_queue_area = nullptr;
-	radix_queue_size = 0;
+	sk_free(radix_key_area);
+	sk_free(radix_key_swap);
+	sk_free(radix_item_area);
+	radix_sort_init();
+}
+
+render_sort_key_t *radix_keys(size_t count) {
+	if (radix_key_size < count) {
+		sk_free(radix_key_area);
+		sk_free(radix_key_swap);
+		radix_key_area = sk_malloc_t(render_sort_key_t, count);
+		radix_key_swap = sk_malloc_t(render_sort_key_t, count);
+		radix_key_size = count;
+	}
+	return radix_key_area;
+}
+
+render_item_t *radix_items(size_t count) {
+	if (radix_item_size < count) {
+		sk_free(radix_item_area);
+		radix_item_area = sk_malloc_t(render_item_t, count);
+		radix_item_size = count;
+	}
+	return radix_item_area;
 }
 
 // never inline just to make it show up easily in profiles (inlining this lengthly function doesn't
 // really help anyways)
-static void count_frequency(render_item_t *a, size_t count, freq_array_type freqs) {
+static void count_frequency(render_sort_key_t *a, size_t count, freq_array_type freqs) {
 	for (size_t i = 0; i < count; i++) {
 		uint64_t value = a[i].sort_id;
 		for (size_t pass = 0; pass < RADIX_LEVELS; pass++) {
@@ -1613,17 +2396,12 @@ static bool is_trivial(size_t freqs[RADIX_SIZE], size_t count) {
 	return true;
 }
 
-void radix_sort7(render_item_t *a, size_t count) {
-	// Resize up if needed
-	if (radix_queue_size < count) {
-		sk_free(radix_queue_area);
-		radix_queue_area = sk_malloc_t(render_item_t, count);
-		radix_queue_size = count;
-	}
+void radix_sort7(render_sort_key_t *a, size_t count) {
+	// Keys come from radix_keys, so the swap area is already big enough.
 	freq_array_type freqs = {};
 	count_frequency(a, count, freqs);
 
-	render_item_t *from = a, *to = radix_queue_area;
+	render_sort_key_t *from = a, *to = a == radix_key_area ? radix_key_swap : radix_key_area;
 
 	for (size_t pass = 0; pass < RADIX_LEVELS; pass++) {
 
@@ -1636,7 +2414,7 @@ void radix_sort7(render_item_t *a, size_t count) {
 
 		// array of pointers to the current position in each queue, which we set up based on the
 		// known final sizes of each queue (i.e., "tighly packed")
-		render_item_t *queue_ptrs[RADIX_SIZE], *next = to;
+		render_sort_key_t *queue_ptrs[RADIX_SIZE], *next = to;
 		for (size_t i = 0; i < RADIX_SIZE; i++) {
 			queue_ptrs[i] = next;
 			next += freqs[pass][i];
@@ -1645,7 +2423,7 @@ void radix_sort7(render_item_t *a, size_t count) {
 		// copy each element into the appropriate queue based on the current RADIX_BITS sized
 		// "digit" within it
 		for (size_t i = 0; i < count; i++) {
-			render_item_t value = from[i];
+			render_sort_key_t value = from[i];
 			size_t        index = (value.sort_id >> shift) & RADIX_MASK;
 			*queue_ptrs[index]++ = value;
 #ifdef _MSC_VER
@@ -1660,7 +2438,7 @@ void radix_sort7(render_item_t *a, size_t count) {
 		}
 
 		// swap from and to areas
-		render_item_t *tmp = to;
+		render_sort_key_t *tmp = to;
 		to   = from;
 		from = tmp;
 	}
@@ -1668,7 +2446,7 @@ void radix_sort7(render_item_t *a, size_t count) {
 	// because of the last swap, the "from" area has the sorted payload: if it's
 	// not the original array "a", do a final copy
 	if (from != a) {
-		memcpy(a, from, count*sizeof(render_item_t));
+		memcpy(a, from, count*sizeof(render_sort_key_t));
 	}
 }
 
@@ -10,14 +10,6 @@
 
 namespace sk {
 
-struct render_stats_t {
-	int swaps_mesh;
-	int swaps_texture;
-	int swaps_material;
-	int draw_calls;
-	int draw_instances;
-};
-
 bool          render_init                 ();
 void          render_step                 ();
 void          render_shutdown             ();
@@ -40,6 +32,9 @@ void          render_draw_queue           (render_list_t list, const matrix* vie
 void          render_check_screenshots    ();
 void          render_check_viewpoints     ();
 void          render_check_pending_skytex ();
+// Thread safe, for counting GPU uploads in the frame's render_stats_t.
+void          render_stats_add_tex_upload (int64_t bytes);
+void          render_stats_add_mesh_upload(int64_t bytes);
 
 void          render_list_destroy         (      render_list_t list);
 void          render_list_execute         (      render_list_t list, render_layer_ filter, uint32_t view_count, int32_t queue_start, int32_t queue_end);
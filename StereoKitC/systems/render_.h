@@ -22,10 +22,29 @@ struct render_item_t {
 	uint64_t    sort_id;
 	mesh_t      mesh;
 	material_t  material;
-	int32_t     mesh_inds;
+	int32_t     mesh_inds; // -1 reads the mesh's ind_draw when drawn
 	uint16_t    layer;
 };
 
+struct render_sort_key_t {
+	uint64_t sort_id;
+	uint32_t index;
+};
+
+struct render_persist_t {
+	render_item_t item;
+	int32_t       next;       // Next item in this material chain, or -1
+	uint32_t      material_generation; // The material's sort_generation when sort_id was derived
+	uint16_t      generation; // Bumped each time the slot is freed
+	bool          used;
+	bool          head;       // First slot of a chain, the one ids refer to
+};
+
+struct render_persist_order_t {
+	uint64_t sort_id;
+	int32_t  index;
+};
+
 enum render_list_state_ {
 	render_list_state_destroyed = -1,
 	render_list_state_empty = 0,
@@ -38,9 +57,30 @@ struct _render_list_t {
 	asset_header_t         header;
 	array_t<render_item_t> queue;
 	render_stats_t         stats;
+	// What stats was when the list was last cleared.
+	render_stats_t         stats_prev;
 	render_list_state_     state;
 	bool                   prepped;
 	int32_t                prev_count;
+	// Queue index for each sorted position, from the last time this list
+	// was sorted. Lists tend to get the same items in the same order each
+	// frame, so this is often still a valid sort.
+	array_t<uint32_t>      sort_order;
+
+	// Shards are lists that other threads fill in parallel, and get merged
+	// into this list's queue before it's sorted. A shard knows its parent so
+	// it can skip main thread only state, like the hierarchy stack.
+	array_t<render_list_t> shards;
+	render_list_t          shard_parent;
+
+	// Persistent items stay in the list across render_list_clear calls. They
+	// live in stable slots so their ids stay valid, and a separate order
+	// array is only re-sorted when items are added or removed.
+	array_t<render_persist_t>       persist;
+	array_t<int32_t>                persist_free;
+	array_t<render_persist_order_t> persist_order;
+	bool                            persist_dirty;
+	uint32_t                        persist_material_changes; // material_sort_changes at the last check
 };
 
 
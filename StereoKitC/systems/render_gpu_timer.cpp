@@ -0,0 +1,162 @@
+#include "render_gpu_timer.h"
+
+#include <sk_gpu.h>
+
+#if defined(SKG_DIRECT3D11) && !defined(SK_GPU_NULL)
+	#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <d3d11.h>
+#endif
+
+namespace sk {
+
+#if defined(SKG_DIRECT3D11) && !defined(SK_GPU_NULL)
+
+///////////////////////////////////////////
+
+// Enough slots that a frame's queries are almost always finished by the
+// time we come back around to them.
+#define GPU_TIMER_FRAMES 4
+#define GPU_TIMER_PAIRS  16
+
+struct gpu_timer_frame_t {
+	ID3D11Query *disjoint;
+	ID3D11Query *stamps[GPU_TIMER_PAIRS * 2];
+	int32_t      pair_count;
+	bool         open_pair;
+	bool         active;
+	bool         pending;
+};
+
+struct gpu_timer_state_t {
+	ID3D11Device        *device;
+	ID3D11DeviceContext *context;
+	gpu_timer_frame_t    frames[GPU_TIMER_FRAMES];
+	int32_t              curr;
+	float                last_ms;
+};
+static gpu_timer_state_t local = {};
+
+///////////////////////////////////////////
+
+void render_gpu_timer_init() {
+	local = {};
+	local.last_ms = -1;
+	local.device  = (ID3D11Device*)skg_get_platform_data()._d3d11_device;
+	if (local.device == nullptr) return;
+	local.device->GetImmediateContext(&local.context);
+
+	D3D11_QUERY_DESC disjoint_desc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+	D3D11_QUERY_DESC stamp_desc    = { D3D11_QUERY_TIMESTAMP,          0 };
+	for (int32_t f = 0; f < GPU_TIMER_FRAMES; f++) {
+		local.device->CreateQuery(&disjoint_desc, &local.frames[f].disjoint);
+		for (int32_t s = 0; s < GPU_TIMER_PAIRS * 2; s++)
+			local.device->CreateQuery(&stamp_desc, &local.frames[f].stamps[s]);
+	}
+}
+
+///////////////////////////////////////////
+
+void render_gpu_timer_shutdown() {
+	for (int32_t f = 0; f < GPU_TIMER_FRAMES; f++) {
+		if (local.frames[f].disjoint) local.frames[f].disjoint->Release();
+		for (int32_t s = 0; s < GPU_TIMER_PAIRS * 2; s++) {
+			if (local.frames[f].stamps[s]) local.frames[f].stamps[s]->Release();
+		}
+	}
+	if (local.context) local.context->Release();
+	local = {};
+}
+
+///////////////////////////////////////////
+
+void render_gpu_timer_begin() {
+	if (local.context == nullptr) return;
+	gpu_timer_frame_t *frame = &local.frames[local.curr];
+	if (frame->pending || frame->open_pair || frame->pair_count >= GPU_TIMER_PAIRS) return;
+
+	if (!frame->active) {
+		local.context->Begin(frame->disjoint);
+		frame->active = true;
+	}
+	local.context->End(frame->stamps[frame->pair_count * 2]);
+	frame->open_pair = true;
+}
+
+///////////////////////////////////////////
+
+void render_gpu_timer_end() {
+	if (local.context == nullptr) return;
+	gpu_timer_frame_t *frame = &local.frames[local.curr];
+	if (!frame->open_pair) return;
+
+	local.context->End(frame->stamps[frame->pair_count * 2 + 1]);
+	frame->pair_count += 1;
+	frame->open_pair   = false;
+}
+
+///////////////////////////////////////////
+
+void gpu_timer_resolve(gpu_timer_frame_t *frame) {
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+	if (local.context->GetData(frame->disjoint, &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+		return;
+
+	// Disjoint means the GPU clock changed frequency partway through, so the
+	// timestamps can't be trusted.
+	if (!disjoint.Disjoint && disjoint.Frequency != 0) {
+		uint64_t ticks = 0;
+		for (int32_t i = 0; i < frame->pair_count; i++) {
+			uint64_t start, end;
+			if (local.context->GetData(frame->stamps[i*2  ], &start, sizeof(start), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+				local.context->GetData(frame->stamps[i*2+1], &end,   sizeof(end),   D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+				return;
+			ticks += end - start;
+		}
+		local.last_ms = (float)((double)ticks / disjoint.Frequency * 1000.0);
+	}
+	frame->pending = false;
+}
+
+///////////////////////////////////////////
+
+float render_gpu_timer_frame_end() {
+	if (local.context == nullptr) return -1;
+
+	gpu_timer_frame_t *frame = &local.frames[local.curr];
+	if (frame->active) {
+		if (frame->open_pair) render_gpu_timer_end();
+		local.context->End(frame->disjoint);
+		frame->active  = false;
+		frame->pending = true;
+	}
+
+	// Check every outstanding frame, oldest first.
+	for (int32_t i = 1; i <= GPU_TIMER_FRAMES; i++) {
+		gpu_timer_frame_t *check = &local.frames[(local.curr + i) % GPU_TIMER_FRAMES];
+		if (check->pending) gpu_timer_resolve(check);
+	}
+
+	// If the next slot still hasn't resolved, the GPU is way behind, so
+	// we'll drop that measurement rather than stall.
+	local.curr = (local.curr + 1) % GPU_TIMER_FRAMES;
+	gpu_timer_frame_t *next = &local.frames[local.curr];
+	next->pending    = false;
+	next->pair_count = 0;
+	return local.last_ms;
+}
+
+#else
+
+///////////////////////////////////////////
+
+void  render_gpu_timer_init     () { }
+void  render_gpu_timer_shutdown () { }
+void  render_gpu_timer_begin    () { }
+void  render_gpu_timer_end      () { }
+float render_gpu_timer_frame_end() { return -1; }
+
+#endif
+
+} // namespace sk
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace sk {
+
+// Measures GPU time spent between begin/end pairs using timestamp queries.
+// Results are read back a few frames late so the CPU never waits on the
+// GPU. Only D3D11 supports this right now, other backends report -1.
+
+void  render_gpu_timer_init     ();
+void  render_gpu_timer_shutdown ();
+void  render_gpu_timer_begin    ();
+void  render_gpu_timer_end      ();
+// Closes out the current frame, and returns the most recently resolved
+// frame's GPU time in milliseconds, or -1 if nothing is available.
+float render_gpu_timer_frame_end();
+
+} // namespace sk
@@ -0,0 +1,231 @@
+#include "render_readback.h"
+#include "profiler.h"
+
+#include "../log.h"
+#include "../sk_memory.h"
+#include "../asset_types/texture.h"
+#include "../asset_types/texture_.h"
+#include "../libraries/array.h"
+
+#include <sk_gpu.h>
+#include <string.h>
+
+#if defined(SKG_DIRECT3D11) && !defined(SK_GPU_NULL)
+	#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <d3d11.h>
+	#define SK_READBACK_ASYNC
+#endif
+
+namespace sk {
+
+///////////////////////////////////////////
+
+// After this many frames, a read stops waiting politely and blocks on the
+// GPU, so results can't get held up forever.
+#define READBACK_MAX_LATENCY 3
+// Staging textures kept around for re-use once their read is done.
+#define READBACK_POOL_MAX    4
+
+struct readback_item_t {
+#if defined(SK_READBACK_ASYNC)
+	ID3D11Texture2D    *staging;
+#endif
+	void               *data;
+	size_t              size;
+	int32_t             row_bytes;
+	int32_t             width;
+	int32_t             height;
+	int32_t             age;
+	readback_callback_t on_ready;
+	void               *context;
+};
+
+struct readback_state_t {
+	array_t<readback_item_t>  pending;
+#if defined(SK_READBACK_ASYNC)
+	ID3D11DeviceContext      *context;
+	array_t<ID3D11Texture2D*> staging_pool;
+#endif
+};
+static readback_state_t local = {};
+
+///////////////////////////////////////////
+
+void readback_read_now(tex_t tex, readback_item_t *item) {
+	item->data = sk_malloc(item->size);
+	tex_get_data(tex, item->data, item->size);
+#if defined(SKG_OPENGL)
+	// GL textures are upside down compared to everyone else
+	void *tmp = sk_malloc(item->row_bytes);
+	for (int32_t y = 0; y < item->height / 2; y++) {
+		void *top_line = ((uint8_t *)item->data) + item->row_bytes * y;
+		void *bot_line = ((uint8_t *)item->data) + item->row_bytes * ((item->height - 1) - y);
+		memcpy(tmp,      top_line, item->row_bytes);
+		memcpy(top_line, bot_line, item->row_bytes);
+		memcpy(bot_line, tmp,      item->row_bytes);
+	}
+	sk_free(tmp);
+#endif
+}
+
+///////////////////////////////////////////
+
+#if defined(SK_READBACK_ASYNC)
+
+ID3D11Texture2D *readback_staging_get(ID3D11Texture2D *source) {
+	D3D11_TEXTURE2D_DESC desc;
+	source->GetDesc(&desc);
+
+	for (int32_t i = 0; i < local.staging_pool.count; i++) {
+		D3D11_TEXTURE2D_DESC pool_desc;
+		local.staging_pool[i]->GetDesc(&pool_desc);
+		if (pool_desc.Width == desc.Width && pool_desc.Height == desc.Height && pool_desc.Format == desc.Format) {
+			ID3D11Texture2D *result = local.staging_pool[i];
+			local.staging_pool.remove(i);
+			return result;
+		}
+	}
+
+	desc.MipLevels          = 1;
+	desc.ArraySize          = 1;
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage              = D3D11_USAGE_STAGING;
+	desc.BindFlags          = 0;
+	desc.CPUAccessFlags     = D3D11_CPU_ACCESS_READ;
+	desc.MiscFlags          = 0;
+
+	ID3D11Device    *device = nullptr;
+	ID3D11Texture2D *result = nullptr;
+	local.context->GetDevice(&device);
+	if (FAILED(device->CreateTexture2D(&desc, nullptr, &result))) {
+		log_warn("render_readback: Failed to create a staging texture, reading back synchronously.");
+		result = nullptr;
+	}
+	device->Release();
+	return result;
+}
+
+///////////////////////////////////////////
+
+void readback_staging_release(ID3D11Texture2D *staging) {
+	if (local.staging_pool.count < READBACK_POOL_MAX) local.staging_pool.add(staging);
+	else                                              staging->Release();
+}
+
+///////////////////////////////////////////
+
+bool readback_resolve(readback_item_t *item, bool wait) {
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	HRESULT hr = local.context->Map(item->staging, 0, D3D11_MAP_READ, wait ? 0 : D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+	if (hr == DXGI_ERROR_WAS_STILL_DRAWING) return false;
+
+	item->data = sk_malloc(item->size);
+	if (SUCCEEDED(hr)) {
+		for (int32_t y = 0; y < item->height; y++) {
+			memcpy(
+				(uint8_t *)item->data  + item->row_bytes * y,
+				(uint8_t *)mapped.pData + mapped.RowPitch * y,
+				item->row_bytes);
+		}
+		local.context->Unmap(item->staging, 0);
+	} else {
+		log_warn("render_readback: Couldn't map the staging texture!");
+		memset(item->data, 0, item->size);
+	}
+
+	readback_staging_release(item->staging);
+	item->staging = nullptr;
+	return true;
+}
+
+#endif
+
+///////////////////////////////////////////
+
+void render_readback_init() {
+	local = {};
+#if defined(SK_READBACK_ASYNC)
+	ID3D11Device *device = (ID3D11Device *)skg_get_platform_data()._d3d11_device;
+	if (device != nullptr)
+		device->GetImmediateContext(&local.context);
+#endif
+}
+
+///////////////////////////////////////////
+
+void render_readback_shutdown() {
+	// Anything still waiting gets finished off, so queued up screenshots
+	// aren't silently lost.
+	while (local.pending.count > 0) {
+		readback_item_t item = local.pending[0];
+		local.pending.remove(0);
+#if defined(SK_READBACK_ASYNC)
+		if (item.staging != nullptr) readback_resolve(&item, true);
+#endif
+		item.on_ready(item.data, item.width, item.height, item.context);
+	}
+	local.pending.free();
+
+#if defined(SK_READBACK_ASYNC)
+	for (int32_t i = 0; i < local.staging_pool.count; i++)
+		local.staging_pool[i]->Release();
+	local.staging_pool.free();
+	if (local.context) local.context->Release();
+#endif
+	local = {};
+}
+
+///////////////////////////////////////////
+
+void render_readback_request(tex_t tex, readback_callback_t on_ready, void *context) {
+	readback_item_t item = {};
+	item.width     = tex->width;
+	item.height    = tex->height;
+	item.size      = tex_format_size(tex->format, tex->width, tex->height);
+	item.row_bytes = (int32_t)skg_tex_fmt_pitch(tex->tex.format, tex->width);
+	item.on_ready  = on_ready;
+	item.context   = context;
+
+#if defined(SK_READBACK_ASYNC)
+	ID3D11Texture2D *source = local.context != nullptr
+		? (ID3D11Texture2D *)skg_tex_get_native(&tex->tex)
+		: nullptr;
+	if (source != nullptr) item.staging = readback_staging_get(source);
+	if (item.staging != nullptr) {
+		local.context->CopySubresourceRegion(item.staging, 0, 0, 0, 0, source, 0, nullptr);
+		local.pending.add(item);
+		return;
+	}
+#endif
+
+	// No async path, so this stalls until the GPU catches up.
+	readback_read_now(tex, &item);
+	if (local.pending.count == 0) item.on_ready(item.data, item.width, item.height, item.context);
+	else                          local.pending.add(item);
+}
+
+///////////////////////////////////////////
+
+void render_readback_update() {
+	if (local.pending.count == 0) return;
+	profiler_zone("Render Readback");
+
+	// Only the front of the queue is checked, results are handed out in the
+	// order they were requested, even if a later one finishes first.
+	while (local.pending.count > 0) {
+		readback_item_t item = local.pending[0];
+#if defined(SK_READBACK_ASYNC)
+		if (item.staging != nullptr && !readback_resolve(&item, item.age >= READBACK_MAX_LATENCY)) {
+			local.pending[0].age += 1;
+			break;
+		}
+#endif
+		local.pending.remove(0);
+		item.on_ready(item.data, item.width, item.height, item.context);
+	}
+}
+
+} // namespace sk
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../stereokit.h"
+
+namespace sk {
+
+// Reads textures back to the CPU without stalling on the GPU. Where the
+// backend allows it, the texture is copied into a staging texture, which is
+// mapped a few frames later once the GPU has caught up. Other backends read
+// the texture back immediately.
+//
+// Callbacks happen on the main thread in the same order as their requests,
+// and take ownership of the data, which must be freed with sk_free.
+
+typedef void (*readback_callback_t)(void *data, int32_t width, int32_t height, void *context);
+
+void render_readback_init    ();
+// Finishes any outstanding reads, and calls their callbacks.
+void render_readback_shutdown();
+// The texture is copied right away, so it can be re-used as soon as this
+// returns.
+void render_readback_request (tex_t tex, readback_callback_t on_ready, void *context);
+// Main thread, once per frame, calls callbacks for any finished reads.
+void render_readback_update  ();
+
+} // namespace sk
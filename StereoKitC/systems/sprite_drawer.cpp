@@ -1,6 +1,7 @@
 #include "sprite_drawer.h"
 
 #include "../asset_types/sprite.h"
+#include "../asset_types/mesh.h"
 
 #include "../libraries/array.h"
 #include "../hierarchy.h"
@@ -16,6 +17,12 @@ namespace sk {
 array_t<sprite_buffer_t> sprite_buffers = {};
 mesh_t                   sprite_quad_old;
 mesh_t                   sprite_quad;
+// Every batch uses the same quad index pattern, so they all borrow this
+// mesh's index buffer, sized to the largest batch we've seen.
+mesh_t                   sprite_inds;
+int32_t                  sprite_inds_quads;
+
+const int32_t            sprite_buffer_min_quads = 64;
 
 ///////////////////////////////////////////
 
@@ -24,21 +31,20 @@ void sprite_drawer_add_buffer(material_t material) {
 	sprite_buffer_t &buffer = sprite_buffers.last();
 	buffer.material = material;
 	buffer.mesh     = mesh_create();
+	mesh_set_keep_data(buffer.mesh, false);
+	if (sprite_inds_quads > 0)
+		mesh_borrow_inds(buffer.mesh, sprite_inds);
 }
 
 ///////////////////////////////////////////
 
-void sprite_buffer_ensure_capacity(sprite_buffer_t &buffer) {
-	if (buffer.vert_count + 4 <= buffer.vert_cap)
+void sprite_inds_ensure_capacity(int32_t quads) {
+	if (quads <= sprite_inds_quads)
 		return;
 
-	buffer.vert_cap = buffer.vert_count + 4;
-	buffer.verts    = sk_realloc_t(vert_t, buffer.verts, buffer.vert_cap);
-
-	// regenerate indices
-	vind_t  quads = (vind_t)(buffer.vert_cap / 4);
-	vind_t *inds  = sk_malloc_t(vind_t, quads * 6);
-	for (vind_t i = 0; i < quads; i++) {
+	sprite_inds_quads = quads;
+	vind_t *inds = sk_malloc_t(vind_t, sprite_inds_quads * 6);
+	for (vind_t i = 0; i < (vind_t)sprite_inds_quads; i++) {
 		vind_t q = i * 4;
 		vind_t c = i * 6;
 		inds[c+0] = q+2;
@@ -49,8 +55,28 @@ void sprite_buffer_ensure_capacity(sprite_buffer_t &buffer) {
 		inds[c+4] = q+2;
 		inds[c+5] = q;
 	}
-	mesh_set_inds(buffer.mesh, inds, quads * 6);
+	mesh_set_inds(sprite_inds, inds, sprite_inds_quads * 6);
 	sk_free(inds);
+
+	// The old index buffer is gone, so everyone needs to look at the new one
+	for (int32_t i = 0; i < sprite_buffers.count; i++)
+		mesh_borrow_inds(sprite_buffers[i].mesh, sprite_inds);
+}
+
+///////////////////////////////////////////
+
+void sprite_buffer_ensure_capacity(sprite_buffer_t &buffer) {
+	if (buffer.vert_count + 4 <= buffer.vert_cap)
+		return;
+
+	// Grow geometrically, so a frame with N sprites only reallocates log(N)
+	// times instead of once per sprite.
+	int32_t quads = buffer.vert_cap / 4 * 2;
+	if (quads < sprite_buffer_min_quads) quads = sprite_buffer_min_quads;
+
+	buffer.vert_cap = quads * 4;
+	buffer.verts    = sk_realloc_t(vert_t, buffer.verts, buffer.vert_cap);
+	sprite_inds_ensure_capacity(quads);
 }
 
 ///////////////////////////////////////////
@@ -128,6 +154,11 @@ bool sprite_drawer_init() {
 	mesh_set_keep_data(sprite_quad_old, false);
 	mesh_set_data     (sprite_quad_old, verts, 4, inds, 6, false);
 
+	sprite_inds = mesh_create();
+	mesh_set_id       (sprite_inds, "render/sprite_batch_inds");
+	mesh_set_keep_data(sprite_inds, false);
+	sprite_inds_quads = 0;
+
 	return true;
 }
 
@@ -152,13 +183,15 @@ void sprite_drawer_step() {
 void sprite_drawer_shutdown() {
 	mesh_release(sprite_quad);
 	mesh_release(sprite_quad_old);
+	mesh_release(sprite_inds);
+	sprite_inds_quads = 0;
 	for (int32_t i = 0; i < sprite_buffers.count; i++) {
 		sprite_buffer_t &buffer = sprite_buffers[i];
 		mesh_release(buffer.mesh);
 		material_release(buffer.material);
 		sk_free(buffer.verts);
 	}
-	sprite_buffers.clear();
+	sprite_buffers.free();
 }
 
 } // namespace sk
\ No newline at end of file
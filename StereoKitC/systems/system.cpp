@@ -1,4 +1,5 @@
 #include "system.h"
+#include "profiler.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -162,6 +163,8 @@ bool systems_initialize() {
 void system_execute(system_t *sys) {
 	if (sys == nullptr || sys->func_step == nullptr) return;
 
+	profiler_zone(sys->name);
+
 	// start timing
 	sys->profile_frame_start = stm_now();
 
@@ -2,6 +2,7 @@
 #include "../stereokit.h"
 #include "../asset_types/font.h"
 #include "../systems/defaults.h"
+#include "../systems/profiler.h"
 #include "../hierarchy.h"
 #include "../sk_math_dx.h"
 #include "../sk_math.h"
@@ -42,11 +43,57 @@ struct text_stepper_t {
 	vec2           bounds;
 };
 
+// A glyph quad in the text's own space, after layout and clipping. The
+// other two corners are (p1.x, p0.y) and (p0.x, p1.y).
+struct text_quad_t {
+	vec2           p0, p1;
+	vec2           uv0, uv1;
+};
+
+// Everything besides the string itself that changes where glyphs land.
+// Color and transform are applied when the quads are copied out, so they
+// aren't part of this.
+struct text_layout_key_t {
+	text_style_t   style;
+	float          char_height;
+	float          line_spacing;
+	uint32_t       font_gen;
+	vec2           size;
+	int32_t        auto_size;
+	text_fit_      fit;
+	text_align_    position;
+	text_align_    align;
+	float          off_x;
+	float          off_y;
+	int32_t        char_size;
+};
+
+struct text_layout_t {
+	uint64_t          hash;
+	text_layout_key_t key;
+	void             *text;
+	size_t            text_bytes;
+	float             scale;
+	float             height;
+	text_quad_t      *quads;
+	int32_t           quad_count;
+	uint64_t          last_used;
+};
+
 ///////////////////////////////////////////
 
 array_t<_text_style_t> text_styles  = {};
 array_t<text_buffer_t> text_buffers = {};
 
+// Laid out text from recent frames, so static labels don't get re-wrapped
+// every time they're drawn. Entries not drawn for a little while are dropped.
+array_t  <text_layout_t>     text_layouts       = {};
+hashmap_t<uint64_t, int32_t> text_layout_lookup = {};
+array_t  <text_quad_t>       text_layout_quads  = {};
+uint64_t                     text_layout_frame  = 0;
+const int32_t                text_layout_max       = 4096;
+const uint64_t               text_layout_keep_frames = 30;
+
 ///////////////////////////////////////////
 
 inline bool text_is_space(char32_t c) {
@@ -454,22 +501,18 @@ vec2 text_char_at_16(const char16_t* text_utf16, text_style_t style, int32_t cha
 
 ///////////////////////////////////////////
 
-void text_add_quad(float x, float y, float off_z, const font_char_t *char_info, const _text_style_t *style_data, color32 color, text_buffer_t &buffer, vec3 base, vec3 normal, vec3 up, vec3 right) {
-	base -= normal * off_z;
-	vec3 x_min = base + (x - char_info->x0 * style_data->char_height) * right;
-	vec3 x_max = base + (x - char_info->x1 * style_data->char_height) * right;
-	vec3 y_min =        (y + char_info->y0 * style_data->char_height) * up;
-	vec3 y_max =        (y + char_info->y1 * style_data->char_height) * up;
-
-	buffer.verts[buffer.vert_count++] = { x_min + y_min, normal, vec2{ char_info->u0, char_info->v0 }, color };
-	buffer.verts[buffer.vert_count++] = { x_max + y_min, normal, vec2{ char_info->u1, char_info->v0 }, color };
-	buffer.verts[buffer.vert_count++] = { x_max + y_max, normal, vec2{ char_info->u1, char_info->v1 }, color };
-	buffer.verts[buffer.vert_count++] = { x_min + y_max, normal, vec2{ char_info->u0, char_info->v1 }, color };
+void text_layout_quad(float x, float y, const font_char_t *char_info, const _text_style_t *style_data) {
+	text_quad_t quad;
+	quad.p0  = { x - char_info->x0 * style_data->char_height, y + char_info->y0 * style_data->char_height };
+	quad.p1  = { x - char_info->x1 * style_data->char_height, y + char_info->y1 * style_data->char_height };
+	quad.uv0 = { char_info->u0, char_info->v0 };
+	quad.uv1 = { char_info->u1, char_info->v1 };
+	text_layout_quads.add(quad);
 }
 
 ///////////////////////////////////////////
 
-void text_add_quad_clipped(float x, float y, float off_z, vec2 bounds_min, vec2 bounds_max, const font_char_t *char_info, const _text_style_t *style_data, color32 color, text_buffer_t &buffer, const XMMATRIX &tr, vec3 normal, vec3 up, vec3 right) {
+void text_layout_quad_clipped(float x, float y, vec2 bounds_min, vec2 bounds_max, const font_char_t *char_info, const _text_style_t *style_data) {
 	float x_max = x - char_info->x0 * style_data->char_height;
 	float x_min = x - char_info->x1 * style_data->char_height;
 	float y_max = y + char_info->y0 * style_data->char_height;
@@ -505,70 +548,143 @@ void text_add_quad_clipped(float x, float y, float off_z, vec2 bounds_min, vec2
 		y_max = bounds_max.y;
 	}
 
-	buffer.verts[buffer.vert_count++] = { matrix_mul_point(tr, vec3{ x_max, y_max, off_z }), normal, vec2{ u_max, v_max }, color };
-	buffer.verts[buffer.vert_count++] = { matrix_mul_point(tr, vec3{ x_min, y_max, off_z }), normal, vec2{ u_min, v_max }, color };
-	buffer.verts[buffer.vert_count++] = { matrix_mul_point(tr, vec3{ x_min, y_min, off_z }), normal, vec2{ u_min, v_min }, color };
-	buffer.verts[buffer.vert_count++] = { matrix_mul_point(tr, vec3{ x_max, y_min, off_z }), normal, vec2{ u_max, v_min }, color };
+	text_quad_t quad;
+	quad.p0  = { x_max, y_max };
+	quad.p1  = { x_min, y_min };
+	quad.uv0 = { u_max, v_max };
+	quad.uv1 = { u_min, v_min };
+	text_layout_quads.add(quad);
 }
 
 ///////////////////////////////////////////
 
-void text_add_at(const char* text, const matrix &transform, text_style_t style, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
-	text_add_in(text, transform, text_size(text, style), text_fit_exact, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
+void text_emit_quads(const text_quad_t *quads, int32_t quad_count, text_buffer_t &buffer, const XMMATRIX &tr, vec3 normal, float off_z, color32 color) {
+	text_buffer_ensure_capacity(buffer, quad_count);
+
+	vec3 up    = matrix_mul_direction(tr, vec3_up);
+	vec3 right = matrix_mul_direction(tr, vec3_right);
+	vec3 base  = matrix_mul_point    (tr, vec3{ 0, 0, off_z });
+	for (int32_t i = 0; i < quad_count; i++) {
+		const text_quad_t &q = quads[i];
+		vec3 x0 = base + q.p0.x * right;
+		vec3 x1 = base + q.p1.x * right;
+		vec3 y0 = q.p0.y * up;
+		vec3 y1 = q.p1.y * up;
+
+		buffer.verts[buffer.vert_count++] = { x0 + y0, normal, q.uv0,                   color };
+		buffer.verts[buffer.vert_count++] = { x1 + y0, normal, vec2{ q.uv1.x, q.uv0.y }, color };
+		buffer.verts[buffer.vert_count++] = { x1 + y1, normal, q.uv1,                   color };
+		buffer.verts[buffer.vert_count++] = { x0 + y1, normal, vec2{ q.uv0.x, q.uv1.y }, color };
+	}
 }
 
 ///////////////////////////////////////////
 
-void text_add_at_16(const char16_t* text, const matrix &transform, text_style_t style, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
-	text_add_in_16(text, transform, text_size_16(text, style), text_fit_exact, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
+template<typename C>
+size_t text_byte_length(const C *text) {
+	const C *end = text;
+	while (*end != 0) end++;
+	return (size_t)(end - text) * sizeof(C);
 }
 
 ///////////////////////////////////////////
 
-template<typename C, bool (*char_decode_b_T)(const C *, const C **, char32_t *)>
-float text_add_in_g(const C* text, const matrix& transform, vec2 size, text_fit_ fit, text_style_t style_id, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
-	if (text == nullptr) return 0;
-	if (size.x <= 0) return 0; // Zero width text isn't visible, and causes issues when trying to determine text height.
+uint64_t text_layout_hash(const text_layout_key_t &key, const void *text, size_t text_bytes) {
+	uint64_t       hash  = 14695981039346656037UL;
+	const uint8_t *bytes = (const uint8_t *)&key;
+	for (size_t i = 0; i < sizeof(key);  i++) hash = (hash ^ bytes[i]) * 1099511628211;
+	bytes = (const uint8_t *)text;
+	for (size_t i = 0; i < text_bytes;   i++) hash = (hash ^ bytes[i]) * 1099511628211;
+	return hash == 0 ? 1 : hash;
+}
 
-	XMMATRIX tr;
-	if (hierarchy_use_top()) {
-		matrix_mul(transform, hierarchy_top(), tr);
-	} else {
-		math_matrix_to_fast(transform, &tr);
+///////////////////////////////////////////
+
+text_layout_t *text_layout_find(uint64_t hash, const text_layout_key_t &key, const void *text, size_t text_bytes) {
+	int32_t *index = text_layout_lookup.get(hash);
+	if (index == nullptr) return nullptr;
+
+	text_layout_t *layout = &text_layouts[*index];
+	if (layout->text_bytes != text_bytes
+		|| memcmp(&layout->key, &key, sizeof(key)) != 0
+		|| memcmp(layout->text, text, text_bytes) != 0)
+		return nullptr;
+	return layout;
+}
+
+///////////////////////////////////////////
+
+void text_layout_store(uint64_t hash, const text_layout_key_t &key, const void *text, size_t text_bytes, float scale, float height) {
+	if (text_layouts.count >= text_layout_max || text_layout_lookup.contains(hash) != -1)
+		return;
+
+	text_layout_t layout = {};
+	layout.hash       = hash;
+	layout.key        = key;
+	layout.text_bytes = text_bytes;
+	layout.scale      = scale;
+	layout.height     = height;
+	layout.quad_count = text_layout_quads.count;
+	layout.last_used  = text_layout_frame;
+	layout.quads      = sk_malloc_t(text_quad_t, layout.quad_count > 0 ? layout.quad_count : 1);
+	layout.text       = sk_malloc(text_bytes > 0 ? text_bytes : 1);
+	memcpy(layout.quads, text_layout_quads.data, sizeof(text_quad_t) * layout.quad_count);
+	memcpy(layout.text,  text,                   text_bytes);
+
+	text_layout_lookup.set(hash, text_layouts.add(layout));
+}
+
+///////////////////////////////////////////
+
+void text_layout_free(text_layout_t &layout) {
+	sk_free(layout.quads);
+	sk_free(layout.text);
+}
+
+///////////////////////////////////////////
+
+void text_layout_evict() {
+	bool removed = false;
+	for (int32_t i = text_layouts.count - 1; i >= 0; i--) {
+		if (text_layout_frame - text_layouts[i].last_used <= text_layout_keep_frames)
+			continue;
+		text_layout_free(text_layouts[i]);
+		text_layouts[i] = text_layouts.last();
+		text_layouts.pop();
+		removed = true;
 	}
-	vec3 normal = matrix_mul_direction(tr, vec3_forward);
+	if (!removed) return;
+
+	// Entries moved around, so the index needs rebuilding
+	text_layout_lookup.free();
+	for (int32_t i = 0; i < text_layouts.count; i++)
+		text_layout_lookup.set(text_layouts[i].hash, i);
+}
+
+///////////////////////////////////////////
 
-	// Debug draw bounds
-	/*vec2 dbg_start = step.start;
-	if      (position & text_align_x_center) dbg_start.x += step.bounds.x / 2.f;
-	else if (position & text_align_x_right)  dbg_start.x += step.bounds.x;
-	if      (position & text_align_y_center) dbg_start.y += step.bounds.y / 2.f;
-	else if (position & text_align_y_bottom) dbg_start.y += step.bounds.y;
-	line_add({ dbg_start.x, dbg_start.y,                 off_z }, { dbg_start.x - step.bounds.x, dbg_start.y, off_z }, { 255,0,255,255 }, { 255,0,255,255 }, 0.002f);
-	line_add({ dbg_start.x, dbg_start.y - step.bounds.y, off_z }, { dbg_start.x - step.bounds.x, dbg_start.y - step.bounds.y, off_z }, { 255,255,255,255 }, { 255,255,255,255 }, 0.002f);
-	line_add({ dbg_start.x, dbg_start.y,                 off_z }, { dbg_start.x,                 dbg_start.y - step.bounds.y, off_z }, { 255,255,255,255 }, { 255,255,255,255 }, 0.002f);
-	line_add({ dbg_start.x - step.bounds.x, dbg_start.y, off_z }, { dbg_start.x - step.bounds.x, dbg_start.y - step.bounds.y, off_z }, { 255,255,255,255 }, { 255,255,255,255 }, 0.002f);*/
+// Lays out the text in its own space, and leaves the glyph quads in
+// text_layout_quads. Returns the height the text took up, and the scale that
+// the fit mode needs applied to the transform.
+template<typename C, bool (*char_decode_b_T)(const C *, const C **, char32_t *)>
+float text_layout_g(const C* text, vec2 size, text_fit_ fit, text_style_t style_id, text_align_ position, text_align_ align, float off_x, float off_y, float *out_scale) {
+	profiler_zone("Text Layout");
+	text_layout_quads.clear();
 
 	// Ensure scale is right for our fit
-	vec2 bounds = size;
+	vec2  bounds = size;
+	float scale  = 1;
 	if (fit & (text_fit_squeeze | text_fit_exact)) {
 		vec2 txt_size = text_size_g<C, char_decode_b_T>(text, style_id);
 		vec2 scale_xy = {
 			size.x / txt_size.x,
 			size.y / txt_size.y };
-		float scale = fminf(scale_xy.x, scale_xy.y)*0.999f;
+		scale = fminf(scale_xy.x, scale_xy.y)*0.999f;
 		if (fit & text_fit_squeeze)
 			scale = fminf(1, scale);
-
-		// Apply the scale to the transform matrix
-		XMMATRIX scale_m = XMMatrixTranslation(-off_x, -off_y, -off_z) * XMMatrixScaling(scale, scale, 1) * XMMatrixTranslation(off_x, off_y, off_z);
-		tr = XMMatrixMultiply(scale_m, tr);
 		bounds = bounds / scale;
 	}
-
-	vec3 up    = matrix_mul_direction(tr, vec3_up);
-	vec3 right = matrix_mul_direction(tr, vec3_right);
-	vec3 base  = matrix_mul_point    (tr, vec3_zero);
+	*out_scale = scale;
 
 	// Calculate the strlen and text height for verical centering
 	const _text_style_t* style = &text_styles[style_id];
@@ -594,14 +710,7 @@ float text_add_in_g(const C* text, const matrix& transform, vec2 size, text_fit_
 	if      (align & text_align_y_center) pos.y -= (bounds.y-text_height) / 2.f;
 	else if (align & text_align_y_bottom) pos.y -=  bounds.y-text_height;
 
-	// Ensure text capacity
-	text_buffer_t &buffer = text_buffers[style->buffer_index];
-	text_buffer_ensure_capacity(buffer, text_length);
-
-	// Get the final color
-	color32 color = color_to_32( color32_to_128(style->color) * vertex_tint_linear );
-
-	// Core loop for drawing the text
+	// Core loop for laying out the text
 	bool     clip           = fit & text_fit_clip;
 	char32_t c              = 0;
 	int32_t  line_remaining = 0;
@@ -610,7 +719,7 @@ float text_add_in_g(const C* text, const matrix& transform, vec2 size, text_fit_
 		while(char_decode_b_T(text, &text, &c)) {
 			const font_char_t *char_info = font_get_glyph(style->font, c);
 			if (!text_is_space(c)) {
-				text_add_quad_clipped(pos.x, pos.y, off_z, bounds_min, bounds_max, char_info, style, color, buffer, tr, normal, up, right);
+				text_layout_quad_clipped(pos.x, pos.y, bounds_min, bounds_max, char_info, style);
 			}
 			text_step_position<C, char_decode_b_T>(c, char_info, text, style, align, wrap, bounds.x, start.x, &line_remaining, &pos);
 		}
@@ -618,7 +727,7 @@ float text_add_in_g(const C* text, const matrix& transform, vec2 size, text_fit_
 		while (char_decode_b_T(text, &text, &c)) {
 			const font_char_t* char_info = font_get_glyph(style->font, c);
 			if (!text_is_space(c)) {
-				text_add_quad(pos.x, pos.y, off_z, char_info, style, color, buffer, base, normal, up, right);
+				text_layout_quad(pos.x, pos.y, char_info, style);
 			}
 			text_step_position<C, char_decode_b_T>(c, char_info, text, style, align, wrap, bounds.x, start.x, &line_remaining, &pos);
 		}
@@ -626,12 +735,91 @@ float text_add_in_g(const C* text, const matrix& transform, vec2 size, text_fit_
 	return (start.y - pos.y) - style->char_height;
 }
 
+///////////////////////////////////////////
+
+template<typename C, bool (*char_decode_b_T)(const C *, const C **, char32_t *)>
+float text_add_in_g(const C* text, const matrix& transform, vec2 size, bool auto_size, text_fit_ fit, text_style_t style_id, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
+	if (text == nullptr) return 0;
+
+	XMMATRIX tr;
+	if (hierarchy_use_top()) {
+		matrix_mul(transform, hierarchy_top(), tr);
+	} else {
+		math_matrix_to_fast(transform, &tr);
+	}
+	vec3 normal = matrix_mul_direction(tr, vec3_forward);
+
+	// Look for this exact text and layout from a previous frame. Font atlas
+	// growth moves glyph UVs around, so that's part of the key too.
+	const _text_style_t *style = &text_styles[style_id];
+	text_layout_key_t key;
+	memset(&key, 0, sizeof(key));
+	key.style        = style_id;
+	key.char_height  = style->char_height;
+	key.line_spacing = style->line_spacing;
+	key.font_gen     = style->font->uv_generation;
+	key.size         = auto_size ? vec2{} : size;
+	key.auto_size    = auto_size;
+	key.fit          = fit;
+	key.position     = position;
+	key.align        = align;
+	key.off_x        = off_x;
+	key.off_y        = off_y;
+	key.char_size    = sizeof(C);
+	size_t   text_bytes = text_byte_length(text);
+	uint64_t hash       = text_layout_hash(key, text, text_bytes);
+
+	const text_quad_t *quads;
+	int32_t            quad_count;
+	float              scale;
+	float              height;
+	text_layout_t     *layout = text_layout_find(hash, key, text, text_bytes);
+	if (layout != nullptr) {
+		layout->last_used = text_layout_frame;
+		quads      = layout->quads;
+		quad_count = layout->quad_count;
+		scale      = layout->scale;
+		height     = layout->height;
+	} else {
+		if (auto_size) size = text_size_g<C, char_decode_b_T>(text, style_id);
+		if (size.x <= 0) return 0; // Zero width text isn't visible, and causes issues when trying to determine text height.
+
+		height = text_layout_g<C, char_decode_b_T>(text, size, fit, style_id, position, align, off_x, off_y, &scale);
+		text_layout_store(hash, key, text, text_bytes, scale, height);
+		quads      = text_layout_quads.data;
+		quad_count = text_layout_quads.count;
+	}
+
+	// Apply the fit's scale to the transform matrix
+	if (fit & (text_fit_squeeze | text_fit_exact)) {
+		XMMATRIX scale_m = XMMatrixTranslation(-off_x, -off_y, -off_z) * XMMatrixScaling(scale, scale, 1) * XMMatrixTranslation(off_x, off_y, off_z);
+		tr = XMMatrixMultiply(scale_m, tr);
+	}
+
+	// Get the final color
+	color32 color = color_to_32( color32_to_128(style->color) * vertex_tint_linear );
+
+	text_emit_quads(quads, quad_count, text_buffers[style->buffer_index], tr, normal, off_z, color);
+	return height;
+}
 
 float text_add_in(const char *text, const matrix &transform, vec2 size, text_fit_ fit, text_style_t style, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
-	return text_add_in_g<char, utf8_decode_fast_b>(text, transform, size, fit, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
+	return text_add_in_g<char, utf8_decode_fast_b>(text, transform, size, false, fit, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
 }
 float text_add_in_16(const char16_t *text, const matrix &transform, vec2 size, text_fit_ fit, text_style_t style, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
-	return text_add_in_g<char16_t, utf16_decode_fast_b>(text, transform, size, fit, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
+	return text_add_in_g<char16_t, utf16_decode_fast_b>(text, transform, size, false, fit, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
+}
+
+///////////////////////////////////////////
+
+void text_add_at(const char* text, const matrix &transform, text_style_t style, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
+	text_add_in_g<char, utf8_decode_fast_b>(text, transform, {}, true, text_fit_exact, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
+}
+
+///////////////////////////////////////////
+
+void text_add_at_16(const char16_t* text, const matrix &transform, text_style_t style, text_align_ position, text_align_ align, float off_x, float off_y, float off_z, color128 vertex_tint_linear) {
+	text_add_in_g<char16_t, utf16_decode_fast_b>(text, transform, {}, true, text_fit_exact, style, position, align, off_x, off_y, off_z, vertex_tint_linear);
 }
 
 ///////////////////////////////////////////
@@ -639,6 +827,9 @@ float text_add_in_16(const char16_t *text, const matrix &transform, vec2 size, t
 void text_step() {
 	font_update_fonts();
 
+	text_layout_frame += 1;
+	text_layout_evict();
+
 	for (int32_t i = 0; i < text_buffers.count; i++) {
 		text_buffer_t &buffer = text_buffers[i];
 		if (buffer.vert_count <= 0)
@@ -665,6 +856,13 @@ void text_shutdown() {
 		sk_free(buffer.verts);
 	}
 
+	for (int32_t i = 0; i < text_layouts.count; i++)
+		text_layout_free(text_layouts[i]);
+	text_layouts      .free();
+	text_layout_lookup.free();
+	text_layout_quads .free();
+	text_layout_frame = 0;
+
 	text_styles .free();
 	text_buffers.free();
 }
@@ -77,6 +77,24 @@ bool32_t world_raycast(ray_t ray, ray_t *out_intersection) {
 
 ///////////////////////////////////////////
 
+int32_t world_raycast_batch(const ray_t *in_arr_rays, int32_t ray_count, ray_t *out_arr_intersections, bool32_t *out_arr_hit_results) {
+	if (ray_count <= 0) return 0;
+
+	switch (backend_xr_get_type()) {
+#if defined(SK_XR_OPENXR)
+	case backend_xr_type_openxr: return oxr_su_raycast_batch(in_arr_rays, ray_count, out_arr_intersections, out_arr_hit_results);
+#endif
+	default:
+		for (int32_t i = 0; i < ray_count; i++) {
+			out_arr_intersections[i] = {};
+			if (out_arr_hit_results) out_arr_hit_results[i] = false;
+		}
+		return 0;
+	}
+}
+
+///////////////////////////////////////////
+
 void world_set_occlusion_enabled(bool32_t enabled) {
 	switch (backend_xr_get_type()) {
 #if defined(SK_XR_OPENXR)
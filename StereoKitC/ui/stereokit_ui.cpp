@@ -13,6 +13,7 @@
 #include "../hierarchy.h"
 #include "../libraries/array.h"
 #include "../libraries/unicode.h"
+#include "../systems/profiler.h"
 
 #include <math.h>
 
@@ -72,7 +73,10 @@ void ui_shutdown() {
 ///////////////////////////////////////////
 
 void ui_step() {
-	ui_core_update();
+	{
+		profiler_zone("UI Core Update");
+		ui_core_update();
+	}
 	ui_theming_update();
 
 	ui_push_surface(pose_identity);
@@ -3,6 +3,7 @@
 #include "ui_layout.h"
 
 #include "../libraries/array.h"
+#include "../asset_types/mesh.h"
 #include "../utils/sdf.h"
 #include "../sk_math.h"
 #include "../platforms/platform.h"
@@ -721,6 +722,9 @@ void ui_quadrant_size_mesh(mesh_t ref_mesh, float overflow) {
 	mesh_get_verts        (ref_mesh, verts, vert_count, memory_reference);
 	ui_quadrant_size_verts(verts, vert_count, overflow);
 	mesh_set_verts        (ref_mesh, verts, vert_count);
+	// Quadrant shaders stretch verts by the transform's scale, so the mesh's
+	// bounds no longer describe what gets drawn.
+	ref_mesh->unbounded = true;
 }
 
 ///////////////////////////////////////////
@@ -776,6 +780,7 @@ void ui_default_aura_mesh(mesh_t *mesh, float tube_diameter, float corner_radius
 		}
 	}
 	mesh_set_data(*mesh, verts, vert_count, inds, ind_count);
+	(*mesh)->unbounded = true;
 
 	sk_free(verts);
 	sk_free(inds);
@@ -927,6 +932,7 @@ void _ui_gen_quadrant_mesh(mesh_t *mesh, ui_corner_ rounded_corners, float corne
 	if (*mesh == nullptr)
 		*mesh = mesh_create();
 	mesh_set_data(*mesh, verts.data, verts.count, inds.data, inds.count);
+	(*mesh)->unbounded = true;
 	verts.free();
 	inds .free();
 }
@@ -3,6 +3,8 @@
 #include "../_stereokit.h"
 #include "../systems/render.h"
 #include "../libraries/array.h"
+#include "../libraries/atomic_util.h"
+#include "../systems/jobs.h"
 #include "../asset_types/assets.h"
 #include "../asset_types/mesh_.h"
 #include "../xr_backends/openxr.h"
@@ -386,6 +388,36 @@ bool32_t oxr_su_raycast(ray_t ray, ray_t *out_intersection) {
 
 ///////////////////////////////////////////
 
+int32_t oxr_su_raycast_batch(const ray_t *rays, int32_t ray_count, ray_t *out_intersections, bool32_t *out_hit_results) {
+	struct ray_batch_t {
+		const ray_t     *rays;
+		ray_t           *hits;
+		bool32_t        *results;
+		volatile int32_t hit_count;
+	};
+
+	// Collision data is lazily created, so make sure it all exists before
+	// the workers start reading it.
+	if (xr_scene_next_req.raycast) {
+		for (int32_t i = 0; i < xr_scene_colliders.count; i++)
+			mesh_get_collision_data(xr_scene_colliders[i].mesh_ref);
+	}
+
+	ray_batch_t batch = { rays, out_intersections, out_hit_results, 0 };
+	jobs_parallel_for(ray_count, 32, [](int32_t start, int32_t end, void *data) {
+		ray_batch_t *batch = (ray_batch_t *)data;
+		for (int32_t i = start; i < end; i++) {
+			batch->hits[i] = {};
+			bool32_t hit = oxr_su_raycast(batch->rays[i], &batch->hits[i]);
+			if (batch->results) batch->results[i] = hit;
+			if (hit) atomic_increment(&batch->hit_count);
+		}
+	}, &batch);
+	return batch.hit_count;
+}
+
+///////////////////////////////////////////
+
 void oxr_su_set_occlusion_enabled(bool32_t enabled) {
 	enabled = sk_get_info_ref()->world_occlusion_present > 0 && enabled > 0;
 	if (xr_scene_next_req.occlusion == enabled) return;
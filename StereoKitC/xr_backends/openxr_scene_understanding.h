@@ -9,6 +9,7 @@ void           oxr_su_step    ();
 void           oxr_su_shutdown();
 
 bool32_t       oxr_su_raycast               (ray_t ray, ray_t* out_intersection);
+int32_t        oxr_su_raycast_batch         (const ray_t *rays, int32_t ray_count, ray_t *out_intersections, bool32_t *out_hit_results);
 void           oxr_su_set_occlusion_enabled (bool32_t enabled);
 bool32_t       oxr_su_get_occlusion_enabled ();
 void           oxr_su_set_raycast_enabled   (bool32_t enabled);
@@ -21,7 +21,7 @@ psIn vs(vsIn input, uint id : SV_InstanceID) {
 	o.view_id = id % sk_view_count;
 	id        = id / sk_view_count;
 
-	o.world = mul(input.pos, sk_inst[id].world);
+	o.world = mul(input.pos, sk_inst(id).world);
 	o.pos   = mul(o.world,   sk_viewproj[o.view_id]);
 
 	return o;
@@ -21,9 +21,15 @@ struct inst_t {
 	float4x4 world;
 	float4   color;
 };
+// Every instance StereoKit draws in a pass lives in one buffer, and each
+// draw's instances start at sk_inst_base.
 cbuffer transform_buffer : register(b2) {
-	inst_t sk_inst[819]; // 819 is UINT16_MAX / sizeof(inst_t)
+	uint sk_inst_base;
 };
+StructuredBuffer<inst_t> sk_inst_buffer : register(t14);
+
+// Instance data for this draw, `id` being SV_InstanceID / sk_view_count.
+inst_t sk_inst(uint id) { return sk_inst_buffer[sk_inst_base + id]; }
 TextureCube  sk_cubemap   : register(t11);
 SamplerState sk_cubemap_s : register(s11);
 
@@ -0,0 +1,40 @@
+#ifndef _STEREOKIT_SKIN_HLSLI
+#define _STEREOKIT_SKIN_HLSLI
+
+#include <stereokit.hlsli>
+
+///////////////////////////////////////////
+
+// Bound by StereoKit when drawing a GPU skinned mesh. Weights are packed 16
+// bytes per vertex: xy hold four 16 bit bone ids, z holds four 8 bit weights.
+StructuredBuffer<uint4>    sk_skin_weights : register(t12);
+StructuredBuffer<float4x4> sk_skin_bones   : register(t13);
+
+///////////////////////////////////////////
+
+float4x4 sk_skin_matrix(uint vertex_id) {
+	uint4  data   = sk_skin_weights[vertex_id];
+	float4 weight = float4(
+		 data.z        & 0xFF,
+		(data.z >> 8 ) & 0xFF,
+		(data.z >> 16) & 0xFF,
+		 data.z >> 24) / 255.0;
+
+	return
+		sk_skin_bones[data.x & 0xFFFF] * weight.x +
+		sk_skin_bones[data.x >> 16   ] * weight.y +
+		sk_skin_bones[data.y & 0xFFFF] * weight.z +
+		sk_skin_bones[data.y >> 16   ] * weight.w;
+}
+
+///////////////////////////////////////////
+
+void sk_skin(uint vertex_id, inout float3 pos, inout float3 norm) {
+	float4x4 skin = sk_skin_matrix(vertex_id);
+	pos  = mul(float4(pos,  1), skin).xyz;
+	norm = mul(float4(norm, 0), skin).xyz;
+}
+
+///////////////////////////////////////////
+
+#endif